@@ -35,6 +35,12 @@
 #include "Model/World.h"
 
 #include <vecmath/bbox.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <memory>
+#include <random>
+#include <vector>
 
 namespace TrenchBroom {
     using AABB = AABBTree<double, 3, Model::Node*>;
@@ -61,6 +67,102 @@ namespace TrenchBroom {
         }
     };
 
+    class NodeCollector : public Model::NodeVisitor {
+    private:
+        std::vector<Model::Node*> m_nodes;
+    public:
+        const std::vector<Model::Node*>& nodes() const {
+            return m_nodes;
+        }
+    private:
+        void doVisit(Model::World* world) override {}
+        void doVisit(Model::Layer* layer) override {}
+        void doVisit(Model::Group* group) override {}
+        void doVisit(Model::Entity* entity) override {
+            m_nodes.push_back(entity);
+        }
+        void doVisit(Model::Brush* brush) override {
+            m_nodes.push_back(brush);
+        }
+    };
+
+    static std::unique_ptr<Model::World> loadMap(const IO::Path& path) {
+        const auto mapPath = IO::Disk::getCurrentWorkingDir() + path;
+        const auto file = IO::Disk::openFile(mapPath);
+        auto fileReader = file->reader().buffer();
+
+        IO::TestParserStatus status;
+        IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+
+        const vm::bbox3 worldBounds(8192.0);
+        return worldReader.read(Model::MapFormat::Standard, worldBounds, status);
+    }
+
+    static std::vector<vm::ray3> randomRays(const vm::bbox3& bounds, const size_t count) {
+        std::mt19937 generator(0);
+        std::uniform_real_distribution<double> x(bounds.min.x(), bounds.max.x());
+        std::uniform_real_distribution<double> y(bounds.min.y(), bounds.max.y());
+        std::uniform_real_distribution<double> z(bounds.min.z(), bounds.max.z());
+
+        std::vector<vm::ray3> rays;
+        rays.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const auto origin = vm::vec3(x(generator), y(generator), z(generator));
+            const auto target = vm::vec3(x(generator), y(generator), z(generator));
+            rays.push_back(vm::ray3(origin, vm::normalize(target - origin)));
+        }
+        return rays;
+    }
+
+    static size_t queryTree(const AABB& tree, const std::vector<vm::ray3>& rays) {
+        size_t hits = 0;
+        std::vector<Model::Node*> result;
+        for (const auto& ray : rays) {
+            result.clear();
+            tree.findIntersectors(ray, std::back_inserter(result));
+            hits += result.size();
+        }
+        return hits;
+    }
+
+    TEST(AABBTreeBenchmark, benchBulkBuildTree) {
+        const auto world = loadMap(IO::Path("fixture/benchmark/AABBTree/ne_ruins.map"));
+
+        NodeCollector collector;
+        world->acceptAndRecurse(collector);
+        const auto getBounds = [](const Model::Node* node) { return node->physicalBounds(); };
+
+        std::vector<AABB> insertedTrees(10);
+        timeLambda([&]() {
+            for (auto& tree : insertedTrees) {
+                for (auto* node : collector.nodes()) {
+                    tree.insert(node->physicalBounds(), node);
+                }
+            }
+        }, "Insert objects into 10 AABB trees");
+
+        std::vector<AABB> builtTrees(10);
+        timeLambda([&]() {
+            for (auto& tree : builtTrees) {
+                tree.clearAndBuild(collector.nodes(), getBounds);
+            }
+        }, "Bulk build 10 AABB trees");
+
+        const auto rays = randomRays(insertedTrees.front().bounds(), 100000);
+
+        size_t insertedHits = 0;
+        timeLambda([&]() {
+            insertedHits = queryTree(insertedTrees.front(), rays);
+        }, "Find intersectors of 100000 rays in inserted tree");
+
+        size_t builtHits = 0;
+        timeLambda([&]() {
+            builtHits = queryTree(builtTrees.front(), rays);
+        }, "Find intersectors of 100000 rays in bulk built tree");
+
+        ASSERT_EQ(insertedHits, builtHits);
+    }
+
     TEST(AABBTreeBenchmark, benchBuildTree) {
 
         const auto mapPath = IO::Disk::getCurrentWorkingDir() + IO::Path("fixture/benchmark/AABBTree/ne_ruins.map");
@@ -0,0 +1,142 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "IO/TestParserStatus.h"
+#include "IO/Token.h"
+#include "IO/WorldReader.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        using NumberToken = TokenTemplate<unsigned int>;
+
+        static std::vector<std::string> randomNumbers(const size_t count) {
+            std::mt19937 generator(0);
+            std::uniform_real_distribution<double> coords(-4096.0, 4096.0);
+            std::uniform_int_distribution<int> integers(-4096, 4096);
+
+            std::vector<std::string> numbers;
+            numbers.reserve(count);
+
+            char buffer[64];
+            for (size_t i = 0; i < count; ++i) {
+                switch (i % 3) {
+                    case 0:
+                        std::snprintf(buffer, sizeof(buffer), "%d", integers(generator));
+                        break;
+                    case 1:
+                        std::snprintf(buffer, sizeof(buffer), "%.6g", coords(generator));
+                        break;
+                    default:
+                        std::snprintf(buffer, sizeof(buffer), "%.17g", coords(generator));
+                        break;
+                }
+                numbers.push_back(buffer);
+            }
+            return numbers;
+        }
+
+        static std::string randomMap(const size_t brushCount) {
+            std::mt19937 generator(0);
+            std::uniform_real_distribution<double> coords(-4096.0, 4096.0);
+
+            std::string map = "{\n\"classname\" \"worldspawn\"\n";
+            char buffer[256];
+            for (size_t i = 0; i < brushCount; ++i) {
+                const auto x = coords(generator);
+                const auto y = coords(generator);
+                const auto z = coords(generator);
+
+                map += "{\n";
+                const double faces[6][9] = {
+                    { x,      y, z, x,      y + 1, z, x,      y, z + 1 },
+                    { x + 32, y, z, x + 32, y, z + 1, x + 32, y + 1, z },
+                    { x, y,      z, x, y,      z + 1, x + 1, y,      z },
+                    { x, y + 32, z, x + 1, y + 32, z, x, y + 32, z + 1 },
+                    { x, y, z,      x + 1, y, z,      x, y + 1, z },
+                    { x, y, z + 32, x, y + 1, z + 32, x + 1, y, z + 32 },
+                };
+                for (const auto& f : faces) {
+                    std::snprintf(buffer, sizeof(buffer), "( %.17g %.17g %.17g ) ( %.17g %.17g %.17g ) ( %.17g %.17g %.17g ) tex 0 0 0 1 1\n",
+                                  f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8]);
+                    map += buffer;
+                }
+                map += "}\n";
+            }
+            map += "}\n";
+            return map;
+        }
+
+        TEST(StandardMapParserBenchmark, benchTokenToFloat) {
+            const auto numbers = randomNumbers(1000000);
+
+            std::vector<NumberToken> tokens;
+            tokens.reserve(numbers.size());
+            for (const auto& number : numbers) {
+                tokens.emplace_back(0u, number.data(), number.data() + number.size(), 0u, 1u, 1u);
+            }
+
+            std::vector<double> expected(numbers.size());
+            timeLambda([&]() {
+                for (size_t i = 0; i < numbers.size(); ++i) {
+                    expected[i] = std::atof(numbers[i].c_str());
+                }
+            }, "Convert 1000000 numbers using atof");
+
+            std::vector<double> actual(numbers.size());
+            timeLambda([&]() {
+                for (size_t i = 0; i < tokens.size(); ++i) {
+                    actual[i] = tokens[i].toFloat<double>();
+                }
+            }, "Convert 1000000 number tokens");
+
+            for (size_t i = 0; i < numbers.size(); ++i) {
+                ASSERT_EQ(expected[i], actual[i]) << numbers[i];
+            }
+        }
+
+        TEST(StandardMapParserBenchmark, benchParseMap) {
+            const auto map = randomMap(20000);
+
+            TestParserStatus status;
+            WorldReader reader(map);
+
+            const vm::bbox3 worldBounds(8192.0);
+            std::unique_ptr<Model::World> world;
+            timeLambda([&]() {
+                world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            }, "Parse map with 20000 brushes");
+
+            ASSERT_TRUE(world != nullptr);
+        }
+    }
+}
@@ -0,0 +1,156 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "AABBTree.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Path.h"
+#include "IO/Reader.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/NodeVisitor.h"
+#include "Model/PickResult.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/intersection.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        using BrushTree = AABBTree<double, 3, Brush*>;
+
+        class BrushCollector : public NodeVisitor {
+        private:
+            std::vector<Brush*> m_brushes;
+        public:
+            const std::vector<Brush*>& brushes() const {
+                return m_brushes;
+            }
+        private:
+            void doVisit(World* world) override {}
+            void doVisit(Layer* layer) override {}
+            void doVisit(Group* group) override {}
+            void doVisit(Entity* entity) override {}
+            void doVisit(Brush* brush) override {
+                m_brushes.push_back(brush);
+            }
+        };
+
+        static std::unique_ptr<World> loadMap(const IO::Path& path) {
+            const auto mapPath = IO::Disk::getCurrentWorkingDir() + path;
+            const auto file = IO::Disk::openFile(mapPath);
+            auto fileReader = file->reader().buffer();
+
+            IO::TestParserStatus status;
+            IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
+
+            const vm::bbox3 worldBounds(8192.0);
+            return worldReader.read(MapFormat::Standard, worldBounds, status);
+        }
+
+        static std::vector<vm::ray3> randomRays(const vm::bbox3& bounds, const size_t count) {
+            std::mt19937 generator(0);
+            std::uniform_real_distribution<double> x(bounds.min.x(), bounds.max.x());
+            std::uniform_real_distribution<double> y(bounds.min.y(), bounds.max.y());
+            std::uniform_real_distribution<double> z(bounds.min.z(), bounds.max.z());
+
+            std::vector<vm::ray3> rays;
+            rays.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                const auto origin = vm::vec3(x(generator), y(generator), z(generator));
+                const auto target = vm::vec3(x(generator), y(generator), z(generator));
+                rays.push_back(vm::ray3(origin, vm::normalize(target - origin)));
+            }
+            return rays;
+        }
+
+        /**
+         * Intersects the given ray with the faces of the given brush by walking the boundary of every face, which is
+         * how brushes were picked before they cached their face planes.
+         */
+        static bool pickFacePolygons(const vm::ray3& ray, const Brush* brush) {
+            if (vm::is_nan(vm::intersect_ray_bbox(ray, brush->logicalBounds()))) {
+                return false;
+            }
+
+            for (const auto* face : brush->faces()) {
+                if (!vm::is_nan(face->intersectWithRay(ray))) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        TEST(BrushPickBenchmark, benchPickBrushes) {
+            const auto world = loadMap(IO::Path("fixture/benchmark/AABBTree/ne_ruins.map"));
+
+            BrushCollector collector;
+            world->acceptAndRecurse(collector);
+
+            BrushTree tree;
+            tree.clearAndBuild(collector.brushes(), [](const Brush* brush) { return brush->logicalBounds(); });
+
+            // find the candidates up front so that only the brush intersection tests are timed
+            const auto rays = randomRays(tree.bounds(), 100000);
+            std::vector<std::vector<Brush*>> candidates(rays.size());
+            for (size_t i = 0; i < rays.size(); ++i) {
+                tree.findIntersectors(rays[i], std::back_inserter(candidates[i]));
+            }
+
+            size_t polygonHits = 0;
+            timeLambda([&]() {
+                for (size_t i = 0; i < rays.size(); ++i) {
+                    for (const auto* brush : candidates[i]) {
+                        if (pickFacePolygons(rays[i], brush)) {
+                            ++polygonHits;
+                        }
+                    }
+                }
+            }, "Pick brushes with 100000 rays against face polygons");
+
+            size_t planeHits = 0;
+            timeLambda([&]() {
+                PickResult pickResult;
+                for (size_t i = 0; i < rays.size(); ++i) {
+                    for (const auto* brush : candidates[i]) {
+                        pickResult.clear();
+                        brush->pick(rays[i], pickResult);
+                        planeHits += pickResult.size();
+                    }
+                }
+            }, "Pick brushes with 100000 rays against face planes");
+
+            // rays that graze an edge may be decided differently by the two methods
+            ASSERT_NEAR(static_cast<double>(polygonHits), static_cast<double>(planeHits), 0.001 * static_cast<double>(polygonHits));
+        }
+    }
+}
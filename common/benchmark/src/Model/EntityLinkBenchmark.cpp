@@ -0,0 +1,116 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+
+#include "CollectionUtils.h"
+#include "StringUtils.h"
+#include "Model/AttributableNode.h"
+#include "Model/AttributableNodeIndex.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <vecmath/bbox.h>
+
+#include <iterator>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static const size_t NumEntities = 20000;
+
+        static String targetName(const size_t i) {
+            return "t" + StringUtils::toString(i);
+        }
+
+        /**
+         * Creates a chain of entities where each entity targets its successor. Every fourth entity additionally
+         * targets the entity after its successor using a numbered target attribute.
+         */
+        static NodeList createLinkedEntities(const size_t count) {
+            NodeList entities;
+            entities.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                auto* entity = new Entity();
+                entity->addOrUpdateAttribute(AttributeNames::Classname, i % 2 == 0 ? "trigger_relay" : "func_door");
+                entity->addOrUpdateAttribute(AttributeNames::Targetname, targetName(i));
+                entity->addOrUpdateAttribute(AttributeNames::Target, targetName(i + 1));
+                if (i % 4 == 0) {
+                    entity->addOrUpdateAttribute(AttributeNames::Target + "2", targetName(i + 2));
+                }
+                entities.push_back(entity);
+            }
+            return entities;
+        }
+
+        TEST(EntityLinkBenchmark, benchResolveLinks) {
+            World world(MapFormat::Standard, vm::bbox3(8192.0));
+            auto entities = createLinkedEntities(NumEntities);
+
+            // adding the entities indexes their attributes and resolves their links
+            timeLambda([&]() { world.defaultLayer()->addChildren(entities); }, "Add " + StringUtils::toString(NumEntities) + " linked entities");
+
+            size_t linkTargets = 0;
+            size_t linkSources = 0;
+            for (const auto* node : entities) {
+                const auto* entity = static_cast<const AttributableNode*>(node);
+                linkTargets += entity->linkTargets().size();
+                linkSources += entity->linkSources().size();
+            }
+
+            // the last entity targets nothing, and the numbered target of the second to last entity, if any, is dangling
+            const auto expectedLinks = (NumEntities - 1) + (NumEntities - 3) / 4 + 1;
+            ASSERT_EQ(expectedLinks, linkTargets);
+            ASSERT_EQ(expectedLinks, linkSources);
+
+            // query a separate index with the same entities so that only the lookups are timed
+            AttributableNodeIndex index;
+            for (auto* node : entities) {
+                index.addAttributableNode(static_cast<AttributableNode*>(node));
+            }
+
+            size_t numberedMatches = 0;
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumEntities; ++i) {
+                    const auto query = AttributableNodeIndexQuery::numbered(AttributeNames::Target);
+                    numberedMatches += index.findAttributableNodes(query, targetName(i)).size();
+                }
+            }, "Find sources of " + StringUtils::toString(NumEntities) + " entities by numbered target");
+            ASSERT_EQ(expectedLinks, numberedMatches);
+
+            size_t exactMatches = 0;
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumEntities; ++i) {
+                    const auto query = AttributableNodeIndexQuery::exact(AttributeNames::Targetname);
+                    exactMatches += index.findAttributableNodes(query, targetName(i)).size();
+                }
+            }, "Find " + StringUtils::toString(NumEntities) + " entities by target name");
+            ASSERT_EQ(NumEntities, exactMatches);
+
+            // removing the entities unlinks them and removes their attributes from the index
+            timeLambda([&]() { world.defaultLayer()->removeChildren(std::begin(entities), std::end(entities)); }, "Remove " + StringUtils::toString(NumEntities) + " linked entities");
+            VectorUtils::clearAndDelete(entities);
+        }
+    }
+}
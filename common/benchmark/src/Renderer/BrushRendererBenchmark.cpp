@@ -29,12 +29,19 @@
 #include "Model/World.h"
 #include "Model/MapFormat.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/BrushRendererBrushCache.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
 
 #include <vector>
 #include <chrono>
 #include <string>
 #include <tuple>
 #include <algorithm>
+#include <cmath>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -125,6 +132,72 @@ namespace TrenchBroom {
                            }
                        }, "validate with " + std::to_string(brushesToKeep.size()) + " brushes");
 
+            // Invalidate everything, including the brushes' cached vertices, as after loading a map
+            for (auto* brush : brushesToKeep) {
+                brush->brushRendererBrushCache().invalidateVertexCache();
+            }
+            r.invalidate();
+
+            timeLambda([&](){
+                           if (!r.valid()) {
+                               r.validate();
+                           }
+                       }, "validate " + std::to_string(brushesToKeep.size()) + " brushes with invalid vertex caches");
+
+            VectorUtils::clearAndDelete(brushes);
+            VectorUtils::clearAndDelete(textures);
+        }
+
+        TEST(BrushRendererBenchmark, benchMoveOneBrush) {
+            static constexpr size_t BrushCount = 100'000;
+
+            std::vector<Assets::Texture*> textures;
+            for (size_t i = 0; i < NumTextures; ++i) {
+                textures.push_back(new Assets::Texture("texture " + std::to_string(i), 64, 64));
+            }
+
+            const vm::bbox3 worldBounds(8192.0);
+            Model::World world(Model::MapFormat::Standard, worldBounds);
+            Model::BrushBuilder builder(&world, worldBounds);
+
+            // arrange the brushes in a grid so that they are spread over many chunks
+            const auto gridSize = static_cast<size_t>(std::ceil(std::cbrt(static_cast<double>(BrushCount))));
+            const auto origin = -static_cast<double>(gridSize) * 32.0;
+
+            std::vector<Model::Brush*> brushes;
+            size_t currentTextureIndex = 0;
+            for (size_t i = 0; i < BrushCount; ++i) {
+                const auto x = origin + static_cast<double>(i % gridSize) * 64.0;
+                const auto y = origin + static_cast<double>((i / gridSize) % gridSize) * 64.0;
+                const auto z = origin + static_cast<double>(i / (gridSize * gridSize)) * 64.0;
+                const auto min = vm::vec3(x, y, z);
+
+                Model::Brush* brush = builder.createCuboid(vm::bbox3(min, min + vm::vec3(32.0, 32.0, 32.0)), "");
+                for (auto* face : brush->faces()) {
+                    face->setTexture(textures.at((currentTextureIndex++) % NumTextures));
+                }
+                brushes.push_back(brush);
+            }
+
+            BrushRenderer r;
+            r.addBrushes(brushes);
+            timeLambda([&](){ r.validate(); }, "validate " + std::to_string(brushes.size()) + " brushes");
+
+            auto* brush = brushes[brushes.size() / 2];
+            const auto moveBrush = [&](const vm::vec3& delta, const size_t count) {
+                for (size_t i = 0; i < count; ++i) {
+                    const auto sign = i % 2 == 0 ? 1.0 : -1.0;
+                    brush->transform(vm::translation_matrix(sign * delta), false, worldBounds);
+                    r.invalidateBrushes({ brush });
+                    r.validate();
+                }
+            };
+
+            timeLambda([&](){ moveBrush(vm::vec3(16.0, 0.0, 0.0), 100); },
+                       "move one brush within its chunk 100 times in a " + std::to_string(brushes.size()) + " brush map");
+            timeLambda([&](){ moveBrush(vm::vec3(2048.0, 0.0, 0.0), 100); },
+                       "move one brush to another chunk 100 times in a " + std::to_string(brushes.size()) + " brush map");
+
             VectorUtils::clearAndDelete(brushes);
             VectorUtils::clearAndDelete(textures);
         }
@@ -21,19 +21,31 @@
 #define TRENCHBROOM_AABBTREE_H
 
 #include "Exceptions.h"
+#include "HalfSpaceUtils.h"
+#include "ParallelUtils.h"
+
 #include <vecmath/scalar.h>
 #include <vecmath/bbox.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/intersection.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <list>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 /**
- * An axis aligned bounding box tree that allows for quick ray intersection queries.
+ * An axis aligned bounding box tree that allows for quick ray intersection and culling queries.
  *
  * @tparam T the floating point type
  * @tparam S the number of dimensions for vector types
@@ -51,6 +63,90 @@ private:
     class InnerNode;
     class LeafNode;
 
+    /**
+     * A node of the flattened representation of this tree. The nodes are stored in depth first order, so the left
+     * child of an inner node immediately follows it. Instead of child pointers, every node stores the index of the
+     * first node after its subtree, so that the tree can be traversed without a stack.
+     *
+     * The bounds are stored as floats. They are rounded outwards so that they always contain the original bounds, and
+     * they are enlarged by a padding that is derived from the extent of the tree to absorb the rounding errors of
+     * the float ray test, see FlatRay. Hence they are only used to cull subtrees, and leaves are tested against their
+     * exact bounds.
+     */
+    struct FlatNode {
+        std::array<float, S> min;
+        std::array<float, S> max;
+        // the index of the first node after this node's subtree
+        uint32_t skip;
+        // the index of the leaf in m_flatLeaves, or NoLeaf if this is an inner node
+        uint32_t leaf;
+
+        static constexpr uint32_t NoLeaf = std::numeric_limits<uint32_t>::max();
+    };
+
+    struct FlatLeaf {
+        Box bounds;
+        U data;
+    };
+
+    using FlatNodeList = std::vector<FlatNode>;
+    using FlatLeafList = std::vector<FlatLeaf>;
+
+    /**
+     * The relative error of the float slab test in FlatRay. The parameters computed by the slab test are off by a few
+     * float epsilons relative to the distance between the ray origin and the slab, and the distance between the ray
+     * origin and any slab is at most the sum of the magnitudes of the ray origin and the largest coordinate of the tree.
+     * Enlarging the boxes by this factor times that sum therefore covers the rounding errors generously.
+     */
+    static constexpr float FlatRelativeError = 16.0f * std::numeric_limits<float>::epsilon();
+
+    /**
+     * Returns the padding that covers the rounding errors of the slab test for coordinates of the given magnitude.
+     */
+    static float flatPadding(const float magnitude) {
+        return FlatRelativeError * std::max(1.0f, magnitude);
+    }
+
+    /**
+     * A ray prepared for testing against the bounds of flat nodes.
+     *
+     * The bounds of the flat nodes are padded according to the extent of the tree, and the ray adds a padding
+     * according to the magnitude of its origin. Together, these paddings exceed the rounding errors of the float
+     * slab test, so the test never rejects a node whose exact bounds the ray intersects.
+     */
+    struct FlatRay {
+        std::array<float, S> origin;
+        std::array<float, S> invDirection;
+        float padding;
+
+        explicit FlatRay(const vm::ray<T,S>& ray) {
+            auto magnitude = 0.0f;
+            for (size_t i = 0; i < S; ++i) {
+                origin[i] = static_cast<float>(ray.origin[i]);
+                invDirection[i] = 1.0f / static_cast<float>(ray.direction[i]);
+                magnitude = std::max(magnitude, std::abs(origin[i]));
+            }
+            padding = flatPadding(magnitude);
+        }
+
+        bool intersects(const FlatNode& node) const {
+            // slab test, NaNs resulting from rays that lie in a slab's plane are ignored
+            auto tMin = 0.0f;
+            auto tMax = std::numeric_limits<float>::max();
+            for (size_t i = 0; i < S; ++i) {
+                const auto t1 = (node.min[i] - padding - origin[i]) * invDirection[i];
+                const auto t2 = (node.max[i] + padding - origin[i]) * invDirection[i];
+                tMin = std::max(tMin, std::min(t1, t2));
+                tMax = std::min(tMax, std::max(t1, t2));
+            }
+            return tMin <= tMax;
+        }
+    };
+
+    static bool intersects(const vm::ray<T,S>& ray, const Box& bounds) {
+        return bounds.contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds));
+    }
+
     class Visitor {
     public:
         virtual ~Visitor() = default;
@@ -139,6 +235,45 @@ private:
         virtual void appendTo(std::ostream& str, const std::string& indent, size_t level) const = 0;
 
         virtual void checkParentPointers(const Node* expectedParent) const = 0;
+
+        /**
+         * Appends the flattened representation of the subtree rooted at this node to the given lists.
+         *
+         * @param nodes the list of flat nodes to append to
+         * @param leaves the list of flat leaves to append to
+         * @param padding the amount by which to enlarge the bounds of the flat nodes
+         */
+        virtual void flatten(FlatNodeList& nodes, FlatLeafList& leaves, float padding) const = 0;
+    protected:
+        /**
+         * Appends a flat node with this node's bounds to the given list.
+         *
+         * @param nodes the list to append to
+         * @param leaf the index of the corresponding flat leaf, or FlatNode::NoLeaf
+         * @param padding the amount by which to enlarge the bounds
+         * @return the index of the appended node
+         */
+        size_t appendFlatNode(FlatNodeList& nodes, const uint32_t leaf, const float padding) const {
+            FlatNode node;
+            for (size_t i = 0; i < S; ++i) {
+                node.min[i] = roundDown(m_bounds.min[i]) - padding;
+                node.max[i] = roundUp(m_bounds.max[i]) + padding;
+            }
+            node.skip = static_cast<uint32_t>(nodes.size() + 1u);
+            node.leaf = leaf;
+            nodes.push_back(node);
+            return nodes.size() - 1u;
+        }
+    private:
+        static float roundDown(const T t) {
+            const auto f = static_cast<float>(t);
+            return static_cast<T>(f) > t ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f;
+        }
+
+        static float roundUp(const T t) {
+            const auto f = static_cast<float>(t);
+            return static_cast<T>(f) < t ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f;
+        }
     protected:
         /**
          * Updates the bounds of this node.
@@ -373,6 +508,13 @@ private:
             m_left->checkParentPointers(this);
             m_left->checkParentPointers(this);
         }
+
+        void flatten(FlatNodeList& nodes, FlatLeafList& leaves, const float padding) const override {
+            const auto index = this->appendFlatNode(nodes, FlatNode::NoLeaf, padding);
+            m_left->flatten(nodes, leaves, padding);
+            m_right->flatten(nodes, leaves, padding);
+            nodes[index].skip = static_cast<uint32_t>(nodes.size());
+        }
     };
 
     /**
@@ -450,12 +592,37 @@ private:
         virtual void checkParentPointers(const Node* expectedParent) const override {
             assert(this->m_parent == expectedParent);
         }
+
+        void flatten(FlatNodeList& nodes, FlatLeafList& leaves, const float padding) const override {
+            this->appendFlatNode(nodes, static_cast<uint32_t>(leaves.size()), padding);
+            leaves.push_back(FlatLeaf { this->bounds(), m_data });
+        }
     };
 private:
     Node* m_root;
     std::unordered_map<U, LeafNode*> m_leafForData;
+
+    /**
+     * A read only copy of this tree that is used for queries. Rebuilding it takes time linear in the size of the
+     * tree, so it is only rebuilt once the tree has been queried a number of times without being modified. Until
+     * then, queries traverse the nodes of the tree directly. This keeps frequent modifications such as dragging
+     * objects from paying for a full rebuild on every query.
+     */
+    mutable FlatNodeList m_flatNodes;
+    mutable FlatLeafList m_flatLeaves;
+    mutable std::atomic<bool> m_flatValid;
+    mutable std::atomic<size_t> m_queriesSinceChange;
+    mutable std::mutex m_flatMutex;
+
+    /**
+     * The number of queries after which an unmodified tree rebuilds its flat copy.
+     */
+    static constexpr size_t FlatTreeQueryThreshold = 32;
 public:
-    AABBTree() : m_root(nullptr) {}
+    AABBTree() :
+    m_root(nullptr),
+    m_flatValid(false),
+    m_queriesSinceChange(0) {}
 
     ~AABBTree() {
         clear();
@@ -473,19 +640,205 @@ public:
     }
 
     /**
-     * Clears this tree and rebuilds it by inserting given objects.
+     * Clears this tree and rebuilds it from the given objects. Instead of inserting the objects one by one, the
+     * tree is built top down by recursively partitioning the objects using a binned surface area heuristic, which is
+     * faster and yields a tree that is cheaper to query. Large subtrees are built on the shared worker pool.
      *
      * @param objects the objects to insert, a list of DataType
      * @param getBounds a function from DataType -> Box to compute the bounds of each object
+     *
+     * @throws NodeTreeException if the given objects contain duplicates, or the bounds of an object contains NaN
      */
     template <typename DataList, typename GetBounds>
     void clearAndBuild(const DataList& objects, GetBounds&& getBounds) {
         clear();
-        for (const U& object : objects) {
-            insert(getBounds(object), object);
+
+        std::vector<LeafNode*> leaves;
+        try {
+            for (const U& object : objects) {
+                const Box bounds = getBounds(object);
+                check(bounds, object);
+
+                if (m_leafForData.find(object) != m_leafForData.end()) {
+                    NodeTreeException ex;
+                    ex << "data already in tree: " << object;
+                    throw ex;
+                }
+
+                auto* leaf = new LeafNode(bounds, object);
+                leaves.push_back(leaf);
+                m_leafForData[object] = leaf;
+            }
+        } catch (...) {
+            m_leafForData.clear();
+            for (auto* leaf : leaves) {
+                delete leaf;
+            }
+            throw;
+        }
+
+        if (!leaves.empty()) {
+            m_root = build(std::begin(leaves), std::end(leaves));
+            invalidateFlatTree();
+
+            // a tree that was built in bulk is likely to be queried before it is modified
+            m_queriesSinceChange = FlatTreeQueryThreshold;
+        }
+    }
+private:
+    using LeafIterator = typename std::vector<LeafNode*>::iterator;
+
+    /**
+     * Builds a subtree containing the given leaves. The two subtrees of a large subtree are built using
+     * ParallelUtils::parallelFor, so the recursion spreads over the shared worker pool without starting any threads.
+     *
+     * @param begin the first leaf
+     * @param end the end of the leaf range
+     * @return the root of the subtree
+     */
+    static Node* build(LeafIterator begin, LeafIterator end) {
+        // Below this number of leaves, building a subtree is cheaper than handing it to another thread.
+        static const size_t MinParallelLeafCount = 4096;
+
+        const auto count = std::distance(begin, end);
+        assert(count > 0);
+
+        if (count == 1) {
+            return *begin;
+        }
+
+        const auto mid = partition(begin, end);
+        if (static_cast<size_t>(count) >= MinParallelLeafCount) {
+            Node* children[2] = { nullptr, nullptr };
+            ParallelUtils::parallelFor(2, [&](const size_t i) {
+                children[i] = i == 0 ? build(begin, mid) : build(mid, end);
+            });
+            return new InnerNode(children[0], children[1]);
+        } else {
+            Node* left = build(begin, mid);
+            Node* right = build(mid, end);
+            return new InnerNode(left, right);
+        }
+    }
+
+    /**
+     * Partitions the given leaves into two non-empty ranges using the binned surface area heuristic. The leaves are
+     * binned along each axis by the centers of their bounds, and the split between two bins that minimizes the
+     * summed surface areas of both halves weighted by their leaf counts is chosen. If no such split exists, e.g.
+     * because all leaves have the same center, the leaves are split in half along the longest axis.
+     *
+     * @param begin the first leaf
+     * @param end the end of the leaf range
+     * @return the first leaf of the second range
+     */
+    static LeafIterator partition(LeafIterator begin, LeafIterator end) {
+        static const size_t BinCount = 16;
+
+        Box centerBounds((*begin)->bounds().center(), (*begin)->bounds().center());
+        for (auto it = std::next(begin); it != end; ++it) {
+            centerBounds = vm::merge(centerBounds, (*it)->bounds().center());
+        }
+
+        auto bestCost = std::numeric_limits<T>::max();
+        auto bestAxis = S;
+        auto bestBin = BinCount;
+
+        for (size_t axis = 0; axis < S; ++axis) {
+            const auto min = centerBounds.min[axis];
+            const auto extent = centerBounds.max[axis] - min;
+            if (extent <= T(0)) {
+                continue;
+            }
+
+            std::array<Box, BinCount> binBounds;
+            std::array<size_t, BinCount> binCounts = {};
+            for (auto it = begin; it != end; ++it) {
+                const auto& bounds = (*it)->bounds();
+                const auto bin = binIndex(bounds.center()[axis], min, extent, BinCount);
+                binBounds[bin] = binCounts[bin] == 0 ? bounds : vm::merge(binBounds[bin], bounds);
+                ++binCounts[bin];
+            }
+
+            // sweep from the right to accumulate the costs of all possible right halves
+            std::array<T, BinCount> rightCosts;
+            Box rightBounds;
+            size_t rightCount = 0;
+            for (size_t i = BinCount - 1; i > 0; --i) {
+                if (binCounts[i] > 0) {
+                    rightBounds = rightCount == 0 ? binBounds[i] : vm::merge(rightBounds, binBounds[i]);
+                    rightCount += binCounts[i];
+                }
+                rightCosts[i] = rightCount == 0 ? T(0) : surfaceArea(rightBounds) * static_cast<T>(rightCount);
+            }
+
+            Box leftBounds;
+            size_t leftCount = 0;
+            for (size_t i = 0; i < BinCount - 1; ++i) {
+                if (binCounts[i] > 0) {
+                    leftBounds = leftCount == 0 ? binBounds[i] : vm::merge(leftBounds, binBounds[i]);
+                    leftCount += binCounts[i];
+                }
+
+                const auto remaining = static_cast<size_t>(std::distance(begin, end)) - leftCount;
+                if (leftCount > 0 && remaining > 0) {
+                    const auto cost = surfaceArea(leftBounds) * static_cast<T>(leftCount) + rightCosts[i + 1];
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestBin = i + 1;
+                    }
+                }
+            }
+        }
+
+        if (bestAxis < S) {
+            const auto min = centerBounds.min[bestAxis];
+            const auto extent = centerBounds.max[bestAxis] - min;
+            const auto mid = std::partition(begin, end, [&](const LeafNode* leaf) {
+                return binIndex(leaf->bounds().center()[bestAxis], min, extent, BinCount) < bestBin;
+            });
+            if (mid != begin && mid != end) {
+                return mid;
+            }
         }
+
+        const auto size = centerBounds.size();
+        size_t axis = 0;
+        for (size_t i = 1; i < S; ++i) {
+            if (size[i] > size[axis]) {
+                axis = i;
+            }
+        }
+
+        const auto mid = std::next(begin, std::distance(begin, end) / 2);
+        std::nth_element(begin, mid, end, [&](const LeafNode* lhs, const LeafNode* rhs) {
+            return lhs->bounds().center()[axis] < rhs->bounds().center()[axis];
+        });
+        return mid;
+    }
+
+    static size_t binIndex(const T value, const T min, const T extent, const size_t binCount) {
+        const auto index = static_cast<size_t>(static_cast<T>(binCount) * (value - min) / extent);
+        return std::min(index, binCount - 1);
     }
 
+    /**
+     * Returns the surface area of the given box in three dimensions, and the sum of its extents otherwise. Only the
+     * ratio of these values matters for the heuristic.
+     */
+    static T surfaceArea(const Box& box) {
+        const auto size = box.size();
+        T result = T(0);
+        if constexpr (S == 3) {
+            result = size[0] * size[1] + size[1] * size[2] + size[2] * size[0];
+        } else {
+            for (size_t i = 0; i < S; ++i) {
+                result += size[i];
+            }
+        }
+        return result;
+    }
+public:
     /**
      * Insert a node with the given bounds and data into this tree.
      *
@@ -504,6 +857,8 @@ public:
             throw ex;
         }
 
+        invalidateFlatTree();
+
         if (empty()) {
             auto* insertedLeafNode = new LeafNode(bounds, data);
 
@@ -532,6 +887,7 @@ public:
         LeafNode* leaf = it->second;
         assert(leaf->data() == data);
         m_leafForData.erase(it);
+        invalidateFlatTree();
 
         m_root = leaf->deleteThis();
 
@@ -564,6 +920,101 @@ private:
             throw ex;
         }
     }
+
+    void invalidateFlatTree() {
+        m_flatValid = false;
+        m_queriesSinceChange = 0;
+    }
+
+    /**
+     * Indicates whether queries should use the flattened representation of this tree. If the tree has been queried
+     * often enough since it was last modified, the flattened representation is rebuilt. This function may be called
+     * concurrently from multiple threads.
+     */
+    bool useFlatTree() const {
+        if (m_flatValid) {
+            return true;
+        }
+        if (m_queriesSinceChange.fetch_add(1) < FlatTreeQueryThreshold) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(m_flatMutex);
+        if (!m_flatValid) {
+            m_flatNodes.clear();
+            m_flatLeaves.clear();
+            if (!empty()) {
+                m_flatNodes.reserve(2u * m_leafForData.size() - 1u);
+                m_flatLeaves.reserve(m_leafForData.size());
+
+                const auto& bounds = m_root->bounds();
+                auto magnitude = 0.0f;
+                for (size_t i = 0; i < S; ++i) {
+                    magnitude = std::max(magnitude, std::abs(static_cast<float>(bounds.min[i])));
+                    magnitude = std::max(magnitude, std::abs(static_cast<float>(bounds.max[i])));
+                }
+                m_root->flatten(m_flatNodes, m_flatLeaves, flatPadding(magnitude));
+            }
+            m_flatValid = true;
+        }
+        return true;
+    }
+
+    /**
+     * Visits every leaf whose node and the nodes of all of its ancestors satisfy the given predicates. The nodes of
+     * the flattened representation are tested using the first predicate, and the nodes of the tree itself are tested
+     * against their exact bounds using the second predicate. The leaves are visited in the same order in both cases,
+     * and the given visitor is responsible for testing each leaf against its exact bounds.
+     *
+     * @param testFlatNode a function from FlatNode -> bool
+     * @param testBounds a function from Box -> bool
+     * @param visitLeaf a function that accepts a FlatLeaf
+     */
+    template <typename TestFlatNode, typename TestBounds, typename VisitLeaf>
+    void traverse(TestFlatNode&& testFlatNode, TestBounds&& testBounds, VisitLeaf&& visitLeaf) const {
+        if (empty()) {
+            return;
+        }
+
+        if (!useFlatTree()) {
+            traverseTree(testBounds, visitLeaf);
+            return;
+        }
+
+        const auto count = m_flatNodes.size();
+        size_t index = 0;
+        while (index < count) {
+            const auto& node = m_flatNodes[index];
+            if (testFlatNode(node)) {
+                if (node.leaf != FlatNode::NoLeaf) {
+                    visitLeaf(m_flatLeaves[node.leaf]);
+                }
+                ++index;
+            } else {
+                index = node.skip;
+            }
+        }
+    }
+
+    /**
+     * Visits every leaf of the tree itself whose ancestors satisfy the given predicate, depth first and left to
+     * right.
+     *
+     * @param testBounds a function from Box -> bool
+     * @param visitLeaf a function that accepts a FlatLeaf
+     */
+    template <typename TestBounds, typename VisitLeaf>
+    void traverseTree(TestBounds&& testBounds, VisitLeaf&& visitLeaf) const {
+        LambdaVisitor visitor(
+            [&](const InnerNode* innerNode) {
+                return testBounds(innerNode->bounds());
+            },
+            [&](const LeafNode* leaf) {
+                visitLeaf(FlatLeaf { leaf->bounds(), leaf->data() });
+            }
+        );
+        m_root->accept(visitor);
+    }
 public:
     /**
      * Clears this node tree.
@@ -573,6 +1024,8 @@ public:
             delete m_root;
             m_root = nullptr;
         }
+        m_leafForData.clear();
+        invalidateFlatTree();
     }
 
     /**
@@ -631,21 +1084,185 @@ public:
      */
     template <typename O>
     void findIntersectors(const vm::ray<T,S>& ray, O out) const {
-        if (!empty()) {
-            LambdaVisitor visitor(
-                    [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(ray.origin) || !vm::is_nan(
-                            vm::intersect_ray_bbox(ray, innerNode->bounds()));
+        const auto flatRay = FlatRay(ray);
+        traverse(
+            [&](const FlatNode& node) {
+                return flatRay.intersects(node);
+            },
+            [&](const Box& bounds) {
+                return intersects(ray, bounds);
+            },
+            [&](const FlatLeaf& leaf) {
+                if (intersects(ray, leaf.bounds)) {
+                    out = leaf.data;
+                    ++out;
+                }
+            }
+        );
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with any of the given rays and passes it to the
+     * given function together with the index of the ray. The tree is traversed only once for all rays, and a subtree
+     * is only tested against the rays that intersect its root, so this is much faster than finding the intersectors
+     * of every ray separately if the rays are coherent, e.g. if they originate from the same camera.
+     *
+     * For each ray, the data items are visited in the same order as by findIntersectors.
+     *
+     * @tparam F the type of the function, must be callable with a size_t and a DataType argument
+     * @param rays the rays to test
+     * @param visit the function to call for every ray index and intersecting data item
+     */
+    template <typename F>
+    void findIntersectors(const std::vector<vm::ray<T,S>>& rays, F&& visit) const {
+        if (empty() || rays.empty()) {
+            return;
+        }
+
+        if (!useFlatTree()) {
+            for (size_t rayIndex = 0; rayIndex < rays.size(); ++rayIndex) {
+                const auto& ray = rays[rayIndex];
+                traverseTree(
+                    [&](const Box& bounds) {
+                        return intersects(ray, bounds);
                     },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, leaf->bounds()))) {
-                            out = leaf->data();
-                            ++out;
+                    [&](const FlatLeaf& leaf) {
+                        if (intersects(ray, leaf.bounds)) {
+                            visit(rayIndex, leaf.data);
                         }
                     }
-            );
-            m_root->accept(visitor);
+                );
+            }
+            return;
+        }
+
+        const auto& nodes = m_flatNodes;
+        const auto count = nodes.size();
+
+        std::vector<FlatRay> flatRays;
+        flatRays.reserve(rays.size());
+        for (const auto& ray : rays) {
+            flatRays.emplace_back(ray);
+        }
+
+        // The indices of the rays that intersect the current node's parent are stored at the end of activeRays,
+        // following the ray indices of each of its ancestors. Each entry in the stack stores the end of a subtree and
+        // the beginning of the ray indices of its root.
+        std::vector<size_t> activeRays;
+        activeRays.reserve(4u * rays.size());
+        for (size_t i = 0; i < rays.size(); ++i) {
+            activeRays.push_back(i);
+        }
+
+        struct Subtree {
+            size_t end;
+            size_t firstRay;
+        };
+        std::vector<Subtree> stack;
+        stack.push_back(Subtree{ count, 0u });
+
+        size_t index = 0;
+        while (index < count) {
+            const auto& node = nodes[index];
+
+            // collect the rays of the parent node that intersect this node
+            const auto parentBegin = stack.back().firstRay;
+            const auto begin = activeRays.size();
+            for (size_t i = parentBegin; i < begin; ++i) {
+                const auto rayIndex = activeRays[i];
+                if (flatRays[rayIndex].intersects(node)) {
+                    activeRays.push_back(rayIndex);
+                }
+            }
+
+            if (activeRays.size() == begin) {
+                index = node.skip;
+            } else if (node.leaf != FlatNode::NoLeaf) {
+                const auto& leaf = m_flatLeaves[node.leaf];
+                for (size_t i = begin; i < activeRays.size(); ++i) {
+                    const auto rayIndex = activeRays[i];
+                    if (intersects(rays[rayIndex], leaf.bounds)) {
+                        visit(rayIndex, leaf.data);
+                    }
+                }
+                activeRays.resize(begin);
+                index = node.skip;
+            } else {
+                stack.push_back(Subtree{ node.skip, begin });
+                ++index;
+            }
+
+            // discard the rays of the subtrees that end here
+            while (stack.size() > 1u && index >= stack.back().end) {
+                activeRays.resize(stack.back().firstRay);
+                stack.pop_back();
+            }
+        }
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the given box and appends it to the given
+     * output iterator. Boxes that only touch each other are considered to intersect.
+     *
+     * @tparam O the output iterator type
+     * @param box the box to test
+     * @param out the output iterator to append to
+     */
+    template <typename O>
+    void findIntersectors(const Box& box, O out) const {
+        std::array<float, S> flatMin;
+        std::array<float, S> flatMax;
+        for (size_t i = 0; i < S; ++i) {
+            flatMin[i] = static_cast<float>(box.min[i]);
+            flatMax[i] = static_cast<float>(box.max[i]);
         }
+
+        traverse(
+            [&](const FlatNode& node) {
+                for (size_t i = 0; i < S; ++i) {
+                    if (flatMax[i] < node.min[i] || flatMin[i] > node.max[i]) {
+                        return false;
+                    }
+                }
+                return true;
+            },
+            [&](const Box& bounds) {
+                return bounds.intersects(box);
+            },
+            [&](const FlatLeaf& leaf) {
+                if (leaf.bounds.intersects(box)) {
+                    out = leaf.data;
+                    ++out;
+                }
+            }
+        );
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box is not entirely in front of any of the given planes and
+     * appends it to the given output iterator. If the planes bound a convex volume with their normals pointing outward,
+     * such as the side planes of a view frustum, then this finds every data item that might intersect that volume.
+     *
+     * @tparam O the output iterator type
+     * @param planes the planes bounding the volume
+     * @param out the output iterator to append to
+     */
+    template <typename O>
+    void findIntersectorsOfConvexVolume(const std::vector<vm::plane<T,S>>& planes, O out) const {
+        traverse(
+            [&](const FlatNode& node) {
+                return !HalfSpaceUtils::boxOutside(planes, node.min, node.max);
+            },
+            [&](const Box& bounds) {
+                return !HalfSpaceUtils::boxOutside(planes, bounds.min, bounds.max);
+            },
+            [&](const FlatLeaf& leaf) {
+                if (!HalfSpaceUtils::boxOutside(planes, leaf.bounds.min, leaf.bounds.max)) {
+                    out = leaf.data;
+                    ++out;
+                }
+            }
+        );
     }
 
     /**
@@ -670,20 +1287,30 @@ public:
      */
     template <typename O>
     void findContainers(const vm::vec<T,S>& point, O out) const {
-        if (!empty()) {
-            LambdaVisitor visitor(
-                    [&](const InnerNode* innerNode) {
-                        return innerNode->bounds().contains(point);
-                    },
-                    [&](const LeafNode* leaf) {
-                        if (leaf->bounds().contains(point)) {
-                            out = leaf->data();
-                            ++out;
-                        }
-                    }
-            );
-            m_root->accept(visitor);
+        std::array<float, S> flatPoint;
+        for (size_t i = 0; i < S; ++i) {
+            flatPoint[i] = static_cast<float>(point[i]);
         }
+
+        traverse(
+            [&](const FlatNode& node) {
+                for (size_t i = 0; i < S; ++i) {
+                    if (flatPoint[i] < node.min[i] || flatPoint[i] > node.max[i]) {
+                        return false;
+                    }
+                }
+                return true;
+            },
+            [&](const Box& bounds) {
+                return bounds.contains(point);
+            },
+            [&](const FlatLeaf& leaf) {
+                if (leaf.bounds.contains(point)) {
+                    out = leaf.data;
+                    ++out;
+                }
+            }
+        );
     }
 
     /**
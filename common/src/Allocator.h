@@ -21,6 +21,7 @@
 #define TrenchBroom_Allocator_h
 
 #include <cassert>
+#include <mutex>
 #include <stack>
 #include <vector>
 
@@ -88,13 +89,54 @@ private:
     };
 
     using ChunkList = std::vector<Chunk*>;
-    using Pool = std::stack<T*>;
+
+    /**
+     * Caches up to PoolSize freed blocks for the current thread so that most allocations don't need to
+     * lock the shared chunk lists. Blocks are not owned by the thread that allocated them: a block may
+     * be freed on any thread, and whatever is left in the cache is returned to the chunks when the
+     * thread exits.
+     */
+    class Pool {
+    private:
+        std::stack<T*> m_blocks;
+    public:
+        ~Pool() {
+            std::lock_guard<std::mutex> lock(mutex());
+            while (!m_blocks.empty()) {
+                deallocateBlock(m_blocks.top());
+                m_blocks.pop();
+            }
+        }
+
+        bool empty() const {
+            return m_blocks.empty();
+        }
+
+        size_t size() const {
+            return m_blocks.size();
+        }
+
+        T* pop() {
+            T* t = m_blocks.top();
+            m_blocks.pop();
+            return t;
+        }
+
+        void push(T* t) {
+            m_blocks.push(t);
+        }
+    };
 
     static Pool& pool() {
-        static Pool p;
+        thread_local Pool p;
         return p;
     }
 
+    static std::mutex& mutex() {
+        static std::mutex m;
+        return m;
+    }
+
     static ChunkList& fullChunks() {
         static ChunkList chunks;
         return chunks;
@@ -105,21 +147,15 @@ private:
         return chunks;
     }
 
-    static ChunkList emptyChunks() {
+    static ChunkList& emptyChunks() {
         static ChunkList chunks;
         return chunks;
     }
-public:
-#ifdef TB_ENABLE_ALLOCATOR
-    void* operator new(size_t size) {
-        assert(size == sizeof(T));
-
-        if (!pool().empty()) {
-            T* t = pool().top();
-            pool().pop();
-            return t;
-        }
 
+    /**
+     * Allocates a block from the shared chunks. The caller must hold the mutex.
+     */
+    static T* allocateBlock() {
         Chunk* chunk = nullptr;
         if (mixedChunks().empty()) {
             if (!emptyChunks().empty()) {
@@ -144,14 +180,10 @@ public:
         return block;
     }
 
-    void operator delete(void* block) {
-        T* t = reinterpret_cast<T*>(block);
-
-        if (PoolSize > 0 && pool().size() < PoolSize) {
-            pool().push(t);
-            return;
-        }
-
+    /**
+     * Returns a block to the chunk that contains it. The caller must hold the mutex.
+     */
+    static void deallocateBlock(T* t) {
         typename ChunkList::reverse_iterator fullIt, fullEnd, mixedIt, mixedEnd;
         fullIt = fullChunks().rbegin();
         fullEnd = fullChunks().rend();
@@ -159,11 +191,13 @@ public:
         mixedEnd = mixedChunks().rend();
 
         Chunk* chunk = nullptr;
+        bool inFullChunk = false;
         while (fullIt < fullEnd || mixedIt < mixedEnd) {
             if (fullIt < fullEnd) {
                 Chunk* fullChunk = *fullIt;
                 if (fullChunk->contains(t)) {
                     chunk = fullChunk;
+                    inFullChunk = true;
                     break;
                 }
                 ++fullIt;
@@ -180,21 +214,49 @@ public:
 
         assert(chunk != nullptr);
 
-        if (chunk->full()) {
+        if (inFullChunk) {
             fullChunks().erase((fullIt + 1).base());
             mixedChunks().push_back(chunk);
+            mixedIt = mixedChunks().rbegin();
         }
 
         chunk->deallocate(t);
 
         if (chunk->empty()) {
             mixedChunks().erase((mixedIt + 1).base());
-            if (emptyChunks().size() < 2)
+            if (emptyChunks().size() < 2) {
                 emptyChunks().push_back(chunk);
-                else
-                    delete chunk;
+            } else {
+                delete chunk;
+            }
         }
     }
+public:
+#ifdef TB_ENABLE_ALLOCATOR
+    void* operator new(size_t size) {
+        assert(size == sizeof(T));
+
+        Pool& p = pool();
+        if (!p.empty()) {
+            return p.pop();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex());
+        return allocateBlock();
+    }
+
+    void operator delete(void* block) {
+        T* t = reinterpret_cast<T*>(block);
+
+        Pool& p = pool();
+        if (PoolSize > 0 && p.size() < PoolSize) {
+            p.push(t);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex());
+        deallocateBlock(t);
+    }
 #endif
 };
 
@@ -54,7 +54,7 @@ namespace TrenchBroom {
 
         EntityDefinition* EntityDefinitionManager::definition(const Model::AttributableNode* attributable) const {
             ensure(attributable != nullptr, "attributable is null");
-            return definition(attributable->attribute(Model::AttributeNames::Classname));
+            return definition(attributable->attribute(Model::AttributeNames::ClassnameKey));
         }
 
         EntityDefinition* EntityDefinitionManager::definition(const Model::AttributeValue& classname) const {
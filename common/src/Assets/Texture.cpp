@@ -18,15 +18,61 @@
  */
 
 #include "Texture.h"
+#include "ParallelUtils.h"
 #include "Assets/ImageUtils.h"
 #include "Assets/TextureCollection.h"
 #include "Renderer/GL.h"
 
 #include <cassert>
 #include <algorithm>
+#include <atomic>
 
 namespace TrenchBroom {
     namespace Assets {
+        static size_t nextActivation() {
+            static size_t activation = 0;
+            return ++activation;
+        }
+
+        static std::atomic<size_t> pendingDecodes(0);
+        static std::atomic<size_t> finishedDecodes(0);
+
+        /**
+         * The buffers of a texture that are decoded on a worker thread. The worker only touches this state, so the
+         * texture may be destroyed while it is being decoded.
+         */
+        struct Texture::PendingBuffers {
+            std::atomic<bool> ready;
+            TextureBuffer::List buffers;
+            Color averageColor;
+
+            PendingBuffers() :
+            ready(false) {}
+        };
+
+        static Color computeAverageColor(const TextureBuffer& buffer, const size_t pixelCount, const GLenum format) {
+            const auto bytesPerPixel = bytesPerPixelForFormat(format);
+            const auto* data = buffer.ptr();
+
+            double avg[3];
+            avg[0] = avg[1] = avg[2] = 0.0;
+            for (size_t i = 0; i < pixelCount; ++i) {
+                for (size_t j = 0; j < 3; ++j) {
+                    avg[j] += static_cast<double>(data[i * bytesPerPixel + j]);
+                }
+            }
+
+            Color result;
+            for (size_t i = 0; i < 3; ++i) {
+                result[i] = static_cast<float>(avg[i] / static_cast<double>(pixelCount) / 0xFF);
+            }
+            if (format == GL_BGR || format == GL_BGRA) {
+                std::swap(result[0], result[2]);
+            }
+            result[3] = 1.0f;
+            return result;
+        }
+
         vm::vec2s sizeAtMipLevel(const size_t width, const size_t height, const size_t level) {
             assert(width > 0);
             assert(height > 0);
@@ -66,13 +112,18 @@ namespace TrenchBroom {
         m_width(width),
         m_height(height),
         m_averageColor(averageColor),
+        m_averageColorKnown(true),
         m_usageCount(0),
         m_overridden(false),
         m_format(format),
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {
+        m_textureId(0),
+        m_uploaded(false),
+        m_lastActivation(0),
+        m_minFilter(GL_NEAREST),
+        m_magFilter(GL_NEAREST) {
             assert(m_width > 0);
             assert(m_height > 0);
             assert(buffer.size() >= m_width * m_height * bytesPerPixelForFormat(format));
@@ -85,6 +136,7 @@ namespace TrenchBroom {
         m_width(width),
         m_height(height),
         m_averageColor(averageColor),
+        m_averageColorKnown(true),
         m_usageCount(0),
         m_overridden(false),
         m_format(format),
@@ -92,7 +144,11 @@ namespace TrenchBroom {
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
         m_textureId(0),
-        m_buffers(buffers) {
+        m_buffers(buffers),
+        m_uploaded(false),
+        m_lastActivation(0),
+        m_minFilter(GL_NEAREST),
+        m_magFilter(GL_NEAREST) {
             assert(m_width > 0);
             assert(m_height > 0);
 
@@ -111,13 +167,18 @@ namespace TrenchBroom {
         m_width(width),
         m_height(height),
         m_averageColor(Color(0.0f, 0.0f, 0.0f, 1.0f)),
+        m_averageColorKnown(false),
         m_usageCount(0),
         m_overridden(false),
         m_format(format),
         m_type(type),
         m_culling(TextureCulling::CullDefault),
         m_blendFunc{false, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA},
-        m_textureId(0) {}
+        m_textureId(0),
+        m_uploaded(false),
+        m_lastActivation(0),
+        m_minFilter(GL_NEAREST),
+        m_magFilter(GL_NEAREST) {}
 
         Texture::~Texture() {
             if (m_collection == nullptr && m_textureId != 0) {
@@ -151,7 +212,8 @@ namespace TrenchBroom {
         }
 
         const Color& Texture::averageColor() const {
-            return m_averageColor;
+            static const Color neutralColor(0.5f, 0.5f, 0.5f, 1.0f);
+            return m_averageColorKnown ? m_averageColor : neutralColor;
         }
 
         const StringSet& Texture::surfaceParms() const {
@@ -207,6 +269,25 @@ namespace TrenchBroom {
             m_overridden = overridden;
         }
 
+        void Texture::setBufferSource(TextureBufferSource bufferSource) {
+            m_bufferSource = std::move(bufferSource);
+            if (m_bufferSource) {
+                m_buffers.clear();
+            }
+        }
+
+        bool Texture::hasBufferSource() const {
+            return static_cast<bool>(m_bufferSource);
+        }
+
+        size_t Texture::pendingDecodeCount() {
+            return pendingDecodes;
+        }
+
+        size_t Texture::finishedDecodeCount() {
+            return finishedDecodes;
+        }
+
         bool Texture::isPrepared() const {
             return m_textureId != 0;
         }
@@ -215,52 +296,23 @@ namespace TrenchBroom {
             assert(textureId > 0);
             assert(m_textureId == 0);
 
-            if (!m_buffers.empty()) {
-                glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
-                glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
-                glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
-                glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
-
-                glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
-                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
-
-                if (m_type == TextureType::Masked) {
-                    // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-                } else if (m_buffers.size() == 1) {
-                    // generate mipmaps if we don't have any
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
-                } else {
-                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
-                }
-
-                // Upload only the first mipmap for masked textures.
-                const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
-
-                for (size_t j = 0; j < mipmapsToUpload; ++j) {
-                    const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
-
-                    const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].ptr());
-                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
-                                          static_cast<GLsizei>(mipSize.x()),
-                                          static_cast<GLsizei>(mipSize.y()),
-                                          0, m_format, GL_UNSIGNED_BYTE, data));
-                }
+            m_minFilter = minFilter;
+            m_magFilter = magFilter;
 
-                m_buffers.clear();
+            if (!m_buffers.empty()) {
+                m_textureId = textureId;
+                upload();
+            } else if (m_bufferSource) {
+                // the texture is uploaded when it is activated for the first time
                 m_textureId = textureId;
             }
         }
 
         void Texture::setMode(const int minFilter, const int magFilter) {
-            if (isPrepared()) {
+            m_minFilter = minFilter;
+            m_magFilter = magFilter;
+
+            if (isPrepared() && isUploaded()) {
                 activate();
                 if (m_type == TextureType::Masked) {
                     // Force GL_NEAREST filtering for masked textures.
@@ -274,8 +326,49 @@ namespace TrenchBroom {
             }
         }
 
+        bool Texture::isUploaded() const {
+            return m_uploaded;
+        }
+
+        size_t Texture::videoMemorySize() const {
+            if (!m_uploaded) {
+                return 0;
+            }
+
+            // mip levels add another third to the size of the image
+            const auto imageSize = m_width * m_height * 4;
+            return m_type == TextureType::Masked ? imageSize : imageSize + imageSize / 3;
+        }
+
+        size_t Texture::lastActivation() const {
+            return m_lastActivation;
+        }
+
+        bool Texture::evict() {
+            if (!m_bufferSource || !m_uploaded) {
+                return false;
+            }
+
+            // deleting the texture is the only reliable way to release its memory, so it gets a fresh name
+            GLuint textureId = 0;
+            glAssert(glDeleteTextures(1, &m_textureId));
+            glAssert(glGenTextures(1, &textureId));
+            if (m_collection != nullptr) {
+                m_collection->replaceTextureId(m_textureId, textureId);
+            }
+
+            m_textureId = textureId;
+            m_uploaded = false;
+            return true;
+        }
+
         void Texture::activate() const {
             if (isPrepared()) {
+                if (!m_uploaded) {
+                    upload();
+                }
+                m_lastActivation = nextActivation();
+
                 glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
 
                 switch (m_culling) {
@@ -325,6 +418,123 @@ namespace TrenchBroom {
             }
         }
 
+        void Texture::upload() const {
+            if (m_buffers.empty() && m_bufferSource) {
+                const auto decodeRequested = m_pendingBuffers != nullptr;
+                if (!takeDecodedBuffers()) {
+                    // show the placeholder until the buffers have been decoded
+                    if (!decodeRequested) {
+                        uploadPlaceholder();
+                    }
+                    return;
+                }
+            }
+
+            if (!m_buffers.empty()) {
+                glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
+                glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
+                glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+                glAssert(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+                glAssert(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+                glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+                glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_minFilter));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_magFilter));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
+
+                if (m_type == TextureType::Masked) {
+                    // masked textures don't work well with automatic mipmaps, so we force GL_NEAREST filtering and don't generate any
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_FALSE));
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+                } else if (m_buffers.size() == 1) {
+                    // generate mipmaps if we don't have any
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE));
+                } else {
+                    glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
+                }
+
+                // Upload only the first mipmap for masked textures.
+                const auto mipmapsToUpload = (m_type == TextureType::Masked) ? 1u : m_buffers.size();
+
+                for (size_t j = 0; j < mipmapsToUpload; ++j) {
+                    const auto mipSize = sizeAtMipLevel(m_width, m_height, j);
+
+                    const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].ptr());
+                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
+                                          static_cast<GLsizei>(mipSize.x()),
+                                          static_cast<GLsizei>(mipSize.y()),
+                                          0, m_format, GL_UNSIGNED_BYTE, data));
+                }
+
+                m_buffers.clear();
+            }
+
+            // also set if the buffers could not be decoded, so that decoding isn't attempted on every activation
+            m_uploaded = true;
+        }
+
+        bool Texture::takeDecodedBuffers() const {
+            if (m_pendingBuffers == nullptr) {
+                auto pending = std::make_shared<PendingBuffers>();
+                auto decode = [pending, bufferSource = m_bufferSource, pixelCount = m_width * m_height, format = m_format, computeAverage = !m_averageColorKnown]() {
+                    try {
+                        pending->buffers = bufferSource();
+                        if (computeAverage && !pending->buffers.empty()) {
+                            pending->averageColor = computeAverageColor(pending->buffers.front(), pixelCount, format);
+                        }
+                    } catch (...) {
+                        // the texture is shown with its placeholder
+                    }
+                    pending->ready = true;
+                };
+
+                auto& pool = ParallelUtils::workerPool();
+                if (pool.threadCount() == 0) {
+                    decode();
+                } else {
+                    ++pendingDecodes;
+                    pool.submit([decode = std::move(decode)]() {
+                        decode();
+                        --pendingDecodes;
+                        ++finishedDecodes;
+                    });
+                }
+                m_pendingBuffers = std::move(pending);
+            }
+
+            if (!m_pendingBuffers->ready) {
+                return false;
+            }
+
+            m_buffers = std::move(m_pendingBuffers->buffers);
+            if (!m_averageColorKnown && !m_buffers.empty()) {
+                m_averageColor = m_pendingBuffers->averageColor;
+                m_averageColorKnown = true;
+            }
+            m_pendingBuffers = nullptr;
+            return true;
+        }
+
+        void Texture::uploadPlaceholder() const {
+            const auto& color = averageColor();
+            const GLubyte texel[] = {
+                static_cast<GLubyte>(color.r() * 255.0f),
+                static_cast<GLubyte>(color.g() * 255.0f),
+                static_cast<GLubyte>(color.b() * 255.0f),
+                255
+            };
+
+            // the filters don't use mipmaps, so that the single level is complete
+            glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+            glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+            glAssert(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texel));
+        }
+
         const TextureBuffer::List& Texture::buffersIfUnprepared() const {
             return m_buffers;
         }
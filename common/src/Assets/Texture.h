@@ -28,6 +28,8 @@
 
 #include <vecmath/forward.h>
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
@@ -36,6 +38,12 @@ namespace TrenchBroom {
 
         using TextureBuffer = Buffer<unsigned char>;
 
+        /**
+         * Decodes the buffers of a texture again. Returns an empty list if the texture cannot be decoded. This is
+         * called on a worker thread.
+         */
+        using TextureBufferSource = std::function<TextureBuffer::List()>;
+
         enum class TextureType {
             Opaque,
             /**
@@ -69,7 +77,8 @@ namespace TrenchBroom {
 
             size_t m_width;
             size_t m_height;
-            Color m_averageColor;
+            mutable Color m_averageColor;
+            mutable bool m_averageColorKnown;
 
             size_t m_usageCount;
             bool m_overridden;
@@ -88,6 +97,14 @@ namespace TrenchBroom {
 
             mutable GLuint m_textureId;
             mutable TextureBuffer::List m_buffers;
+
+            struct PendingBuffers;
+            TextureBufferSource m_bufferSource;
+            mutable std::shared_ptr<PendingBuffers> m_pendingBuffers;
+            mutable bool m_uploaded;
+            mutable size_t m_lastActivation;
+            int m_minFilter;
+            int m_magFilter;
         public:
             Texture(const String& name, size_t width, size_t height, const Color& averageColor, const TextureBuffer& buffer, GLenum format, TextureType type);
             Texture(const String& name, size_t width, size_t height, const Color& averageColor, const TextureBuffer::List& buffers, GLenum format, TextureType type);
@@ -102,6 +119,10 @@ namespace TrenchBroom {
 
             size_t width() const;
             size_t height() const;
+            /**
+             * Returns the average color of this texture. If the texture was read without its image data, the average
+             * color is only known once its buffers have been decoded, and a neutral color is returned until then.
+             */
             const Color& averageColor() const;
 
             const StringSet& surfaceParms() const;
@@ -119,16 +140,62 @@ namespace TrenchBroom {
             bool overridden() const;
             void setOverridden(bool overridden);
 
+            /**
+             * Sets the source from which the buffers of this texture can be decoded again. The buffers are released
+             * immediately, and they are decoded on a worker thread once this texture is activated for the first time.
+             * Until they are available, the texture shows its average color. Such a texture can be evicted from video
+             * memory when it is not in use.
+             */
+            void setBufferSource(TextureBufferSource bufferSource);
+            bool hasBufferSource() const;
+
+            /**
+             * Returns the number of textures that are currently being decoded on worker threads.
+             */
+            static size_t pendingDecodeCount();
+
+            /**
+             * Returns the number of decodes that have finished so far. A view that renders textures must be rendered
+             * again if a decode has finished while it was rendering or if decodes are still pending, so that the
+             * decoded textures replace their placeholders.
+             */
+            static size_t finishedDecodeCount();
+
             bool isPrepared() const;
             void prepare(GLuint textureId, int minFilter, int magFilter);
             void setMode(int minFilter, int magFilter);
 
+            /**
+             * Indicates whether the image data of this texture is currently held in video memory. This is not the case
+             * while a placeholder is shown for it.
+             */
+            bool isUploaded() const;
+
+            /**
+             * Returns the number of bytes of video memory occupied by this texture if it is uploaded.
+             */
+            size_t videoMemorySize() const;
+
+            /**
+             * Returns a stamp that is increased whenever any texture is activated, so that the least recently used
+             * textures have the smallest stamps.
+             */
+            size_t lastActivation() const;
+
+            /**
+             * Releases the video memory of this texture if its buffers can be decoded again. The texture is
+             * uploaded again when it is activated the next time.
+             *
+             * @return true if the texture was evicted and false otherwise
+             */
+            bool evict();
+
             void activate() const;
             void deactivate() const;
         public: // exposed for tests only
             /**
              * Returns the texture data in the format returned by format().
-             * Once prepare() is called, this will be an empty vector.
+             * Once prepare() or setBufferSource() is called, this will be an empty vector.
              */
             const TextureBuffer::List& buffersIfUnprepared() const;
             /**
@@ -138,6 +205,9 @@ namespace TrenchBroom {
             TextureType type() const;
 
         private:
+            void upload() const;
+            bool takeDecodedBuffers() const;
+            void uploadPlaceholder() const;
             void setCollection(TextureCollection* collection);
             friend class TextureCollection;
         };
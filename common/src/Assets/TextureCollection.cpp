@@ -22,6 +22,8 @@
 #include "CollectionUtils.h"
 #include "Assets/Texture.h"
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace Assets {
         TextureCollection::TextureCollection() :
@@ -143,5 +145,12 @@ namespace TrenchBroom {
             --m_usageCount;
             usageCountDidChange();
         }
+
+        void TextureCollection::replaceTextureId(const GLuint oldId, const GLuint newId) {
+            auto it = std::find(std::begin(m_textureIds), std::end(m_textureIds), oldId);
+            if (it != std::end(m_textureIds)) {
+                *it = newId;
+            }
+        }
     }
 }
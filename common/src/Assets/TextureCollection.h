@@ -71,6 +71,7 @@ namespace TrenchBroom {
         private:
             void incUsageCount();
             void decUsageCount();
+            void replaceTextureId(GLuint oldId, GLuint newId);
         };
     }
 }
@@ -138,6 +138,7 @@ namespace TrenchBroom {
         void TextureManager::commitChanges() {
             resetTextureMode();
             prepare();
+            evictUnusedTextures();
             VectorUtils::clearAndDelete(m_toRemove);
         }
 
@@ -180,6 +181,43 @@ namespace TrenchBroom {
             m_toPrepare.clear();
         }
 
+        /**
+         * The amount of video memory that textures which are not used by any face may occupy before the least recently
+         * activated of them are evicted.
+         */
+        static const size_t UnusedTextureMemoryBudget = 256u * 1024u * 1024u;
+
+        void TextureManager::evictUnusedTextures() {
+            TextureList candidates;
+            size_t memorySize = 0;
+            for (auto* collection : m_collections) {
+                for (auto* texture : collection->textures()) {
+                    if (texture->usageCount() == 0 && texture->isUploaded()) {
+                        candidates.push_back(texture);
+                        memorySize += texture->videoMemorySize();
+                    }
+                }
+            }
+
+            if (memorySize <= UnusedTextureMemoryBudget) {
+                return;
+            }
+
+            std::sort(std::begin(candidates), std::end(candidates),
+                      [](const auto* lhs, const auto* rhs) { return lhs->lastActivation() < rhs->lastActivation(); });
+
+            for (auto* texture : candidates) {
+                if (memorySize <= UnusedTextureMemoryBudget) {
+                    break;
+                }
+
+                const auto textureSize = texture->videoMemorySize();
+                if (texture->evict()) {
+                    memorySize -= textureSize;
+                }
+            }
+        }
+
         void TextureManager::updateTextures() {
             m_texturesByName.clear();
             m_textures.clear();
@@ -79,6 +79,7 @@ namespace TrenchBroom {
         private:
             void resetTextureMode();
             void prepare();
+            void evictUnusedTextures();
 
             void updateTextures();
         };
@@ -0,0 +1,80 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_HalfSpaceUtils_h
+#define TrenchBroom_HalfSpaceUtils_h
+
+#include <vecmath/plane.h>
+
+#include <cstddef>
+
+/**
+ * Tests axis aligned boxes against the intersection of a set of half spaces, e.g. the convex volume bounded by the
+ * side planes of a view frustum. Every half space is the space behind its plane, i.e. the plane normals point out of
+ * the volume.
+ *
+ * The planes can be given as any range of vm::plane, and the box corners as any indexable type with S components,
+ * so that boxes can be tested against planes of a different precision. The computations use the precision of the
+ * planes.
+ */
+namespace HalfSpaceUtils {
+    /**
+     * Returns the distance of the corner of the given box that is farthest in front of the given plane if
+     * farthestInFront is true, or of the corner that is farthest behind it otherwise.
+     */
+    template <typename T, size_t S, typename V>
+    T cornerDistance(const vm::plane<T,S>& plane, const V& min, const V& max, const bool farthestInFront) {
+        auto distance = -plane.distance;
+        for (size_t i = 0; i < S; ++i) {
+            const auto positive = plane.normal[i] >= T(0);
+            distance += plane.normal[i] * T(positive == farthestInFront ? max[i] : min[i]);
+        }
+        return distance;
+    }
+
+    /**
+     * Determines whether the box with the given corners lies entirely in front of at least one of the given planes,
+     * in which case it cannot intersect the volume.
+     */
+    template <typename Planes, typename V>
+    bool boxOutside(const Planes& planes, const V& min, const V& max) {
+        for (const auto& plane : planes) {
+            if (cornerDistance(plane, min, max, false) > 0.0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Determines whether the box with the given corners lies entirely behind all of the given planes, i.e. inside of
+     * the volume.
+     */
+    template <typename Planes, typename V>
+    bool boxContained(const Planes& planes, const V& min, const V& max) {
+        for (const auto& plane : planes) {
+            if (cornerDistance(plane, min, max, true) > 0.0) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+#endif
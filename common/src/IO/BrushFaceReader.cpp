@@ -19,6 +19,7 @@
 
 #include "BrushFaceReader.h"
 
+#include "CollectionUtils.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/Entity.h"
@@ -24,6 +24,7 @@
 #include "IO/PathQt.h"
 #include "StringUtils.h"
 
+#include <QDateTime>
 #include <QDir>
 #include <QFileInfo>
 
@@ -113,6 +114,15 @@ namespace TrenchBroom {
                 return fileInfo.exists() && fileInfo.isFile();
             }
 
+            int64_t fileModificationTime(const Path& path) {
+                const Path fixedPath = fixPath(path);
+                QFileInfo fileInfo = QFileInfo(pathAsQString(fixedPath));
+                if (!fileInfo.exists() || !fileInfo.isFile()) {
+                    throw FileNotFoundException("File not found: '" + fixedPath.asString() + "'");
+                }
+                return static_cast<int64_t>(fileInfo.lastModified().toMSecsSinceEpoch());
+            }
+
             Path::List getDirectoryContents(const Path& path) {
                 const Path fixedPath = fixPath(path);
                 QDir dir(pathAsQString(fixedPath));
@@ -138,6 +148,15 @@ namespace TrenchBroom {
                 return std::make_shared<CFile>(fixedPath);
             }
 
+            std::shared_ptr<File> mapFile(const Path& path) {
+                const Path fixedPath = fixPath(path);
+                if (!fileExists(fixedPath)) {
+                    throw FileNotFoundException("File not found: '" + fixedPath.asString() + "'");
+                }
+
+                return std::make_shared<MappedFile>(fixedPath);
+            }
+
             Path getCurrentWorkingDir() {
                 return pathFromQString(QDir::currentPath());
             }
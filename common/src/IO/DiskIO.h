@@ -23,6 +23,7 @@
 #include "StringType.h"
 #include "IO/Path.h"
 
+#include <cstdint>
 #include <memory>
 
 namespace TrenchBroom {
@@ -37,8 +38,25 @@ namespace TrenchBroom {
             bool directoryExists(const Path& path);
             bool fileExists(const Path& path);
 
+            /**
+             * Returns the time at which the file at the given path was last modified, in milliseconds since the epoch.
+             *
+             * @throw FileNotFoundException if the file does not exist
+             */
+            int64_t fileModificationTime(const Path& path);
+
             Path::List getDirectoryContents(const Path& path);
             std::shared_ptr<File> openFile(const Path& path);
+
+            /**
+             * Opens the file at the given path and maps it into memory. Only use this for files which are read once
+             * and closed right away, such as map files: while a file is mapped, it cannot be overwritten on Windows,
+             * and truncating it from another process crashes the application on POSIX systems.
+             *
+             * @throw FileNotFoundException if the file does not exist
+             * @throw FileSystemException if the file cannot be opened or mapped
+             */
+            std::shared_ptr<File> mapFile(const Path& path);
             Path getCurrentWorkingDir();
 
             template <class M>
@@ -21,6 +21,15 @@
 
 #include "IO/IOUtils.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace TrenchBroom {
     namespace IO {
         File::File(const Path& path) :
@@ -89,6 +98,82 @@ namespace TrenchBroom {
             return m_file;
         }
 
+        MappedFile::MappedFile(const Path& path) :
+        File(path),
+        m_begin(nullptr),
+        m_size(0) {
+#ifdef _WIN32
+            HANDLE file = CreateFileA(path.asString().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) {
+                throw FileSystemException() << "Cannot open file " << path;
+            }
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file, &size)) {
+                CloseHandle(file);
+                throw FileSystemException() << "Cannot get size of file " << path;
+            }
+            m_size = static_cast<size_t>(size.QuadPart);
+
+            // empty files cannot be mapped
+            if (m_size > 0) {
+                HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping != nullptr) {
+                    m_begin = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    // the view keeps the mapping and the file open
+                    CloseHandle(mapping);
+                }
+                if (m_begin == nullptr) {
+                    CloseHandle(file);
+                    throw FileSystemException() << "Cannot map file " << path;
+                }
+            }
+            CloseHandle(file);
+#else
+            const int file = open(path.asString().c_str(), O_RDONLY);
+            if (file == -1) {
+                throw FileSystemException() << "Cannot open file " << path;
+            }
+
+            struct stat info;
+            if (fstat(file, &info) == -1) {
+                close(file);
+                throw FileSystemException() << "Cannot get size of file " << path;
+            }
+            m_size = static_cast<size_t>(info.st_size);
+
+            // empty files cannot be mapped
+            if (m_size > 0) {
+                void* address = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+                if (address == MAP_FAILED) {
+                    close(file);
+                    throw FileSystemException() << "Cannot map file " << path;
+                }
+                m_begin = static_cast<const char*>(address);
+            }
+            // the mapping remains valid after the file is closed
+            close(file);
+#endif
+        }
+
+        MappedFile::~MappedFile() {
+            if (m_begin != nullptr) {
+#ifdef _WIN32
+                UnmapViewOfFile(m_begin);
+#else
+                munmap(const_cast<char*>(m_begin), m_size);
+#endif
+            }
+        }
+
+        Reader MappedFile::reader() const {
+            return Reader::from(m_begin, m_begin + m_size);
+        }
+
+        size_t MappedFile::size() const {
+            return m_size;
+        }
+
         FileView::FileView(const Path& path, std::shared_ptr<File> file, const size_t offset, const size_t length) :
         File(path),
         m_file(std::move(file)),
@@ -102,5 +187,48 @@ namespace TrenchBroom {
         size_t FileView::size() const {
             return m_length;
         }
+
+        const std::shared_ptr<File>& FileView::hostFile() const {
+            return m_file;
+        }
+
+        size_t FileView::offset() const {
+            return m_offset;
+        }
+
+        std::shared_ptr<File> concurrentlyReadableFile(std::shared_ptr<File> file) {
+            if (dynamic_cast<const FileView*>(file.get()) == nullptr) {
+                return file;
+            }
+
+            auto reader = file->reader();
+            const auto size = reader.size();
+            auto buffer = std::make_unique<char[]>(size);
+            reader.read(buffer.get(), size);
+            return std::make_shared<OwningBufferFile>(file->path(), std::move(buffer), size);
+        }
+
+        static bool isPhysicalFile(const File* file) {
+            return dynamic_cast<const CFile*>(file) != nullptr || dynamic_cast<const MappedFile*>(file) != nullptr;
+        }
+
+        FileOpener fileOpener(std::shared_ptr<File> file) {
+            if (isPhysicalFile(file.get())) {
+                return [path = file->path()]() -> std::shared_ptr<File> {
+                    return std::make_shared<CFile>(path);
+                };
+            }
+
+            const auto* fileView = dynamic_cast<const FileView*>(file.get());
+            if (fileView != nullptr && isPhysicalFile(fileView->hostFile().get())) {
+                return [path = file->path(), hostPath = fileView->hostFile()->path(), offset = fileView->offset(), length = fileView->size()]() -> std::shared_ptr<File> {
+                    return std::make_shared<FileView>(path, std::make_shared<CFile>(hostPath), offset, length);
+                };
+            }
+
+            return [file = concurrentlyReadableFile(std::move(file))]() {
+                return file;
+            };
+        }
     }
 }
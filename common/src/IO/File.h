@@ -24,6 +24,7 @@
 #include "IO/Reader.h"
 
 #include <cstdio>
+#include <functional>
 #include <memory>
 
 namespace TrenchBroom {
@@ -136,6 +137,30 @@ namespace TrenchBroom {
             std::FILE* file() const;
         };
 
+        /**
+         * A file that is backed by a physical file on the disk which is mapped into memory. The file is mapped
+         * read only in the constructor and unmapped in the destructor. Readers of this file access the mapped memory
+         * directly, so buffering them does not copy the file contents.
+         */
+        class MappedFile : public File {
+        private:
+            const char* m_begin;
+            size_t m_size;
+        public:
+            /**
+             * Creates a new file with the given path and maps the file into memory.
+             *
+             * @param path the path of the file
+             *
+             * @throw FileSystemException if the file cannot be opened or mapped
+             */
+            explicit MappedFile(const Path& path);
+            ~MappedFile() override;
+
+            Reader reader() const override;
+            size_t size() const override;
+        };
+
         /**
          * A file that is backed by a portion of a physical file.
          */
@@ -157,8 +182,38 @@ namespace TrenchBroom {
 
             Reader reader() const override;
             size_t size() const override;
+
+            const std::shared_ptr<File>& hostFile() const;
+            size_t offset() const;
         };
 
+        /**
+         * Returns a file with the contents of the given file that can be read concurrently with other files. File
+         * views share the C file of their host file, so their contents are copied into memory. All other files are
+         * returned as they are.
+         *
+         * @param file the file
+         * @return a file that can be read concurrently
+         */
+        std::shared_ptr<File> concurrentlyReadableFile(std::shared_ptr<File> file);
+
+        using FileOpener = std::function<std::shared_ptr<File>()>;
+
+        /**
+         * Returns a function that opens the given file again. If the given file is a physical file or a view of a
+         * physical file, only its location is kept, and the physical file is opened anew whenever the function is
+         * called, so that its contents are not held in memory in between. All other files are kept as they are, or
+         * copied into memory if necessary.
+         *
+         * The returned files can be read concurrently with other files.
+         *
+         * @param file the file
+         * @return a function that opens the file
+         *
+         * @throw FileSystemException if the function is called and the physical file cannot be opened
+         */
+        FileOpener fileOpener(std::shared_ptr<File> file);
+
         // TODO: get rid of this, it's evil
         /**
          * A file that is backed by a C++ object. These kinds of files are used to insert custom objects into the virtual
@@ -117,5 +117,44 @@ namespace TrenchBroom {
             const auto textureType = Assets::Texture::selectTextureType(masked);
             return new Assets::Texture(textureName(path), imageWidth, imageHeight, Color(), buffers, format, textureType);
         }
+
+        Assets::Texture* FreeImageTextureReader::doReadTextureInfo(std::shared_ptr<File> file) const {
+            auto reader = file->reader().buffer();
+
+            InitFreeImage::initialize();
+
+            const auto& path            = file->path();
+            const auto* begin           = reader.begin();
+            const auto* end             = reader.end();
+            const auto  imageSize       = static_cast<size_t>(end - begin);
+                  auto* imageBegin      = reinterpret_cast<BYTE*>(const_cast<char*>(begin));
+                  auto* imageMemory     = FreeImage_OpenMemory(imageBegin, static_cast<DWORD>(imageSize));
+            const auto  imageFormat     = FreeImage_GetFileTypeFromMemory(imageMemory);
+                  // formats that don't support loading only the header load the pixels, too
+                  auto* image           = FreeImage_LoadFromMemory(imageFormat, imageMemory, FIF_LOAD_NOPIXELS);
+
+            if (image == nullptr) {
+                FreeImage_CloseMemory(imageMemory);
+                return new Assets::Texture(textureName(path), 64, 64);
+            }
+
+            const auto imageWidth      = static_cast<size_t>(FreeImage_GetWidth(image));
+            const auto imageHeight     = static_cast<size_t>(FreeImage_GetHeight(image));
+            const auto masked          = FreeImage_IsTransparent(image);
+
+            FreeImage_Unload(image);
+            FreeImage_CloseMemory(imageMemory);
+
+            if (!checkTextureDimensions(imageWidth, imageHeight)) {
+                return new Assets::Texture(textureName(path), 64, 64);
+            }
+
+            constexpr auto format = freeImage32BPPFormatToGLFormat();
+            return new Assets::Texture(textureName(path), imageWidth, imageHeight, format, Assets::Texture::selectTextureType(masked));
+        }
+
+        bool FreeImageTextureReader::doCanReadConcurrently() const {
+            return true;
+        }
     }
 }
@@ -34,6 +34,8 @@ namespace TrenchBroom {
             FreeImageTextureReader(const NameStrategy& nameStrategy);
         private:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
+            Assets::Texture* doReadTextureInfo(std::shared_ptr<File> file) const override;
+            bool doCanReadConcurrently() const override;
         };
     }
 }
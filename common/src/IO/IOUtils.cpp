@@ -120,6 +120,11 @@ namespace TrenchBroom {
             std::fprintf(stream, "// Format: %s\n", mapFormat.c_str());
         }
 
+        void writeGameComment(String& output, const String& gameName, const String& mapFormat) {
+            output.append("// Game: ").append(gameName).append("\n");
+            output.append("// Format: ").append(mapFormat).append("\n");
+        }
+
         vm::vec3f readVec3f(const char*& cursor) {
             vm::vec3f value;
             for (size_t i = 0; i < 3; i++) {
@@ -22,249 +22,449 @@
 #include "Exceptions.h"
 #include "Macros.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/MapTextSnapshot.h"
+#include "IO/NodeTextCache.h"
+#include "Model/AttributableNode.h"
 #include "Model/BrushFace.h"
-#include "StringStream.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
 
 namespace TrenchBroom {
     namespace IO {
+        static const int TextureInfoPrecision = 6;
+
         class QuakeFileSerializer : public MapFileSerializer {
-        private:
-            String FacePointFormat;
-            String TextureInfoFormat;
         public:
-            QuakeFileSerializer(FILE* stream) :
-            MapFileSerializer(stream),
-            FacePointFormat(getFacePointFormat()),
-            TextureInfoFormat(" %s %.6g %.6g %.6g %.6g %.6g") {}
-        private:
-            static String getFacePointFormat() {
-                StringStream str;
-                str <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g )";
-                return str.str();
-            }
+            QuakeFileSerializer(const Model::MapFormat format, FILE* stream, MapTextSnapshot* snapshot) :
+            MapFileSerializer(format, stream, snapshot) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                std::fprintf(stream, "\n");
+            size_t doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                writeTextureInfo(face);
+                write('\n');
                 return 1;
             }
         protected:
-            void writeFacePoints(FILE* stream, Model::BrushFace* face) {
+            void writeFacePoints(Model::BrushFace* face) {
                 const Model::BrushFace::Points& points = face->points();
 
-                std::fprintf(stream, FacePointFormat.c_str(),
-                             points[0].x(),
-                             points[0].y(),
-                             points[0].z(),
-                             points[1].x(),
-                             points[1].y(),
-                             points[1].z(),
-                             points[2].x(),
-                             points[2].y(),
-                             points[2].z());
+                for (size_t i = 0; i < 3; ++i) {
+                    if (i > 0) {
+                        write(' ');
+                    }
+                    write("( ");
+                    writeFloat(points[i].x());
+                    write(' ');
+                    writeFloat(points[i].y());
+                    write(' ');
+                    writeFloat(points[i].z());
+                    write(" )");
+                }
             }
 
-            void writeTextureInfo(FILE* stream, Model::BrushFace* face) {
+            void writeTextureInfo(Model::BrushFace* face) {
                 const String& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
-                std::fprintf(stream, TextureInfoFormat.c_str(),
-                             textureName.c_str(),
-                             face->xOffset(),
-                             face->yOffset(),
-                             face->rotation(),
-                             face->xScale(),
-                             face->yScale());
+                write(' ');
+                write(textureName);
+                write(' ');
+                writeFloat(face->xOffset(), TextureInfoPrecision);
+                write(' ');
+                writeFloat(face->yOffset(), TextureInfoPrecision);
+                write(' ');
+                writeFloat(face->rotation(), TextureInfoPrecision);
+                write(' ');
+                writeFloat(face->xScale(), TextureInfoPrecision);
+                write(' ');
+                writeFloat(face->yScale(), TextureInfoPrecision);
             }
         };
 
         class Quake2FileSerializer : public QuakeFileSerializer {
-        private:
-            String SurfaceAttributesFormat;
         public:
-            Quake2FileSerializer(FILE* stream) :
-            QuakeFileSerializer(stream),
-            SurfaceAttributesFormat(" %d %d %.6g") {}
+            Quake2FileSerializer(const Model::MapFormat format, FILE* stream, MapTextSnapshot* snapshot) :
+            QuakeFileSerializer(format, stream, snapshot) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            size_t doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                writeTextureInfo(face);
 
                 if (face->hasSurfaceAttributes()) {
-                    writeSurfaceAttributes(stream, face);
+                    writeSurfaceAttributes(face);
                 }
 
-                std::fprintf(stream, "\n");
+                write('\n');
                 return 1;
             }
         protected:
-            void writeSurfaceAttributes(FILE* stream, Model::BrushFace* face) {
-                std::fprintf(stream, SurfaceAttributesFormat.c_str(),
-                             face->surfaceContents(),
-                             face->surfaceFlags(),
-                             face->surfaceValue());
+            void writeSurfaceAttributes(Model::BrushFace* face) {
+                write(' ');
+                writeInteger(face->surfaceContents());
+                write(' ');
+                writeInteger(face->surfaceFlags());
+                write(' ');
+                writeFloat(face->surfaceValue(), TextureInfoPrecision);
             }
         };
 
 
         class DaikatanaFileSerializer : public Quake2FileSerializer {
-        private:
-            String SurfaceColorFormat;
         public:
-            DaikatanaFileSerializer(FILE* stream) :
-            Quake2FileSerializer(stream),
-            SurfaceColorFormat(" %d %d %d") {}
+            DaikatanaFileSerializer(const Model::MapFormat format, FILE* stream, MapTextSnapshot* snapshot) :
+            Quake2FileSerializer(format, stream, snapshot) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
+            size_t doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                writeTextureInfo(face);
 
                 if (face->hasSurfaceAttributes() || face->hasColor()) {
-                    writeSurfaceAttributes(stream, face);
+                    writeSurfaceAttributes(face);
                 }
                 if (face->hasColor()) {
-                    writeSurfaceColor(stream, face);
+                    writeSurfaceColor(face);
                 }
 
-                std::fprintf(stream, "\n");
+                write('\n');
                 return 1;
             }
         protected:
-            void writeSurfaceColor(FILE* stream, Model::BrushFace* face) {
-                std::fprintf(stream, SurfaceColorFormat.c_str(),
-                             static_cast<int>(face->color().r()),
-                             static_cast<int>(face->color().g()),
-                             static_cast<int>(face->color().b()));
+            void writeSurfaceColor(Model::BrushFace* face) {
+                write(' ');
+                writeInteger(static_cast<int>(face->color().r()));
+                write(' ');
+                writeInteger(static_cast<int>(face->color().g()));
+                write(' ');
+                writeInteger(static_cast<int>(face->color().b()));
             }
         };
 
         class Hexen2FileSerializer : public QuakeFileSerializer {
         public:
-            Hexen2FileSerializer(FILE* stream):
-            QuakeFileSerializer(stream) {}
+            Hexen2FileSerializer(const Model::MapFormat format, FILE* stream, MapTextSnapshot* snapshot) :
+            QuakeFileSerializer(format, stream, snapshot) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeTextureInfo(stream, face);
-                std::fprintf(stream, " 0\n"); // extra value written here
+            size_t doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                writeTextureInfo(face);
+                write(" 0\n"); // extra value written here
                 return 1;
             }
         };
 
         class ValveFileSerializer : public QuakeFileSerializer {
-        private:
-            String ValveTextureInfoFormat;
         public:
-            ValveFileSerializer(FILE* stream) :
-            QuakeFileSerializer(stream),
-            ValveTextureInfoFormat(" %s [ %.6g %.6g %.6g %.6g ] [ %.6g %.6g %.6g %.6g ] %.6g %.6g %.6g") {}
+            ValveFileSerializer(const Model::MapFormat format, FILE* stream, MapTextSnapshot* snapshot) :
+            QuakeFileSerializer(format, stream, snapshot) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
-                writeFacePoints(stream, face);
-                writeValveTextureInfo(stream, face);
-                std::fprintf(stream, "\n");
+            size_t doWriteBrushFace(Model::BrushFace* face) override {
+                writeFacePoints(face);
+                writeValveTextureInfo(face);
+                write('\n');
                 return 1;
             }
         private:
-            void writeValveTextureInfo(FILE* stream, Model::BrushFace* face) {
+            void writeValveTextureInfo(Model::BrushFace* face) {
                 const String& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
                 const vm::vec3 xAxis = face->textureXAxis();
                 const vm::vec3 yAxis = face->textureYAxis();
 
-                std::fprintf(stream, ValveTextureInfoFormat.c_str(),
-                             textureName.c_str(),
+                write(' ');
+                write(textureName);
 
-                             xAxis.x(),
-                             xAxis.y(),
-                             xAxis.z(),
-                             face->xOffset(),
+                write(" [ ");
+                writeTextureAxis(xAxis, face->xOffset());
+                write(" ] [ ");
+                writeTextureAxis(yAxis, face->yOffset());
+                write(" ] ");
 
-                             yAxis.x(),
-                             yAxis.y(),
-                             yAxis.z(),
-                             face->yOffset(),
+                writeFloat(face->rotation(), TextureInfoPrecision);
+                write(' ');
+                writeFloat(face->xScale(), TextureInfoPrecision);
+                write(' ');
+                writeFloat(face->yScale(), TextureInfoPrecision);
+            }
 
-                             face->rotation(),
-                             face->xScale(),
-                             face->yScale());
+            void writeTextureAxis(const vm::vec3& axis, const float offset) {
+                writeFloat(axis.x(), TextureInfoPrecision);
+                write(' ');
+                writeFloat(axis.y(), TextureInfoPrecision);
+                write(' ');
+                writeFloat(axis.z(), TextureInfoPrecision);
+                write(' ');
+                writeFloat(offset, TextureInfoPrecision);
             }
         };
 
-        NodeSerializer::Ptr MapFileSerializer::create(const Model::MapFormat format, FILE* stream) {
+        static NodeSerializer::Ptr createSerializer(const Model::MapFormat format, FILE* stream, MapTextSnapshot* snapshot) {
             switch (format) {
                 case Model::MapFormat::Standard:
-                    return NodeSerializer::Ptr(new QuakeFileSerializer(stream));
+                    return NodeSerializer::Ptr(new QuakeFileSerializer(format, stream, snapshot));
                 case Model::MapFormat::Quake2:
                     // TODO 2427: Implement Quake3 serializers and use them
                 case Model::MapFormat::Quake3:
                 case Model::MapFormat::Quake3_Legacy:
-                    return NodeSerializer::Ptr(new Quake2FileSerializer(stream));
+                    return NodeSerializer::Ptr(new Quake2FileSerializer(format, stream, snapshot));
                 case Model::MapFormat::Daikatana:
-                    return NodeSerializer::Ptr(new DaikatanaFileSerializer(stream));
+                    return NodeSerializer::Ptr(new DaikatanaFileSerializer(format, stream, snapshot));
                 case Model::MapFormat::Valve:
-                    return NodeSerializer::Ptr(new ValveFileSerializer(stream));
+                    return NodeSerializer::Ptr(new ValveFileSerializer(format, stream, snapshot));
                 case Model::MapFormat::Hexen2:
-                    return NodeSerializer::Ptr(new Hexen2FileSerializer(stream));
+                    return NodeSerializer::Ptr(new Hexen2FileSerializer(format, stream, snapshot));
                 case Model::MapFormat::Unknown:
                     throw FileFormatException("Unknown map file format");
                 switchDefault()
             }
         }
 
-        MapFileSerializer::MapFileSerializer(FILE* stream) :
+        NodeSerializer::Ptr MapFileSerializer::create(const Model::MapFormat format, FILE* stream) {
+            ensure(stream != nullptr, "stream is null");
+            return createSerializer(format, stream, nullptr);
+        }
+
+        NodeSerializer::Ptr MapFileSerializer::create(const Model::MapFormat format, MapTextSnapshot& snapshot) {
+            return createSerializer(format, nullptr, &snapshot);
+        }
+
+        MapFileSerializer::MapFileSerializer(const Model::MapFormat format, FILE* stream, MapTextSnapshot* snapshot) :
         m_line(1),
-        m_stream(stream) {
-            ensure(m_stream != nullptr, "stream is null");
+        m_format(format),
+        m_stream(stream),
+        m_snapshot(snapshot),
+        m_facesCached(false),
+        m_facesStart(0) {
+            assert((m_stream == nullptr) != (m_snapshot == nullptr));
+        }
+
+        // The buffered text is only written by doEndFile, where errors can be reported. If the file was not ended,
+        // writing it failed and the remaining text is discarded.
+        MapFileSerializer::~MapFileSerializer() {}
+
+        void MapFileSerializer::write(const char c) {
+            m_buffer.push_back(c);
+        }
+
+        void MapFileSerializer::write(const char* str) {
+            m_buffer.append(str);
+        }
+
+        void MapFileSerializer::write(const String& str) {
+            m_buffer.append(str);
+        }
+
+        void MapFileSerializer::writeInteger(const long long value) {
+            char buffer[24];
+            auto* end = buffer + sizeof(buffer);
+            auto* cur = end;
+
+            auto magnitude = value < 0 ? 0ull - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+            do {
+                *--cur = static_cast<char>('0' + magnitude % 10u);
+                magnitude /= 10u;
+            } while (magnitude > 0u);
+
+            if (value < 0) {
+                *--cur = '-';
+            }
+            m_buffer.append(cur, end);
+        }
+
+        /**
+         * Formats the given value like printf's %.<precision>g if the value has an exact decimal representation with
+         * at most the given number of significant digits, which is the case for integers and for multiples of small
+         * powers of 1/2, e.g. grid coordinates. Then printf prints exactly these digits in fixed point notation.
+         *
+         * Returns false if the value cannot be formatted this way.
+         */
+        static bool formatExactDecimal(const double value, const int precision, String& result) {
+            static const uint64_t PowersOfTen[] = {
+                1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+                1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+                100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull
+            };
+            static const int MaxPrecision = 17;
+            static const int MaxFractionDigits = 20;
+
+            if (value == 0.0) {
+                result.append(std::signbit(value) ? "-0" : "0");
+                return true;
+            }
+
+            const auto magnitude = std::abs(value);
+            // printf switches to exponential notation for small values, and this rejects NaN and infinity
+            if (precision > MaxPrecision || !(magnitude >= 1e-4 && magnitude < static_cast<double>(PowersOfTen[precision]))) {
+                return false;
+            }
+
+            // find the number of binary digits after the point, which is also the number of decimal digits
+            int exponent;
+            const auto mantissa = std::frexp(magnitude, &exponent);
+            auto bits = static_cast<uint64_t>(std::ldexp(mantissa, 53));
+            auto fractionDigits = 53 - exponent;
+            while (fractionDigits > 0 && (bits & 1u) == 0u) {
+                bits >>= 1u;
+                --fractionDigits;
+            }
+            if (fractionDigits > MaxFractionDigits) {
+                return false;
+            }
+
+            // the decimal digits are value * 10^fractionDigits = value * 2^fractionDigits * 5^fractionDigits
+            auto digits = static_cast<uint64_t>(std::ldexp(magnitude, std::max(fractionDigits, 0)));
+            for (int i = 0; i < fractionDigits; ++i) {
+                if (digits >= PowersOfTen[precision] / 5u) {
+                    return false;
+                }
+                digits *= 5u;
+            }
+            if (digits >= PowersOfTen[precision]) {
+                return false;
+            }
+
+            char buffer[32];
+            auto* end = buffer + sizeof(buffer);
+            auto* cur = end;
+            for (int i = 0; i < fractionDigits; ++i) {
+                *--cur = static_cast<char>('0' + digits % 10u);
+                digits /= 10u;
+            }
+            if (fractionDigits > 0) {
+                *--cur = '.';
+            }
+            do {
+                *--cur = static_cast<char>('0' + digits % 10u);
+                digits /= 10u;
+            } while (digits > 0u);
+            if (value < 0.0) {
+                *--cur = '-';
+            }
+
+            result.append(cur, end);
+            return true;
+        }
+
+        void MapFileSerializer::writeFloat(const double value, const int precision) {
+            if (!formatExactDecimal(value, precision, m_buffer)) {
+                char buffer[64];
+                const auto length = std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+                m_buffer.append(buffer, static_cast<size_t>(length));
+            }
+        }
+
+        void MapFileSerializer::writeCached(const std::shared_ptr<const String>& text) {
+            if (m_snapshot != nullptr) {
+                flush();
+                m_snapshot->append(text);
+            } else {
+                m_buffer.append(*text);
+            }
+        }
+
+        void MapFileSerializer::flush() {
+            if (m_snapshot != nullptr) {
+                m_snapshot->append(std::move(m_buffer));
+                m_buffer.clear();
+            } else if (!m_buffer.empty()) {
+                const auto written = std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_stream);
+                const auto expected = m_buffer.size();
+                m_buffer.clear();
+                if (written != expected) {
+                    throw FileSystemException("Could not write map file");
+                }
+            }
         }
 
         void MapFileSerializer::doBeginFile() {}
-        void MapFileSerializer::doEndFile() {}
+
+        void MapFileSerializer::doEndFile() {
+            flush();
+
+            // the C library may still buffer some of the text, and errors writing it are only reported when it is flushed
+            if (m_stream != nullptr && (std::fflush(m_stream) != 0 || std::ferror(m_stream) != 0)) {
+                throw FileSystemException("Could not write map file");
+            }
+        }
 
         void MapFileSerializer::doBeginEntity(const Model::Node* node) {
-            std::fprintf(m_stream, "// entity %u\n", entityNo());
+            write("// entity ");
+            writeInteger(entityNo());
+            write('\n');
             ++m_line;
             m_startLineStack.push_back(m_line);
-            std::fprintf(m_stream, "{\n");
+            write("{\n");
             ++m_line;
         }
 
         void MapFileSerializer::doEndEntity(Model::Node* node) {
-            std::fprintf(m_stream, "}\n");
+            write("}\n");
             ++m_line;
             setFilePosition(node);
         }
 
         void MapFileSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {
-            std::fprintf(m_stream, "\"%s\" \"%s\"\n",
-                         escapeEntityAttribute( attribute.name()).c_str(),
-                         escapeEntityAttribute(attribute.value()).c_str());
+            write('"');
+            write(escapeEntityAttribute(attribute.name()));
+            write("\" \"");
+            write(escapeEntityAttribute(attribute.value()));
+            write("\"\n");
             ++m_line;
         }
 
+        void MapFileSerializer::doEntityAttributes(const Model::Node* node, const Model::EntityAttribute::List& attributes) {
+            // layers and groups are written with generated attributes, which must not be cached
+            const auto* attributable = dynamic_cast<const Model::AttributableNode*>(node);
+            if (attributable == nullptr || &attributable->attributes() != &attributes) {
+                for (const auto& attribute : attributes) {
+                    doEntityAttribute(attribute);
+                }
+                return;
+            }
+
+            auto& cache = attributable->attributeTextCache();
+            if (const auto text = cache.get(m_format)) {
+                writeCached(text);
+                m_line += attributes.size();
+            } else {
+                const auto start = m_buffer.size();
+                for (const auto& attribute : attributes) {
+                    doEntityAttribute(attribute);
+                }
+                cache.set(m_format, m_buffer.substr(start));
+            }
+        }
+
         void MapFileSerializer::doBeginBrush(const Model::Brush* brush) {
-            std::fprintf(m_stream, "// brush %u\n", brushNo());
+            write("// brush ");
+            writeInteger(brushNo());
+            write('\n');
             ++m_line;
             m_startLineStack.push_back(m_line);
-            std::fprintf(m_stream, "{\n");
+            write("{\n");
             ++m_line;
+
+            const auto cachedFaces = brush->faceTextCache().get(m_format);
+            m_facesCached = cachedFaces != nullptr;
+            if (m_facesCached) {
+                writeCached(cachedFaces);
+            }
+            m_facesStart = m_buffer.size();
         }
 
         void MapFileSerializer::doEndBrush(Model::Brush* brush) {
-            std::fprintf(m_stream, "}\n");
+            if (!m_facesCached) {
+                brush->faceTextCache().set(m_format, m_buffer.substr(m_facesStart));
+            }
+            m_facesCached = false;
+
+            write("}\n");
             ++m_line;
             setFilePosition(brush);
         }
 
         void MapFileSerializer::doBrushFace(Model::BrushFace* face) {
-            const size_t lines = doWriteBrushFace(m_stream, face);
+            // if the faces were copied from the cache, then the line counts from when they were formatted still apply
+            const size_t lines = m_facesCached ? face->lineCount() : doWriteBrushFace(face);
             face->setFilePosition(m_line, lines);
             m_line += lines;
         }
@@ -25,28 +25,60 @@
 #include "Model/Brush.h"
 
 #include <cstdio>
+#include <memory>
 
 namespace TrenchBroom {
     namespace IO {
+        class MapTextSnapshot;
         class Path;
 
+        /**
+         * Writes map files. The output is collected in memory and written to the file when the serializer is done, and
+         * numbers are formatted without going through printf where possible. The output is the same as if it was
+         * written using fprintf with the %d and %.<precision>g formats.
+         *
+         * Instead of a file, the output can also be appended to a snapshot, e.g. to write it to disk on another thread.
+         *
+         * The text of the faces of each brush and of the attributes of each entity is stored in the node's text cache.
+         * When the map is written again, the text of unchanged nodes is copied from their caches instead of formatting
+         * them again. A snapshot shares the cached text instead of copying it.
+         */
         class MapFileSerializer : public NodeSerializer {
         private:
             using LineStack = std::vector<size_t>;
             LineStack m_startLineStack;
             size_t m_line;
+            Model::MapFormat m_format;
             FILE* m_stream;
+            MapTextSnapshot* m_snapshot;
+            String m_buffer;
+
+            bool m_facesCached;
+            size_t m_facesStart;
         public:
             static Ptr create(Model::MapFormat format, FILE* stream);
+            static Ptr create(Model::MapFormat format, MapTextSnapshot& snapshot);
+        protected:
+            MapFileSerializer(Model::MapFormat format, FILE* stream, MapTextSnapshot* snapshot);
+        public:
+            ~MapFileSerializer() override;
         protected:
-            MapFileSerializer(FILE* file);
+            void write(char c);
+            void write(const char* str);
+            void write(const String& str);
+            void writeInteger(long long value);
+            void writeFloat(double value, int precision = FloatPrecision);
         private:
+            void writeCached(const std::shared_ptr<const String>& text);
+            void flush();
+
             void doBeginFile() override;
             void doEndFile() override;
 
             void doBeginEntity(const Model::Node* node) override;
             void doEndEntity(Model::Node* node) override;
             void doEntityAttribute(const Model::EntityAttribute& attribute) override;
+            void doEntityAttributes(const Model::Node* node, const Model::EntityAttribute::List& attributes) override;
             void doBeginBrush(const Model::Brush* brush) override;
             void doEndBrush(Model::Brush* brush) override;
             void doBrushFace(Model::BrushFace* face) override;
@@ -54,7 +86,7 @@ namespace TrenchBroom {
             void setFilePosition(Model::Node* node);
             size_t startLine();
         private:
-            virtual size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) = 0;
+            virtual size_t doWriteBrushFace(Model::BrushFace* face) = 0;
         };
     }
 }
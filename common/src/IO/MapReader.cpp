@@ -27,9 +27,46 @@
 #include "Model/Group.h"
 #include "Model/Layer.h"
 #include "Model/ModelFactory.h"
+#include "ParallelUtils.h"
+
+#include <iterator>
+#include <utility>
 
 namespace TrenchBroom {
     namespace IO {
+        /**
+         * Passes messages on to another status, but holds them back while there are pending brushes. The errors of
+         * the pending brushes are only known once they are built, and holding back the other messages until then
+         * keeps all messages in the order in which they were reported.
+         */
+        class MapReader::HoldingStatus : public ParserStatus {
+        private:
+            MapReader& m_reader;
+            ParserStatus& m_status;
+        public:
+            HoldingStatus(MapReader& reader, ParserStatus& status) :
+            ParserStatus(nullLogger(), status.prefix()),
+            m_reader(reader),
+            m_status(status) {}
+        private:
+            static Logger& nullLogger() {
+                static NullLogger logger;
+                return logger;
+            }
+
+            void doProgress(const double progress) override {
+                m_status.progress(progress);
+            }
+
+            void doLog(const Logger::LogLevel level, const String& str) override {
+                if (m_reader.m_pendingBrushes.empty()) {
+                    m_status.logFormatted(level, str);
+                } else {
+                    m_reader.m_heldMessages.push_back(HeldMessage { level, str });
+                }
+            }
+        };
+
         MapReader::ParentInfo MapReader::ParentInfo::layer(const Model::IdType layerId) {
             return ParentInfo(Type_Layer, layerId);
         }
@@ -68,17 +105,36 @@ namespace TrenchBroom {
 
         MapReader::~MapReader() {
             VectorUtils::clearAndDelete(m_faces);
+            for (auto& pending : m_pendingBrushes) {
+                VectorUtils::clearAndDelete(pending.faces);
+            }
         }
 
         void MapReader::readEntities(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseEntities(format, status);
+
+            HoldingStatus holdingStatus(*this, status);
+            try {
+                parseEntities(format, holdingStatus);
+                createPendingBrushes(holdingStatus);
+            } catch (...) {
+                discardPendingBrushes(status);
+                throw;
+            }
             resolveNodes(status);
         }
 
         void MapReader::readBrushes(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
-            parseBrushes(format, status);
+
+            HoldingStatus holdingStatus(*this, status);
+            try {
+                parseBrushes(format, holdingStatus);
+                createPendingBrushes(holdingStatus);
+            } catch (...) {
+                discardPendingBrushes(status);
+                throw;
+            }
         }
 
         void MapReader::readBrushFaces(Model::MapFormat format, const vm::bbox3& worldBounds, ParserStatus& status) {
@@ -109,6 +165,9 @@ namespace TrenchBroom {
         }
 
         void MapReader::onEndEntity(const size_t startLine, const size_t lineCount, ParserStatus& status) {
+            // build the brushes before the next entity begins so that nodes are added to their parents in file order
+            createPendingBrushes(status);
+
             if (m_currentNode != nullptr)
                 setFilePosition(m_currentNode, startLine, lineCount);
             else
@@ -222,20 +281,79 @@ namespace TrenchBroom {
         }
 
         void MapReader::createBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
+            // Only collect the faces here, the brush geometry is built by createPendingBrushes
+            m_pendingBrushes.push_back(PendingBrush { m_brushParent, m_faces, startLine, lineCount, extraAttributes, m_heldMessages.size() });
+            m_faces.clear();
+        }
+
+        void MapReader::createPendingBrushes(ParserStatus& status) {
+            // Building the brush geometry dominates the load time, so small batches aren't worth a thread.
+            static const size_t BatchSize = 64;
+
+            const size_t count = m_pendingBrushes.size();
+            Model::BrushList brushes(count, nullptr);
+            StringList errors(count);
+
             try {
-                Model::Brush* brush = m_factory->createBrush(m_worldBounds, m_faces);
-                setFilePosition(brush, startLine, lineCount);
-                setExtraAttributes(brush, extraAttributes);
+                ParallelUtils::parallelFor(count, [&](const size_t i) {
+                    // the brush takes ownership of the faces, and its constructor deletes them if it throws
+                    Model::BrushFaceList faces;
+                    std::swap(faces, m_pendingBrushes[i].faces);
+                    try {
+                        brushes[i] = m_factory->createBrush(m_worldBounds, faces);
+                    } catch (const GeometryException& e) {
+                        errors[i] = e.what();
+                    }
+                }, BatchSize);
+            } catch (...) {
+                VectorUtils::clearAndDelete(brushes);
+                throw;
+            }
 
-                onBrush(m_brushParent, brush, status);
-                m_faces.clear();
-            } catch (GeometryException& e) {
-                StringStream msg;
-                msg << "Skipping brush: " << e.what();
-                status.error(startLine, msg.str());
-                m_faces.clear(); // the faces will have been deleted by the brush's constructor
+            // from here on, messages are passed on right away
+            PendingBrushList pendingBrushes;
+            HeldMessageList heldMessages;
+            std::swap(pendingBrushes, m_pendingBrushes);
+            std::swap(heldMessages, m_heldMessages);
+
+            // attach the brushes on this thread and in file order, and log the held messages in between
+            auto message = std::begin(heldMessages);
+            for (size_t i = 0; i < count; ++i) {
+                const PendingBrush& pending = pendingBrushes[i];
+                const auto messagesEnd = std::next(std::begin(heldMessages), static_cast<std::ptrdiff_t>(pending.messageCount));
+                logHeldMessages(message, messagesEnd, status);
+                message = messagesEnd;
+
+                Model::Brush* brush = brushes[i];
+                if (brush != nullptr) {
+                    setFilePosition(brush, pending.startLine, pending.lineCount);
+                    setExtraAttributes(brush, pending.extraAttributes);
+                    onBrush(pending.parent, brush, status);
+                } else {
+                    StringStream msg;
+                    msg << "Skipping brush: " << errors[i];
+                    status.error(pending.startLine, msg.str());
+                }
+            }
+            logHeldMessages(message, std::end(heldMessages), status);
+        }
+
+        void MapReader::discardPendingBrushes(ParserStatus& status) {
+            for (auto& pending : m_pendingBrushes) {
+                VectorUtils::clearAndDelete(pending.faces);
             }
+            m_pendingBrushes.clear();
 
+            HeldMessageList heldMessages;
+            std::swap(heldMessages, m_heldMessages);
+            logHeldMessages(std::begin(heldMessages), std::end(heldMessages), status);
+        }
+
+        void MapReader::logHeldMessages(HeldMessageList::const_iterator cur, const HeldMessageList::const_iterator end, ParserStatus& status) {
+            while (cur != end) {
+                status.logFormatted(cur->level, cur->str);
+                ++cur;
+            }
         }
 
         MapReader::ParentInfo::Type MapReader::storeNode(Model::Node* node, const Model::EntityAttribute::List& attributes, ParserStatus& status) {
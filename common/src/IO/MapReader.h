@@ -20,6 +20,7 @@
 #ifndef TrenchBroom_MapReader
 #define TrenchBroom_MapReader
 
+#include "Logger.h"
 #include "TrenchBroom.h"
 #include "IO/StandardMapParser.h"
 #include "Model/ModelTypes.h"
@@ -71,6 +72,34 @@ namespace TrenchBroom {
             using NodeParentPair = std::pair<Model::Node*, ParentInfo>;
             using NodeParentList = std::vector<NodeParentPair>;
 
+            /**
+             * The parsed faces of a brush whose geometry has not been built yet.
+             */
+            struct PendingBrush {
+                Model::Node* parent;
+                Model::BrushFaceList faces;
+                size_t startLine;
+                size_t lineCount;
+                ExtraAttributes extraAttributes;
+                // the number of messages that were held back before this brush ended
+                size_t messageCount;
+            };
+
+            using PendingBrushList = std::vector<PendingBrush>;
+
+            /**
+             * A message that was held back while brushes were pending, so that it can be logged in file order together
+             * with the errors of the pending brushes.
+             */
+            struct HeldMessage {
+                Logger::LogLevel level;
+                String str;
+            };
+
+            using HeldMessageList = std::vector<HeldMessage>;
+
+            class HoldingStatus;
+
             vm::bbox3 m_worldBounds;
             Model::ModelFactory* m_factory;
 
@@ -81,6 +110,8 @@ namespace TrenchBroom {
             LayerMap m_layers;
             GroupMap m_groups;
             NodeParentList m_unresolvedNodes;
+            PendingBrushList m_pendingBrushes;
+            HeldMessageList m_heldMessages;
         protected:
             MapReader(const char* begin, const char* end);
             explicit MapReader(const String& str);
@@ -102,6 +133,9 @@ namespace TrenchBroom {
             void createGroup(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createEntity(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status);
+            void createPendingBrushes(ParserStatus& status);
+            void discardPendingBrushes(ParserStatus& status);
+            void logHeldMessages(HeldMessageList::const_iterator cur, HeldMessageList::const_iterator end, ParserStatus& status);
 
             ParentInfo::Type storeNode(Model::Node* node, const Model::EntityAttribute::List& attributes, ParserStatus& status);
             void stripParentAttributes(Model::AttributableNode* attributable, ParentInfo::Type parentType);
@@ -0,0 +1,68 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapTextSnapshot.h"
+
+#include "Exceptions.h"
+
+#include <utility>
+
+namespace TrenchBroom {
+    namespace IO {
+        MapTextSnapshot::MapTextSnapshot() :
+        m_size(0) {}
+
+        void MapTextSnapshot::append(String text) {
+            if (!text.empty()) {
+                append(std::make_shared<const String>(std::move(text)));
+            }
+        }
+
+        void MapTextSnapshot::append(const Segment& segment) {
+            if (segment != nullptr && !segment->empty()) {
+                m_segments.push_back(segment);
+                m_size += segment->size();
+            }
+        }
+
+        size_t MapTextSnapshot::size() const {
+            return m_size;
+        }
+
+        String MapTextSnapshot::str() const {
+            String result;
+            result.reserve(m_size);
+            for (const auto& segment : m_segments) {
+                result.append(*segment);
+            }
+            return result;
+        }
+
+        void MapTextSnapshot::writeTo(FILE* stream) const {
+            for (const auto& segment : m_segments) {
+                if (std::fwrite(segment->data(), 1, segment->size(), stream) != segment->size()) {
+                    throw FileSystemException("Could not write map file");
+                }
+            }
+            if (std::fflush(stream) != 0 || std::ferror(stream) != 0) {
+                throw FileSystemException("Could not write map file");
+            }
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapTextSnapshot
+#define TrenchBroom_MapTextSnapshot
+
+#include "StringType.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * The text of a map file as a sequence of immutable segments. The text of unchanged nodes is shared with
+         * their text caches instead of being copied, so taking a snapshot of a map is cheap, and the snapshot can be
+         * written to a file on another thread while the map is being edited.
+         */
+        class MapTextSnapshot {
+        public:
+            using Segment = std::shared_ptr<const String>;
+        private:
+            std::vector<Segment> m_segments;
+            size_t m_size;
+        public:
+            MapTextSnapshot();
+
+            void append(String text);
+            void append(const Segment& segment);
+
+            size_t size() const;
+            String str() const;
+
+            /**
+             * Writes the text to the given stream and flushes it.
+             *
+             * @throws FileSystemException if the text cannot be written
+             */
+            void writeTo(FILE* stream) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_MapTextSnapshot) */
@@ -116,5 +116,34 @@ namespace TrenchBroom {
                 return new Assets::Texture(name, 16, 16);
             }
         }
+
+        Assets::Texture* MipTextureReader::doReadTextureInfo(std::shared_ptr<File> file) const {
+            ensure(!file->path().isEmpty(), "MipTextureReader::doReadTextureInfo requires a path");
+
+            const auto path = file->path();
+            const auto basename = path.lastComponent().deleteExtension().asString();
+            const auto name = textureName(basename, path);
+            try {
+                // only the header is read, the palette and the mip levels are read when the texture is decoded
+                auto reader = file->reader();
+                reader.readString(MipLayout::TextureNameLength);
+
+                const auto width = reader.readSize<int32_t>();
+                const auto height = reader.readSize<int32_t>();
+
+                if (!checkTextureDimensions(width, height)) {
+                    return new Assets::Texture(name, 16, 16);
+                }
+
+                const auto masked = !name.empty() && name.at(0) == '{';
+                return new Assets::Texture(name, width, height, GL_RGBA, Assets::Texture::selectTextureType(masked));
+            } catch (const ReaderException&) {
+                return new Assets::Texture(name, 16, 16);
+            }
+        }
+
+        bool MipTextureReader::doCanReadConcurrently() const {
+            return true;
+        }
     }
 }
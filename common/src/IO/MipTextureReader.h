@@ -42,6 +42,8 @@ namespace TrenchBroom {
             static String getTextureName(const BufferedReader& reader);
         protected:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
+            Assets::Texture* doReadTextureInfo(std::shared_ptr<File> file) const override;
+            bool doCanReadConcurrently() const override;
             virtual Assets::Palette doGetPalette(Reader& reader, const size_t offset[], size_t width, size_t height) const = 0;
         };
     }
@@ -19,6 +19,7 @@
 
 #include "NodeReader.h"
 
+#include "CollectionUtils.h"
 #include "Model/Brush.h"
 #include "Model/Entity.h"
 #include "Model/Layer.h"
@@ -19,6 +19,7 @@
 
 #include "NodeSerializer.h"
 
+#include "StringUtils.h"
 #include "Model/Brush.h"
 #include "Model/Group.h"
 #include "Model/Layer.h"
@@ -93,7 +94,7 @@ namespace TrenchBroom {
 
         void NodeSerializer::beginEntity(const Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::EntityAttribute::List& extraAttributes) {
             beginEntity(node);
-            entityAttributes(attributes);
+            doEntityAttributes(node, attributes);
             entityAttributes(extraAttributes);
         }
 
@@ -116,6 +117,10 @@ namespace TrenchBroom {
             doEntityAttribute(attribute);
         }
 
+        void NodeSerializer::doEntityAttributes(const Model::Node* node, const Model::EntityAttribute::List& attributes) {
+            entityAttributes(attributes);
+        }
+
         void NodeSerializer::brushes(const Model::BrushList& brushes) {
             std::for_each(std::begin(brushes), std::end(brushes),
                           [this](Model::Brush* brush) { this->brush(brush); });
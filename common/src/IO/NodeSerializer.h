@@ -123,6 +123,12 @@ namespace TrenchBroom {
             virtual void doEndEntity(Model::Node* node) = 0;
             virtual void doEntityAttribute(const Model::EntityAttribute& attribute) = 0;
 
+            /**
+             * Writes the attributes of the given entity node. Unless this is overridden, every attribute is passed to
+             * doEntityAttribute.
+             */
+            virtual void doEntityAttributes(const Model::Node* node, const Model::EntityAttribute::List& attributes);
+
             virtual void doBeginBrush(const Model::Brush* brush) = 0;
             virtual void doEndBrush(Model::Brush* brush) = 0;
             virtual void doBrushFace(Model::BrushFace* face) = 0;
@@ -0,0 +1,47 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "NodeTextCache.h"
+
+#include <utility>
+
+namespace TrenchBroom {
+    namespace IO {
+        NodeTextCache::NodeTextCache() :
+        m_format(Model::MapFormat::Unknown) {}
+
+        std::shared_ptr<const String> NodeTextCache::get(const Model::MapFormat format) const {
+            if (m_format != format || m_format == Model::MapFormat::Unknown) {
+                return nullptr;
+            }
+            return m_text;
+        }
+
+        void NodeTextCache::set(const Model::MapFormat format, String text) {
+            m_format = format;
+            m_text = std::make_shared<const String>(std::move(text));
+        }
+
+        void NodeTextCache::invalidate() {
+            m_format = Model::MapFormat::Unknown;
+            m_text.reset();
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_NodeTextCache
+#define TrenchBroom_NodeTextCache
+
+#include "StringType.h"
+#include "Model/MapFormat.h"
+
+#include <memory>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Holds the text that a node was last written as by a map file serializer, so that an unchanged node can be
+         * written again without formatting it. The cache is owned by the node, which invalidates it whenever it
+         * changes.
+         *
+         * The text itself is immutable and shared, so that snapshots of a map can refer to it after the node has
+         * changed.
+         */
+        class NodeTextCache {
+        private:
+            Model::MapFormat m_format;
+            std::shared_ptr<const String> m_text;
+        public:
+            NodeTextCache();
+
+            /**
+             * Returns the cached text if it was written in the given format, and null otherwise.
+             */
+            std::shared_ptr<const String> get(Model::MapFormat format) const;
+            void set(Model::MapFormat format, String text);
+            void invalidate();
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_NodeTextCache) */
@@ -102,6 +102,10 @@ namespace TrenchBroom {
         m_world(world),
         m_serializer(MapFileSerializer::create(m_world.format(), stream)) {}
 
+        NodeWriter::NodeWriter(Model::World& world, MapTextSnapshot& snapshot) :
+        m_world(world),
+        m_serializer(MapFileSerializer::create(m_world.format(), snapshot)) {}
+
         NodeWriter::NodeWriter(Model::World& world, std::ostream& stream) :
         m_world(world),
         m_serializer(MapStreamSerializer::create(m_world.format(), stream)) {}
@@ -27,6 +27,7 @@
 
 namespace TrenchBroom {
     namespace IO {
+        class MapTextSnapshot;
         class Path;
         class NodeSerializer;
 
@@ -40,6 +41,7 @@ namespace TrenchBroom {
             NodeSerializer::Ptr m_serializer;
         public:
             NodeWriter(Model::World& world, FILE* stream);
+            NodeWriter(Model::World& world, MapTextSnapshot& snapshot);
             NodeWriter(Model::World& world, std::ostream& stream);
             NodeWriter(Model::World& world, NodeSerializer* serializer);
 
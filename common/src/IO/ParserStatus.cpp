@@ -30,6 +30,10 @@ namespace TrenchBroom {
 
         ParserStatus::~ParserStatus() {}
 
+        const String& ParserStatus::prefix() const {
+            return m_prefix;
+        }
+
         void ParserStatus::progress(const double progress) {
             assert(progress >= 0.0 && progress <= 1.0);
             doProgress(progress);
@@ -98,6 +102,10 @@ namespace TrenchBroom {
             throw ParserException(buildMessage(str));
         }
 
+        void ParserStatus::logFormatted(const Logger::LogLevel level, const String& message) {
+            doLog(level, message);
+        }
+
         void ParserStatus::log(const Logger::LogLevel level, const size_t line, const size_t column, const String& str) {
             doLog(level, buildMessage(line, column, str));
         }
@@ -34,6 +34,8 @@ namespace TrenchBroom {
         public:
             virtual ~ParserStatus();
         public:
+            const String& prefix() const;
+
             void progress(double progress);
 
             void debug(size_t line, size_t column, const String& str);
@@ -53,6 +55,12 @@ namespace TrenchBroom {
             void warn(const String& str);
             void error(const String& str);
             void errorAndThrow(const String& str);
+
+            /**
+             * Logs a message that has already been formatted by a parser status with the same prefix, e.g. one that
+             * recorded the messages of a parser running on another thread.
+             */
+            void logFormatted(Logger::LogLevel level, const String& message);
         private:
             void log(Logger::LogLevel level, size_t line, size_t column, const String& str);
             String buildMessage(size_t line, size_t column, const String& str) const;
@@ -70,10 +70,23 @@ namespace TrenchBroom {
             return texture;
         }
 
+        bool Quake3ShaderTextureReader::doCanReadConcurrently() const {
+            // access to the file system is serialized, but the images are decoded concurrently
+            return true;
+        }
+
         Assets::Texture* Quake3ShaderTextureReader::loadTextureImage(const Path& shaderPath, const Path& imagePath) const {
-            if (m_fs.fileExists(imagePath)) {
+            std::shared_ptr<File> imageFile;
+            {
+                std::lock_guard<std::mutex> lock(m_fsMutex);
+                if (m_fs.fileExists(imagePath)) {
+                    imageFile = concurrentlyReadableFile(m_fs.openFile(imagePath));
+                }
+            }
+
+            if (imageFile != nullptr) {
                 FreeImageTextureReader imageReader(StaticNameStrategy(textureName(shaderPath)));
-                return imageReader.readTexture(m_fs.openFile(imagePath));
+                return imageReader.readTexture(imageFile);
             } else {
                 return new Assets::Texture(textureName(shaderPath), 64, 64);
             }
@@ -102,6 +115,7 @@ namespace TrenchBroom {
         }
 
         Path Quake3ShaderTextureReader::findTexture(const Path& texturePath) const {
+            std::lock_guard<std::mutex> lock(m_fsMutex);
             if (!texturePath.isEmpty() && (texturePath.extension().empty() || !m_fs.fileExists(texturePath))) {
                 const auto candidates = m_fs.findItemsWithBaseName(texturePath, StringList { "tga", "png", "jpg", "jpeg"});
                 if (!candidates.empty()) {
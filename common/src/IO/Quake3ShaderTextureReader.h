@@ -23,6 +23,7 @@
 #include "IO/TextureReader.h"
 
 #include <memory>
+#include <mutex>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -42,6 +43,7 @@ namespace TrenchBroom {
         class Quake3ShaderTextureReader : public TextureReader {
         private:
             const FileSystem& m_fs;
+            mutable std::mutex m_fsMutex;
         public:
             /**
              * Creates a texture reader using the given name strategy and file system to locate the texture image.
@@ -52,6 +54,7 @@ namespace TrenchBroom {
             Quake3ShaderTextureReader(const NameStrategy& nameStrategy, const FileSystem& fs);
         private:
             Assets::Texture* doReadTexture(std::shared_ptr<File> file) const override;
+            bool doCanReadConcurrently() const override;
             Assets::Texture* loadTextureImage(const Path& shaderPath, const Path& imagePath) const;
             Path findTexturePath(const Assets::Quake3Shader& shader) const;
             Path findTexture(const Path& texturePath) const;
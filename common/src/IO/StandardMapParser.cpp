@@ -19,12 +19,18 @@
 
 #include "StandardMapParser.h"
 
+#include "Logger.h"
+#include "Macros.h"
+#include "ParallelUtils.h"
 #include "TemporarilySetAny.h"
+#include "IO/ParserStatus.h"
 #include "Model/BrushFace.h"
 
 #include <vecmath/plane.h>
 #include <vecmath/vec.h>
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace IO {
         const String& QuakeMapTokenizer::NumberDelim() {
@@ -128,13 +134,299 @@ namespace TrenchBroom {
         const String StandardMapParser::BrushPrimitiveId = "brushDef";
         const String StandardMapParser::PatchId = "patchDef2";
 
+        /**
+         * Parses a range of consecutive brushes of one entity on a worker thread. The parser callbacks and messages
+         * are recorded instead of being passed on, and they are replayed on the main thread when the main parser
+         * reaches the beginning of the range. This way, the brushes are reported in file order and the messages are
+         * the same as if the brushes had been parsed by the main parser.
+         *
+         * The callbacks are recorded as plain records in a few flat lists, so that recording a face does not
+         * allocate memory of its own.
+         */
+        class StandardMapParser::ChunkParser : public StandardMapParser {
+        public:
+            struct Range {
+                const char* begin;
+                const char* end;
+                size_t line;
+                size_t column;
+                size_t group;
+            };
+            using RangeList = std::vector<Range>;
+        private:
+            enum class EventType {
+                BeginBrush,
+                EndBrush,
+                BrushFace,
+                Log
+            };
+
+            /**
+             * A recorded callback. Depending on the type, the index refers to the recorded faces, extra attributes or
+             * messages.
+             */
+            struct Event {
+                EventType type;
+                size_t line;
+                size_t lineCount;
+                size_t index;
+            };
+            using EventList = std::vector<Event>;
+
+            struct Face {
+                vm::vec3 point1;
+                vm::vec3 point2;
+                vm::vec3 point3;
+                Model::BrushFaceAttributes attribs;
+                vm::vec3 texAxisX;
+                vm::vec3 texAxisY;
+            };
+            using FaceList = std::vector<Face>;
+
+            struct Message {
+                Logger::LogLevel level;
+                String str;
+            };
+            using MessageList = std::vector<Message>;
+
+            static const size_t NoIndex = static_cast<size_t>(-1);
+
+            class RecordingStatus : public ParserStatus {
+            private:
+                ChunkParser& m_parser;
+            public:
+                RecordingStatus(ChunkParser& parser, const String& prefix) :
+                ParserStatus(nullLogger(), prefix),
+                m_parser(parser) {}
+            private:
+                static Logger& nullLogger() {
+                    static NullLogger logger;
+                    return logger;
+                }
+
+                void doProgress(const double progress) override {}
+
+                void doLog(const Logger::LogLevel level, const String& str) override {
+                    m_parser.m_events.push_back(Event { EventType::Log, 0, 0, m_parser.m_messages.size() });
+                    m_parser.m_messages.push_back(Message { level, str });
+                }
+            };
+
+            const char* m_begin;
+            const char* m_end;
+            size_t m_line;
+            size_t m_column;
+
+            EventList m_events;
+            FaceList m_faces;
+            std::vector<ExtraAttributes> m_extraAttributes;
+            MessageList m_messages;
+            bool m_success;
+            size_t m_endLine;
+            size_t m_endColumn;
+        public:
+            ChunkParser(const char* begin, const char* end, const Range& first, const Range& last) :
+            StandardMapParser(begin, end),
+            m_begin(first.begin),
+            m_end(last.end),
+            m_line(first.line),
+            m_column(first.column),
+            m_success(false),
+            m_endLine(0),
+            m_endColumn(0) {}
+
+            /**
+             * Finds the ranges of all brushes, brush primitives and patches in the given map file. Only braces that
+             * are surrounded by whitespace are considered, and since the results are checked when parsing the
+             * ranges, this need not be exact. Consecutive brushes of the same entity have the same group.
+             */
+            static RangeList findBrushes(const char* begin, const char* end) {
+                const auto isSpace = [begin, end](const char* c) {
+                    return c < begin || c >= end || *c == ' ' || *c == '\t' || *c == '\n' || *c == '\r';
+                };
+
+                auto result = RangeList();
+                auto current = Range { nullptr, nullptr, 0, 0, 0 };
+                size_t group = 0;
+                size_t depth = 0;
+                size_t line = 1;
+                size_t column = 1;
+
+                const auto* c = begin;
+                const auto advance = [&]() {
+                    if (*c == '\n' || (*c == '\r' && (c + 1 == end || *(c + 1) != '\n'))) {
+                        ++line;
+                        column = 1;
+                    } else {
+                        ++column;
+                    }
+                    ++c;
+                };
+
+                while (c < end) {
+                    if (*c == '/' && c + 1 < end && *(c + 1) == '/' && isSpace(c - 1)) {
+                        // extra attributes between brushes belong to the entity
+                        if (depth == 1 && c + 3 < end && *(c + 2) == '/' && *(c + 3) == ' ') {
+                            ++group;
+                        }
+                        while (c < end && *c != '\n' && *c != '\r') {
+                            advance();
+                        }
+                    } else if (*c == '"' && depth == 1 && isSpace(c - 1)) {
+                        advance();
+                        auto escaped = false;
+                        while (c < end) {
+                            if (*c == '"' && (!escaped || (c + 1 < end && (*(c + 1) == '\n' || *(c + 1) == '}')))) {
+                                break;
+                            }
+                            escaped = *c == '\\' ? !escaped : false;
+                            if (*c == '\n' || *c == '\r') {
+                                escaped = false;
+                            }
+                            advance();
+                        }
+                        if (c < end) {
+                            advance();
+                        }
+                    } else if ((*c == '{' || *c == '}') && isSpace(c - 1) && isSpace(c + 1)) {
+                        if (*c == '{') {
+                            if (depth == 1) {
+                                current = Range { c, nullptr, line, column, group };
+                            }
+                            ++depth;
+                        } else {
+                            if (depth == 0) {
+                                // unbalanced braces, leave it to the main parser
+                                return RangeList();
+                            }
+                            --depth;
+                            if (depth == 1) {
+                                current.end = c + 1;
+                                result.push_back(current);
+                            } else if (depth == 0) {
+                                ++group;
+                            }
+                        }
+                        advance();
+                    } else {
+                        advance();
+                    }
+                }
+                return result;
+            }
+
+            const char* begin() const {
+                return m_begin;
+            }
+
+            /**
+             * Indicates whether the brushes of this chunk were parsed successfully and whether they start at the
+             * given token, which also verifies the line and column numbers found by findBrushes.
+             */
+            bool matches(const Token& token) const {
+                return m_success && token.begin() == m_begin && token.line() == m_line && token.column() == m_column;
+            }
+
+            void parse(const Model::MapFormat format, const String& statusPrefix) {
+                RecordingStatus status(*this, statusPrefix);
+                try {
+                    setFormat(format);
+                    m_tokenizer.seek(m_begin, m_line, m_column);
+                    while (m_tokenizer.snapshot().curPos() < m_end) {
+                        expect(QuakeMapToken::OBrace, m_tokenizer.peekToken());
+                        parseBrushOrBrushPrimitiveOrPatch(status);
+                    }
+
+                    m_success = m_tokenizer.snapshot().curPos() == m_end;
+                    m_endLine = m_tokenizer.line();
+                    m_endColumn = m_tokenizer.column();
+                } catch (const Exception&) {
+                    // the main parser will parse these brushes again and report the error
+                    m_success = false;
+                }
+
+                if (!m_success) {
+                    m_events.clear();
+                    m_faces.clear();
+                    m_extraAttributes.clear();
+                    m_messages.clear();
+                }
+            }
+
+            /**
+             * Replays the recorded events to the given parser and moves its tokenizer past the parsed brushes.
+             */
+            void replay(StandardMapParser& target, ParserStatus& status) {
+                assert(m_success);
+                static const ExtraAttributes NoExtraAttributes;
+
+                for (const auto& event : m_events) {
+                    switch (event.type) {
+                        case EventType::BeginBrush:
+                            target.beginBrush(event.line, status);
+                            break;
+                        case EventType::EndBrush: {
+                            const auto& extraAttributes = event.index == NoIndex ? NoExtraAttributes : m_extraAttributes[event.index];
+                            target.endBrush(event.line, event.lineCount, extraAttributes, status);
+                            break;
+                        }
+                        case EventType::BrushFace: {
+                            const auto& face = m_faces[event.index];
+                            target.brushFace(event.line, face.point1, face.point2, face.point3, face.attribs, face.texAxisX, face.texAxisY, status);
+                            break;
+                        }
+                        case EventType::Log: {
+                            const auto& message = m_messages[event.index];
+                            status.logFormatted(message.level, message.str);
+                            break;
+                        }
+                        switchDefault()
+                    }
+                }
+                target.m_tokenizer.seek(m_end, m_endLine, m_endColumn);
+            }
+        private:
+            void onFormatSet(const Model::MapFormat format) override {}
+
+            void onBeginEntity(const size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status) override {
+                // chunks contain brushes only
+                assert(false);
+            }
+
+            void onEndEntity(const size_t startLine, const size_t lineCount, ParserStatus& status) override {
+                assert(false);
+            }
+
+            void onBeginBrush(const size_t line, ParserStatus& status) override {
+                m_events.push_back(Event { EventType::BeginBrush, line, 0, NoIndex });
+            }
+
+            void onEndBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) override {
+                auto index = NoIndex;
+                if (!extraAttributes.empty()) {
+                    index = m_extraAttributes.size();
+                    m_extraAttributes.push_back(extraAttributes);
+                }
+                m_events.push_back(Event { EventType::EndBrush, startLine, lineCount, index });
+            }
+
+            void onBrushFace(const size_t line, const vm::vec3& point1, const vm::vec3& point2, const vm::vec3& point3, const Model::BrushFaceAttributes& attribs, const vm::vec3& texAxisX, const vm::vec3& texAxisY, ParserStatus& status) override {
+                m_events.push_back(Event { EventType::BrushFace, line, 0, m_faces.size() });
+                m_faces.push_back(Face { point1, point2, point3, attribs, texAxisX, texAxisY });
+            }
+        };
+
         StandardMapParser::StandardMapParser(const char* begin, const char* end) :
         m_tokenizer(QuakeMapTokenizer(begin, end)),
-        m_format(Model::MapFormat::Unknown) {}
+        m_format(Model::MapFormat::Unknown),
+        m_nextChunk(0),
+        m_parsedChunks(0) {}
 
         StandardMapParser::StandardMapParser(const String& str) :
         m_tokenizer(QuakeMapTokenizer(str)),
-        m_format(Model::MapFormat::Unknown) {}
+        m_format(Model::MapFormat::Unknown),
+        m_nextChunk(0),
+        m_parsedChunks(0) {}
 
         StandardMapParser::~StandardMapParser() {}
 
@@ -193,6 +485,7 @@ namespace TrenchBroom {
 
         void StandardMapParser::parseEntities(const Model::MapFormat format, ParserStatus& status) {
             setFormat(format);
+            findChunks();
 
             auto token = m_tokenizer.peekToken();
             while (token.type() != QuakeMapToken::Eof) {
@@ -200,6 +493,10 @@ namespace TrenchBroom {
                 parseEntity(status);
                 token = m_tokenizer.peekToken();
             }
+
+            m_chunks.clear();
+            m_nextChunk = 0;
+            m_parsedChunks = 0;
         }
 
         void StandardMapParser::parseBrushes(const Model::MapFormat format, ParserStatus& status) {
@@ -235,6 +532,74 @@ namespace TrenchBroom {
             formatSet(format);
         }
 
+        void StandardMapParser::findChunks() {
+            static const size_t MinBrushCount = 1024;
+            static const size_t MinChunkSize = 64;
+
+            m_chunks.clear();
+            m_nextChunk = 0;
+            m_parsedChunks = 0;
+
+            const auto workerCount = ParallelUtils::workerCount();
+            if (workerCount < 2) {
+                return;
+            }
+
+            const auto state = m_tokenizer.snapshot();
+            if (state.curPos() != state.begin()) {
+                return;
+            }
+
+            const auto brushes = ChunkParser::findBrushes(state.begin(), state.end());
+            if (brushes.size() < MinBrushCount) {
+                return;
+            }
+
+            // the worldspawn entity usually contains most brushes, so the chunks are split at brush boundaries
+            const auto chunkSize = std::max(MinChunkSize, brushes.size() / (workerCount * 8));
+            size_t first = 0;
+            for (size_t i = 1; i <= brushes.size(); ++i) {
+                if (i == brushes.size() || brushes[i].group != brushes[first].group || i - first == chunkSize) {
+                    m_chunks.push_back(std::make_unique<ChunkParser>(state.begin(), state.end(), brushes[first], brushes[i - 1]));
+                    first = i;
+                }
+            }
+
+            // the chunks are parsed shortly before they are replayed, see replayChunk
+        }
+
+        void StandardMapParser::parseNextChunks(ParserStatus& status) {
+            // only a few chunks are parsed ahead of the main parser to limit the memory taken by recorded brushes
+            const auto first = m_nextChunk;
+            const auto count = std::min(2u * ParallelUtils::workerCount(), m_chunks.size() - first);
+            const auto& prefix = status.prefix();
+            ParallelUtils::parallelFor(count, [&](const size_t i) {
+                m_chunks[first + i]->parse(m_format, prefix);
+            });
+            m_parsedChunks = first + count;
+        }
+
+        bool StandardMapParser::replayChunk(const Token& token, ParserStatus& status) {
+            const auto* position = std::begin(token);
+            while (m_nextChunk < m_chunks.size() && m_chunks[m_nextChunk]->begin() < position) {
+                m_chunks[m_nextChunk++].reset();
+            }
+
+            if (m_nextChunk == m_chunks.size()) {
+                return false;
+            }
+            if (m_nextChunk >= m_parsedChunks) {
+                parseNextChunks(status);
+            }
+            if (!m_chunks[m_nextChunk]->matches(token)) {
+                return false;
+            }
+
+            auto chunk = std::move(m_chunks[m_nextChunk++]);
+            chunk->replay(*this, status);
+            return true;
+        }
+
         void StandardMapParser::parseEntity(ParserStatus& status) {
             Token token = m_tokenizer.nextToken();
             if (token.type() == QuakeMapToken::Eof) {
@@ -246,7 +611,6 @@ namespace TrenchBroom {
             auto beginEntityCalled = false;
 
             auto attributes = Model::EntityAttribute::List();
-            auto attributeNames = AttributeNames();
 
             auto extraAttributes = ExtraAttributes();
             const auto startLine = token.line();
@@ -259,14 +623,16 @@ namespace TrenchBroom {
                         parseExtraAttributes(extraAttributes, status);
                         break;
                     case QuakeMapToken::String:
-                        parseEntityAttribute(attributes, attributeNames, status);
+                        parseEntityAttribute(attributes, status);
                         break;
                     case QuakeMapToken::OBrace:
                         if (!beginEntityCalled) {
                             beginEntity(startLine, attributes, extraAttributes, status);
                             beginEntityCalled = true;
                         }
-                        parseBrushOrBrushPrimitiveOrPatch(status);
+                        if (!replayChunk(token, status)) {
+                            parseBrushOrBrushPrimitiveOrPatch(status);
+                        }
                         break;
                     case QuakeMapToken::CBrace:
                         m_tokenizer.nextToken();
@@ -283,7 +649,7 @@ namespace TrenchBroom {
             }
         }
 
-        void StandardMapParser::parseEntityAttribute(Model::EntityAttribute::List& attributes, AttributeNames& names, ParserStatus& status) {
+        void StandardMapParser::parseEntityAttribute(Model::EntityAttribute::List& attributes, ParserStatus& status) {
             auto token = m_tokenizer.nextToken();
             assert(token.type() == QuakeMapToken::String);
             const auto name = token.data();
@@ -294,9 +660,12 @@ namespace TrenchBroom {
             expect(QuakeMapToken::String, token = m_tokenizer.nextToken());
             const auto value = token.data();
 
-            if (names.count(name) == 0) {
+            // entities have few attributes, so a linear search is cheaper than a set of the names seen so far
+            const auto isDuplicate = std::any_of(std::begin(attributes), std::end(attributes), [&](const Model::EntityAttribute& attribute) {
+                return attribute.name() == name;
+            });
+            if (!isDuplicate) {
                 attributes.push_back(Model::EntityAttribute(name, value, nullptr));
-                names.insert(name);
             } else {
                 status.warn(line, column, "Ignoring duplicate entity property '" + name + "'");
             }
@@ -29,7 +29,9 @@
 
 #include <vecmath/forward.h>
 
+#include <memory>
 #include <tuple>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
@@ -68,13 +70,18 @@ namespace TrenchBroom {
         class StandardMapParser : public MapParser, public Parser<QuakeMapToken::Type> {
         private:
             using Token = QuakeMapTokenizer::Token;
-            using AttributeNames = std::set<Model::AttributeName>;
 
             static const String BrushPrimitiveId;
             static const String PatchId;
 
             QuakeMapTokenizer m_tokenizer;
             Model::MapFormat m_format;
+
+            class ChunkParser;
+            using ChunkParserList = std::vector<std::unique_ptr<ChunkParser>>;
+            ChunkParserList m_chunks;
+            size_t m_nextChunk;
+            size_t m_parsedChunks;
         public:
             StandardMapParser(const char* begin, const char* end);
             StandardMapParser(const String& str);
@@ -91,8 +98,12 @@ namespace TrenchBroom {
         private:
             void setFormat(Model::MapFormat format);
 
+            void findChunks();
+            void parseNextChunks(ParserStatus& status);
+            bool replayChunk(const Token& token, ParserStatus& status);
+
             void parseEntity(ParserStatus& status);
-            void parseEntityAttribute(Model::EntityAttribute::List& attributes, AttributeNames& names, ParserStatus& status);
+            void parseEntityAttribute(Model::EntityAttribute::List& attributes, ParserStatus& status);
 
             void parseBrushOrBrushPrimitiveOrPatch(ParserStatus& status);
             void parseBrushPrimitive(ParserStatus& status, size_t startLine);
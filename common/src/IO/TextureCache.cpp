@@ -0,0 +1,382 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureCache.h"
+
+#include "Exceptions.h"
+#include "Logger.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileMatcher.h"
+#include "IO/Reader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const String CacheFileMagic = "TBTC";
+        static const uint32_t CacheFileVersion = 2;
+        static const std::streamoff LastUsePosition = 16;
+        static const std::streamoff HeaderSize = 40;
+
+        static uint64_t hashBytes(uint64_t hash, const char* begin, const char* end) {
+            // 64 bit FNV-1a
+            for (auto* cur = begin; cur != end; ++cur) {
+                hash ^= static_cast<unsigned char>(*cur);
+                hash *= 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+        template <typename T>
+        static uint64_t hashValue(const uint64_t hash, const T value) {
+            return hashBytes(hash, reinterpret_cast<const char*>(&value), reinterpret_cast<const char*>(&value) + sizeof(T));
+        }
+
+        template <typename T>
+        static void writeValue(std::ostream& stream, const T value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template <typename T>
+        static T readValue(std::istream& stream) {
+            auto value = T();
+            stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+            return value;
+        }
+
+        static uint64_t currentTime() {
+            const auto now = std::chrono::system_clock::now().time_since_epoch();
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+        }
+
+        static bool readHeader(std::istream& stream) {
+            auto magic = String(CacheFileMagic.size(), '\0');
+            stream.read(&magic[0], static_cast<std::streamsize>(magic.size()));
+            const auto version = readValue<uint32_t>(stream);
+            return stream.good() && magic == CacheFileMagic && version == CacheFileVersion;
+        }
+
+        static bool isPhysicalFile(const File& file) {
+            return dynamic_cast<const CFile*>(&file) != nullptr || dynamic_cast<const MappedFile*>(&file) != nullptr;
+        }
+
+        static uint64_t hashPhysicalFile(uint64_t hash, const File& file) {
+            const auto path = file.path().makeCanonical().asString();
+            hash = hashBytes(hash, path.data(), path.data() + path.size());
+            hash = hashValue(hash, Disk::fileModificationTime(file.path()));
+            hash = hashValue(hash, static_cast<uint64_t>(file.size()));
+            return hash;
+        }
+
+        TextureCache::TextureCache(const Path& path, Logger& logger) :
+        m_path(path),
+        m_logger(logger),
+        m_id(0) {
+            if (Disk::fileExists(m_path)) {
+                markUsed();
+                read();
+            }
+        }
+
+        TextureCache::Key TextureCache::key(const File& file, const uint64_t signature) {
+            try {
+                auto hash = 0xcbf29ce484222325ull;
+                if (isPhysicalFile(file)) {
+                    hash = hashPhysicalFile(hash, file);
+                    return hashValue(hash, signature);
+                }
+
+                const auto* fileView = dynamic_cast<const FileView*>(&file);
+                if (fileView != nullptr && isPhysicalFile(*fileView->hostFile())) {
+                    const auto path = file.path().asString();
+                    hash = hashPhysicalFile(hash, *fileView->hostFile());
+                    hash = hashBytes(hash, path.data(), path.data() + path.size());
+                    hash = hashValue(hash, static_cast<uint64_t>(fileView->offset()));
+                    hash = hashValue(hash, static_cast<uint64_t>(fileView->size()));
+                    return hashValue(hash, signature);
+                }
+            } catch (const FileSystemException&) {
+                // the physical file cannot be found by its path, so the contents are hashed instead
+            }
+
+            return contentKey(file, signature);
+        }
+
+        TextureCache::Key TextureCache::contentKey(const File& file, const uint64_t signature) {
+            const auto path = file.path().asString();
+            const auto contents = file.reader().buffer();
+
+            auto hash = 0xcbf29ce484222325ull;
+            hash = hashBytes(hash, path.data(), path.data() + path.size());
+            hash = hashBytes(hash, contents.begin(), contents.end());
+            hash = hashValue(hash, signature);
+            return hash;
+        }
+
+        TextureCache::Key TextureCache::key(const String& str, const uint64_t signature) {
+            auto hash = 0xcbf29ce484222325ull;
+            hash = hashBytes(hash, str.data(), str.data() + str.size());
+            hash = hashValue(hash, signature);
+            return hash;
+        }
+
+        void TextureCache::prune(const Path& directory, const size_t maxSize, Logger& logger) {
+            struct CacheFile {
+                Path path;
+                uint64_t lastUse;
+                size_t size;
+            };
+
+            auto cacheFiles = std::vector<CacheFile>();
+            auto totalSize = size_t(0);
+            for (const auto& path : Disk::findItems(directory, FileExtensionMatcher("tbtc"))) {
+                std::ifstream stream(path.asString(), std::ios::in | std::ios::binary);
+                stream.seekg(0, std::ios::end);
+                const auto size = static_cast<size_t>(std::max(std::streamoff(0), static_cast<std::streamoff>(stream.tellg())));
+                stream.seekg(0, std::ios::beg);
+
+                // invalid files are deleted first
+                auto lastUse = uint64_t(0);
+                if (readHeader(stream)) {
+                    stream.seekg(LastUsePosition);
+                    lastUse = readValue<uint64_t>(stream);
+                }
+
+                cacheFiles.push_back(CacheFile{ path, stream.good() ? lastUse : 0u, size });
+                totalSize += size;
+            }
+
+            std::sort(std::begin(cacheFiles), std::end(cacheFiles), [](const CacheFile& lhs, const CacheFile& rhs) {
+                return lhs.lastUse < rhs.lastUse;
+            });
+
+            for (size_t i = 0; i + 1 < cacheFiles.size() && totalSize > maxSize; ++i) {
+                try {
+                    Disk::deleteFile(cacheFiles[i].path);
+                    totalSize -= cacheFiles[i].size;
+                } catch (const FileSystemException& e) {
+                    logger.warn() << "Could not delete texture cache file '" << cacheFiles[i].path << "': " << e.what();
+                }
+            }
+        }
+
+        size_t TextureCache::size() const {
+            return m_entries.size();
+        }
+
+        bool TextureCache::contains(const Key key) const {
+            return m_entries.count(key) > 0;
+        }
+
+        Assets::Texture* TextureCache::readTexture(const Key key) const {
+            const auto it = m_entries.find(key);
+            if (it == std::end(m_entries)) {
+                return nullptr;
+            }
+
+            // the texture doesn't keep the cache file open, so that the file can be replaced while the texture exists
+            const auto& entry = it->second;
+            auto* texture = new Assets::Texture(entry.name, entry.width, entry.height, entry.averageColor, Assets::TextureBuffer::List(), entry.format, entry.type);
+            texture->setBufferSource([path = m_path, id = m_id, mipLevels = entry.mipLevels]() {
+                auto result = Assets::TextureBuffer::List();
+                try {
+                    auto file = CFile(path);
+                    auto reader = file.reader();
+                    if (reader.readString(CacheFileMagic.size()) != CacheFileMagic || reader.readUnsignedInt<uint32_t>() != CacheFileVersion || reader.read<uint64_t, uint64_t>() != id) {
+                        return result;
+                    }
+
+                    for (const auto& mipLevel : mipLevels) {
+                        auto buffer = Assets::TextureBuffer(mipLevel.size);
+                        reader.seekFromBegin(mipLevel.offset);
+                        reader.read(buffer.ptr(), mipLevel.size);
+                        result.push_back(buffer);
+                    }
+                } catch (const Exception&) {
+                    result.clear();
+                }
+                return result;
+            });
+            return texture;
+        }
+
+        void TextureCache::write(const std::vector<std::pair<Key, const Assets::Texture*>>& textures) {
+            Disk::ensureDirectoryExists(m_path.deleteLastComponent());
+
+            const auto tempPath = m_path.replaceExtension("tmp");
+            {
+                std::ofstream stream(tempPath.asString(), std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!stream.good()) {
+                    throw FileSystemException("Cannot open file: " + tempPath.asString());
+                }
+
+                stream.write(CacheFileMagic.data(), static_cast<std::streamsize>(CacheFileMagic.size()));
+                writeValue<uint32_t>(stream, CacheFileVersion);
+
+                // the id lets the cached textures detect that the file was replaced
+                const auto time = currentTime();
+                writeValue<uint64_t>(stream, key(m_path.asString(), time));
+                writeValue<uint64_t>(stream, time);
+
+                // the entry count and the index offset are written once the data is written
+                const auto headerPosition = stream.tellp();
+                writeValue<uint64_t>(stream, 0u);
+                writeValue<uint64_t>(stream, 0u);
+
+                auto entries = std::vector<std::pair<Key, Entry>>();
+                entries.reserve(textures.size());
+
+                for (const auto& [key, texture] : textures) {
+                    const auto cached = m_entries.find(key);
+                    if (texture == nullptr) {
+                        if (cached == std::end(m_entries)) {
+                            continue;
+                        }
+
+                        auto entry = cached->second;
+                        entry.mipLevels.clear();
+
+                        auto reader = m_file->reader();
+                        for (const auto& mipLevel : cached->second.mipLevels) {
+                            auto buffer = std::vector<char>(mipLevel.size);
+                            reader.seekFromBegin(mipLevel.offset);
+                            reader.read(buffer.data(), buffer.size());
+
+                            entry.mipLevels.push_back(MipLevel{ static_cast<size_t>(stream.tellp()), buffer.size() });
+                            stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                        }
+                        entries.emplace_back(key, std::move(entry));
+                    } else {
+                        // textures without buffers could not be decoded and are cached as placeholders
+                        auto entry = Entry{ texture->name(), texture->width(), texture->height(), texture->averageColor(), texture->format(), texture->type(), {} };
+                        for (const auto& buffer : texture->buffersIfUnprepared()) {
+                            entry.mipLevels.push_back(MipLevel{ static_cast<size_t>(stream.tellp()), buffer.size() });
+                            stream.write(reinterpret_cast<const char*>(buffer.ptr()), static_cast<std::streamsize>(buffer.size()));
+                        }
+                        entries.emplace_back(key, std::move(entry));
+                    }
+                }
+
+                const auto indexPosition = stream.tellp();
+                for (const auto& [key, entry] : entries) {
+                    writeValue<uint64_t>(stream, key);
+                    writeValue<uint32_t>(stream, static_cast<uint32_t>(entry.name.size()));
+                    stream.write(entry.name.data(), static_cast<std::streamsize>(entry.name.size()));
+                    writeValue<uint64_t>(stream, entry.width);
+                    writeValue<uint64_t>(stream, entry.height);
+                    for (size_t i = 0; i < 4; ++i) {
+                        writeValue<float>(stream, entry.averageColor[i]);
+                    }
+                    writeValue<uint32_t>(stream, static_cast<uint32_t>(entry.format));
+                    writeValue<uint32_t>(stream, entry.type == Assets::TextureType::Masked ? 1u : 0u);
+                    writeValue<uint32_t>(stream, static_cast<uint32_t>(entry.mipLevels.size()));
+                    for (const auto& mipLevel : entry.mipLevels) {
+                        writeValue<uint64_t>(stream, mipLevel.offset);
+                        writeValue<uint64_t>(stream, mipLevel.size);
+                    }
+                }
+
+                stream.seekp(headerPosition);
+                writeValue<uint64_t>(stream, entries.size());
+                writeValue<uint64_t>(stream, static_cast<uint64_t>(indexPosition));
+
+                if (!stream.good()) {
+                    throw FileSystemException("Cannot write file: " + tempPath.asString());
+                }
+            }
+
+            // a mapped file cannot be replaced on Windows, so the old file is unmapped first
+            m_file = nullptr;
+            m_entries.clear();
+            try {
+                Disk::moveFile(tempPath, m_path, true);
+            } catch (const FileSystemException&) {
+                read();
+                throw;
+            }
+            read();
+        }
+
+        void TextureCache::markUsed() {
+            std::fstream stream(m_path.asString(), std::ios::in | std::ios::out | std::ios::binary);
+            if (readHeader(stream)) {
+                stream.seekp(LastUsePosition);
+                writeValue<uint64_t>(stream, currentTime());
+            }
+        }
+
+        void TextureCache::read() {
+            try {
+                m_file = Disk::openFile(m_path);
+                if (m_file->size() < static_cast<size_t>(HeaderSize)) {
+                    m_file = nullptr;
+                    return;
+                }
+
+                auto reader = m_file->reader();
+                if (reader.readString(CacheFileMagic.size()) != CacheFileMagic || reader.readUnsignedInt<uint32_t>() != CacheFileVersion) {
+                    m_file = nullptr;
+                    return;
+                }
+
+                m_id = reader.read<uint64_t, uint64_t>();
+                reader.read<uint64_t, uint64_t>(); // the time of the last use
+
+                const auto entryCount = reader.readSize<uint64_t>();
+                const auto indexPosition = reader.readSize<uint64_t>();
+                reader.seekFromBegin(indexPosition);
+
+                for (size_t i = 0; i < entryCount; ++i) {
+                    const auto key = static_cast<Key>(reader.readSize<uint64_t>());
+
+                    auto entry = Entry();
+                    entry.name = reader.readString(reader.readSize<uint32_t>());
+                    entry.width = reader.readSize<uint64_t>();
+                    entry.height = reader.readSize<uint64_t>();
+                    const auto r = reader.readFloat<float>();
+                    const auto g = reader.readFloat<float>();
+                    const auto b = reader.readFloat<float>();
+                    const auto a = reader.readFloat<float>();
+                    entry.averageColor = Color(r, g, b, a);
+                    entry.format = static_cast<GLenum>(reader.readUnsignedInt<uint32_t>());
+                    entry.type = reader.readUnsignedInt<uint32_t>() == 1u ? Assets::TextureType::Masked : Assets::TextureType::Opaque;
+
+                    const auto mipLevelCount = reader.readSize<uint32_t>();
+                    for (size_t j = 0; j < mipLevelCount; ++j) {
+                        const auto offset = reader.readSize<uint64_t>();
+                        const auto size = reader.readSize<uint64_t>();
+                        if (offset + size > m_file->size()) {
+                            throw ReaderException("mip level exceeds the cache file");
+                        }
+                        entry.mipLevels.push_back(MipLevel{ offset, size });
+                    }
+
+                    m_entries[key] = std::move(entry);
+                }
+            } catch (const Exception& e) {
+                m_logger.warn() << "Ignoring invalid texture cache file '" << m_path << "': " << e.what();
+                m_entries.clear();
+                m_file = nullptr;
+            }
+        }
+    }
+}
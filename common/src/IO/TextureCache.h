@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_TextureCache
+#define TrenchBroom_TextureCache
+
+#include "Color.h"
+#include "StringType.h"
+#include "Assets/Texture.h"
+#include "IO/Path.h"
+#include "Renderer/GL.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    class Logger;
+
+    namespace IO {
+        class File;
+
+        /**
+         * Stores the decoded mip levels of the textures of a texture collection in a file on disk, so that the textures
+         * don't have to be decoded again when the collection is loaded the next time. The pixel data of a cached
+         * texture is only read from the cache file when the texture is uploaded.
+         *
+         * Every texture is identified by a key that is computed from the location of the file that the texture was
+         * decoded from, and from a signature of the texture reader. Every cache file records when it was last used, so
+         * that the least recently used cache files can be pruned.
+         */
+        class TextureCache {
+        public:
+            using Key = uint64_t;
+        private:
+            struct MipLevel {
+                size_t offset;
+                size_t size;
+            };
+
+            struct Entry {
+                String name;
+                size_t width;
+                size_t height;
+                Color averageColor;
+                GLenum format;
+                Assets::TextureType type;
+                std::vector<MipLevel> mipLevels;
+            };
+
+            Path m_path;
+            Logger& m_logger;
+            uint64_t m_id;
+            std::shared_ptr<File> m_file;
+            std::map<Key, Entry> m_entries;
+        public:
+            /**
+             * Opens the cache file at the given path and marks it as used. If the file does not exist or cannot be
+             * read, the cache is empty.
+             *
+             * @param path the path of the cache file
+             * @param logger the logger to report invalid cache files to
+             */
+            TextureCache(const Path& path, Logger& logger);
+
+            /**
+             * Computes the key of the texture that is decoded from the given file. If the file is a physical file or a
+             * view of a physical file, the key is computed from the canonical path, the modification time and the size
+             * of the physical file and from the location of the view. Otherwise, it is computed from the path and the
+             * contents of the given file.
+             *
+             * @param file the texture file
+             * @param signature a value that identifies the texture reader and its settings
+             * @return the key
+             */
+            static Key key(const File& file, uint64_t signature);
+
+            /**
+             * Computes a key from the path and the contents of the given file.
+             *
+             * @param file the file
+             * @param signature a value that is combined with the file
+             * @return the key
+             */
+            static Key contentKey(const File& file, uint64_t signature);
+
+            /**
+             * Computes a key from the given string.
+             *
+             * @param str the string
+             * @param signature a value that is combined with the string
+             * @return the key
+             */
+            static Key key(const String& str, uint64_t signature);
+
+            /**
+             * Deletes the least recently used cache files in the given directory until the total size of the cache
+             * files does not exceed the given size. The most recently used cache file is never deleted.
+             *
+             * @param directory the directory that contains the cache files
+             * @param maxSize the maximum total size of the cache files in bytes
+             * @param logger the logger to report files that cannot be deleted to
+             */
+            static void prune(const Path& directory, size_t maxSize, Logger& logger);
+
+            size_t size() const;
+            bool contains(Key key) const;
+
+            /**
+             * Creates a texture from the cache entry with the given key. The returned texture holds no pixel data, it
+             * reads its mip levels from the cache file when it is uploaded. If the cache file has been replaced by
+             * then, the texture is not uploaded.
+             *
+             * @param key the key of the texture
+             * @return the texture allocated with new, or null if the cache contains no entry with the given key
+             */
+            Assets::Texture* readTexture(Key key) const;
+
+            /**
+             * Replaces the cache file with one that contains the given textures, and reads the new file. Textures that
+             * hold their pixel data are written from that data. If a texture is null, its entry in this cache is kept.
+             * All other textures are written without pixel data, so that they are not decoded again.
+             *
+             * @param textures the keys and textures to write
+             *
+             * @throw FileSystemException if the cache file cannot be written
+             */
+            void write(const std::vector<std::pair<Key, const Assets::Texture*>>& textures);
+        private:
+            void markUsed();
+            void read();
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_TextureCache) */
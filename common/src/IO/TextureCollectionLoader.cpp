@@ -19,40 +19,193 @@
 
 #include "TextureCollectionLoader.h"
 
+#include "Exceptions.h"
 #include "Logger.h"
+#include "ParallelUtils.h"
 #include "Assets/AssetTypes.h"
+#include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "Assets/TextureManager.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/FileSystem.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
+#include <iomanip>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <utility>
 
 namespace TrenchBroom {
     namespace IO {
+        static Assets::TextureBufferSource textureBufferSource(const Assets::Texture& texture, FileOpener openFile, std::shared_ptr<const TextureReader> textureReader, std::shared_ptr<std::mutex> readerMutex) {
+            // textures are decoded on worker threads, so readers that cannot read concurrently are serialized
+            return [openFile = std::move(openFile), textureReader = std::move(textureReader), readerMutex = std::move(readerMutex), width = texture.width(), height = texture.height(), format = texture.format()]() {
+                std::unique_lock<std::mutex> lock;
+                if (readerMutex != nullptr) {
+                    lock = std::unique_lock<std::mutex>(*readerMutex);
+                }
+
+                std::unique_ptr<Assets::Texture> texture(textureReader->readTexture(openFile()));
+                // the file may have changed since the collection was loaded
+                if (texture == nullptr || texture->width() != width || texture->height() != height || texture->format() != format) {
+                    return Assets::TextureBuffer::List();
+                }
+                return texture->buffersIfUnprepared();
+            };
+        }
+
+        static Path cacheFilePath(const Path& directory, const Path& collectionPath, const uint64_t signature) {
+            std::stringstream name;
+            name << std::hex << std::setw(16) << std::setfill('0') << TextureCache::key(collectionPath.asString(), signature) << ".tbtc";
+            return directory + Path(name.str());
+        }
+
         TextureCollectionLoader::TextureCollectionLoader(Logger& logger) :
-        m_logger(logger) {}
+        m_logger(logger),
+        m_cacheSignature(0),
+        m_cacheSizeLimit(0) {}
 
         TextureCollectionLoader::~TextureCollectionLoader() = default;
 
-        std::unique_ptr<Assets::TextureCollection> TextureCollectionLoader::loadTextureCollection(const Path& path, const StringList& textureExtensions, const TextureReader& textureReader) {
+        void TextureCollectionLoader::enableCache(const Path& directory, const uint64_t signature, const size_t sizeLimit) {
+            m_cacheDirectory = directory;
+            m_cacheSignature = signature;
+            m_cacheSizeLimit = sizeLimit;
+        }
+
+        std::unique_ptr<Assets::TextureCollection> TextureCollectionLoader::loadTextureCollection(const Path& path, const StringList& textureExtensions, std::shared_ptr<const TextureReader> textureReader) {
+            ensure(textureReader != nullptr, "textureReader is null");
             auto collection = std::make_unique<Assets::TextureCollection>(path);
 
-            for (auto file : doFindTextures(path, textureExtensions)) {
-                auto* texture = textureReader.readTexture(file);
-                collection->addTexture(texture);
+            // the files are read on worker threads, so views of a shared file are copied into memory for loading
+            FileList files;
+            FileList readableFiles;
+            for (auto& file : doFindTextures(path, textureExtensions)) {
+                try {
+                    readableFiles.push_back(concurrentlyReadableFile(file));
+                    files.push_back(std::move(file));
+                } catch (const std::exception& e) {
+                    m_logger.warn() << e.what();
+                }
+            }
+
+            // the textures are only handed to the collection once all of them have been read
+            TextureList textures;
+            if (m_cacheDirectory.isEmpty()) {
+                textures = readTextureInfos(readableFiles, *textureReader);
+            } else {
+                readCachedTextures(doGetCanonicalPath(path), files, readableFiles, *textureReader, textures);
+            }
+
+            // textures read from the cache already have a buffer source, all others only keep the location of their
+            // file and read it again when they are decoded
+            const auto readerMutex = textureReader->canReadConcurrently() ? nullptr : std::make_shared<std::mutex>();
+            for (size_t i = 0; i < files.size(); ++i) {
+                auto& texture = textures[i];
+                if (texture != nullptr && !texture->hasBufferSource()) {
+                    texture->setBufferSource(textureBufferSource(*texture, fileOpener(files[i]), textureReader, readerMutex));
+                }
+                collection->addTexture(texture.release());
             }
 
             return collection;
         }
 
+        TextureCollectionLoader::TextureList TextureCollectionLoader::readTextureInfos(const FileList& files, const TextureReader& textureReader) const {
+            TextureList textures(files.size());
+            if (textureReader.canReadConcurrently()) {
+                ParallelUtils::parallelFor(files.size(), [&](const size_t i) {
+                    textures[i].reset(textureReader.readTextureInfo(files[i]));
+                }, 8);
+            } else {
+                for (size_t i = 0; i < files.size(); ++i) {
+                    textures[i].reset(textureReader.readTextureInfo(files[i]));
+                }
+            }
+            return textures;
+        }
+
+        TextureCollectionLoader::TextureList TextureCollectionLoader::readTextures(const FileList& files, const TextureReader& textureReader) const {
+            // the files are opened on this thread, only decoding the textures is distributed over the workers; if a
+            // worker throws, the textures that were already decoded are released when the list goes out of scope
+            TextureList textures(files.size());
+            if (textureReader.canReadConcurrently()) {
+                ParallelUtils::parallelFor(files.size(), [&](const size_t i) {
+                    textures[i].reset(textureReader.readTexture(files[i]));
+                }, 8);
+            } else {
+                for (size_t i = 0; i < files.size(); ++i) {
+                    textures[i].reset(textureReader.readTexture(files[i]));
+                }
+            }
+            return textures;
+        }
+
+        void TextureCollectionLoader::readCachedTextures(const Path& path, const FileList& files, const FileList& readableFiles, const TextureReader& textureReader, TextureList& textures) const {
+            TextureCache cache(cacheFilePath(m_cacheDirectory, path, m_cacheSignature), m_logger);
+
+            // the keys only depend on the locations of the files, so they are computed from the original files
+            std::vector<TextureCache::Key> keys(files.size());
+            FileList missingFiles;
+            std::vector<size_t> missingIndices;
+            for (size_t i = 0; i < files.size(); ++i) {
+                keys[i] = TextureCache::key(*files[i], m_cacheSignature);
+                if (!cache.contains(keys[i])) {
+                    missingFiles.push_back(readableFiles[i]);
+                    missingIndices.push_back(i);
+                }
+            }
+
+            // the cache stores the image data, so missing textures must be decoded entirely
+            auto decodedTextures = readTextures(missingFiles, textureReader);
+            textures.clear();
+            textures.resize(files.size());
+            for (size_t i = 0; i < missingIndices.size(); ++i) {
+                textures[missingIndices[i]] = std::move(decodedTextures[i]);
+            }
+
+            // rewrite the cache if textures were added, changed or removed
+            if (!missingFiles.empty() || cache.size() != files.size()) {
+                std::vector<std::pair<TextureCache::Key, const Assets::Texture*>> entries;
+                entries.reserve(files.size());
+                for (size_t i = 0; i < files.size(); ++i) {
+                    entries.emplace_back(keys[i], textures[i].get());
+                }
+
+                try {
+                    cache.write(entries);
+                    TextureCache::prune(m_cacheDirectory, m_cacheSizeLimit, m_logger);
+                } catch (const Exception& e) {
+                    m_logger.warn() << "Could not update texture cache for '" << path << "': " << e.what();
+                }
+            }
+
+            // once the cache was written, the decoded textures are read from it as well
+            for (size_t i = 0; i < files.size(); ++i) {
+                if (cache.contains(keys[i])) {
+                    textures[i].reset(cache.readTexture(keys[i]));
+                }
+            }
+        }
+
+        Path TextureCollectionLoader::doGetCanonicalPath(const Path& path) const {
+            return path;
+        }
+
         FileTextureCollectionLoader::FileTextureCollectionLoader(Logger& logger, const IO::Path::List& searchPaths) :
         TextureCollectionLoader(logger),
         m_searchPaths(searchPaths) {}
 
+        Path FileTextureCollectionLoader::doGetCanonicalPath(const Path& path) const {
+            const auto wadPath = Disk::resolvePath(m_searchPaths, path);
+            return wadPath.isEmpty() ? path : wadPath.makeCanonical();
+        }
+
         TextureCollectionLoader::FileList FileTextureCollectionLoader::doFindTextures(const Path& path, const StringList& extensions) {
             const auto wadPath = Disk::resolvePath(m_searchPaths, path);
             WadFileSystem wadFS(wadPath, m_logger);
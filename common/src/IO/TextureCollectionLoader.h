@@ -22,6 +22,7 @@
 
 #include "IO/Path.h"
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -29,6 +30,7 @@ namespace TrenchBroom {
     class Logger;
 
     namespace Assets {
+        class Texture;
         class TextureCollection;
         class TextureReader;
         class TextureManager;
@@ -42,15 +44,49 @@ namespace TrenchBroom {
         class TextureCollectionLoader {
         protected:
             using FileList = std::vector<std::shared_ptr<File>>;
+            using TextureList = std::vector<std::unique_ptr<Assets::Texture>>;
         protected:
             Logger& m_logger;
+        private:
+            Path m_cacheDirectory;
+            uint64_t m_cacheSignature;
+            size_t m_cacheSizeLimit;
         protected:
             TextureCollectionLoader(Logger& logger);
         public:
             virtual ~TextureCollectionLoader();
         public:
-            std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path, const StringList& textureExtensions, const TextureReader& textureReader);
+            /**
+             * Stores the decoded textures of every loaded collection in a cache file in the given directory, and loads
+             * unchanged textures from that file instead of decoding them again.
+             *
+             * @param directory the directory to store the cache files in
+             * @param signature a value that identifies the texture reader and its settings, cached textures that were
+             * decoded with a different signature are not used
+             * @param sizeLimit the maximum total size of the cache files in bytes, the least recently used cache files
+             * are deleted when it is exceeded
+             */
+            void enableCache(const Path& directory, uint64_t signature, size_t sizeLimit);
+
+            /**
+             * Loads the textures of the collection at the given path. Only the names and sizes of the textures are
+             * read, and their pixel data is read with the given reader on a worker thread once a texture is used. The
+             * textures keep the reader and the location of their files for this purpose, but not the file contents.
+             *
+             * If a cache is enabled, the textures are read from the cache if possible, and the cache is updated with
+             * the textures that had to be decoded.
+             */
+            std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path, const StringList& textureExtensions, std::shared_ptr<const TextureReader> textureReader);
         private:
+            TextureList readTextureInfos(const FileList& files, const TextureReader& textureReader) const;
+            TextureList readTextures(const FileList& files, const TextureReader& textureReader) const;
+            void readCachedTextures(const Path& path, const FileList& files, const FileList& readableFiles, const TextureReader& textureReader, TextureList& textures) const;
+
+            /**
+             * Returns a path that identifies the collection at the given path independently of the search paths. The
+             * cache file of the collection is named after it.
+             */
+            virtual Path doGetCanonicalPath(const Path& path) const;
             virtual FileList doFindTextures(const Path& path, const StringList& extensions) = 0;
         };
 
@@ -60,6 +96,7 @@ namespace TrenchBroom {
         public:
             FileTextureCollectionLoader(Logger& logger, const Path::List& searchPaths);
         private:
+            Path doGetCanonicalPath(const Path& path) const override;
             FileList doFindTextures(const Path& path, const StringList& extensions) override;
         };
 
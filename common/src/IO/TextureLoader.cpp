@@ -23,9 +23,11 @@
 #include "Assets/TextureCollection.h"
 #include "Assets/TextureManager.h"
 #include "EL/Interpolator.h"
+#include "IO/File.h"
 #include "IO/FileSystem.h"
 #include "IO/FreeImageTextureReader.h"
 #include "IO/HlMipTextureReader.h"
+#include "IO/TextureCache.h"
 #include "IO/IdMipTextureReader.h"
 #include "IO/Quake3ShaderTextureReader.h"
 #include "IO/WalTextureReader.h"
@@ -35,6 +37,8 @@
 namespace TrenchBroom {
     namespace IO {
         TextureLoader::TextureLoader(const FileSystem& gameFS, const IO::Path::List& fileSearchPaths, const Model::GameConfig::TextureConfig& textureConfig, Logger& logger) :
+        m_textureFormat(textureConfig.format.format),
+        m_cacheSignature(getCacheSignature(gameFS, textureConfig)),
         m_textureExtensions(getTextureExtensions(textureConfig)),
         m_textureReader(createTextureReader(gameFS, textureConfig, logger)),
         m_textureCollectionLoader(createTextureCollectionLoader(gameFS, fileSearchPaths, textureConfig, logger)) {
@@ -42,6 +46,23 @@ namespace TrenchBroom {
             ensure(m_textureCollectionLoader != nullptr, "textureCollectionLoader is null");
         }
 
+        uint64_t TextureLoader::getCacheSignature(const FileSystem& gameFS, const Model::GameConfig::TextureConfig& textureConfig) {
+            auto signature = TextureCache::key(textureConfig.format.format, 0);
+            for (const auto& extension : textureConfig.format.extensions) {
+                signature = TextureCache::key(extension, signature);
+            }
+
+            // the textures depend on the contents of the palette, not on where it was found
+            if (!textureConfig.palette.isEmpty()) {
+                try {
+                    signature = TextureCache::contentKey(*gameFS.openFile(textureConfig.palette), signature);
+                } catch (const Exception&) {
+                    signature = TextureCache::key(textureConfig.palette.asString(), signature);
+                }
+            }
+            return signature;
+        }
+
         StringList TextureLoader::getTextureExtensions(const Model::GameConfig::TextureConfig& textureConfig) {
             return textureConfig.format.extensions;
         }
@@ -95,8 +116,15 @@ namespace TrenchBroom {
             }
         }
 
+        void TextureLoader::enableCache(const Path& directory, const size_t sizeLimit) {
+            // shaders refer to other files, so their textures cannot be keyed by the location of the shader file
+            if (m_textureFormat != "q3shader") {
+                m_textureCollectionLoader->enableCache(directory, m_cacheSignature, sizeLimit);
+            }
+        }
+
         std::unique_ptr<Assets::TextureCollection> TextureLoader::loadTextureCollection(const Path& path) {
-            return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, *m_textureReader);
+            return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtensions, m_textureReader);
         }
 
         void TextureLoader::loadTextures(const Path::List& paths, Assets::TextureManager& textureManager) {
@@ -27,6 +27,7 @@
 #include "IO/TextureReader.h"
 #include "Model/GameConfig.h"
 
+#include <cstdint>
 #include <memory>
 
 namespace TrenchBroom {
@@ -44,17 +45,29 @@ namespace TrenchBroom {
 
         class TextureLoader {
         private:
+            String m_textureFormat;
+            uint64_t m_cacheSignature;
             StringList m_textureExtensions;
-            std::unique_ptr<TextureReader> m_textureReader;
+            std::shared_ptr<TextureReader> m_textureReader;
             std::unique_ptr<TextureCollectionLoader> m_textureCollectionLoader;
         public:
             TextureLoader(const FileSystem& gameFS, const IO::Path::List& fileSearchPaths, const Model::GameConfig::TextureConfig& textureConfig, Logger& logger);
         private:
+            static uint64_t getCacheSignature(const FileSystem& gameFS, const Model::GameConfig::TextureConfig& textureConfig);
             static StringList getTextureExtensions(const Model::GameConfig::TextureConfig& textureConfig);
             static std::unique_ptr<TextureReader> createTextureReader(const FileSystem& gameFS, const Model::GameConfig::TextureConfig& textureConfig, Logger& logger);
             static Assets::Palette loadPalette(const FileSystem& gameFS, const Model::GameConfig::TextureConfig& textureConfig, Logger& logger);
             static std::unique_ptr<TextureCollectionLoader> createTextureCollectionLoader(const FileSystem& gameFS, const IO::Path::List& fileSearchPaths, const Model::GameConfig::TextureConfig& textureConfig, Logger& logger);
         public:
+            /**
+             * Caches the decoded textures of the loaded collections in the given directory. Has no effect for texture
+             * formats whose textures are not read from a single file.
+             *
+             * @param directory the directory to store the cache files in
+             * @param sizeLimit the maximum total size of the cache files in bytes
+             */
+            void enableCache(const Path& directory, size_t sizeLimit);
+
             std::unique_ptr<Assets::TextureCollection> loadTextureCollection(const Path& path);
             void loadTextures(const Path::List& paths, Assets::TextureManager& textureManager);
 
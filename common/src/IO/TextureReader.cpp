@@ -86,6 +86,14 @@ namespace TrenchBroom {
             return doReadTexture(file);
         }
 
+        Assets::Texture* TextureReader::readTextureInfo(std::shared_ptr<File> file) const {
+            return doReadTextureInfo(file);
+        }
+
+        bool TextureReader::canReadConcurrently() const {
+            return doCanReadConcurrently();
+        }
+
         String TextureReader::textureName(const String& textureName, const Path& path) const {
             return m_nameStrategy->textureName(textureName, path);
         }
@@ -94,6 +102,14 @@ namespace TrenchBroom {
             return m_nameStrategy->textureName(path.lastComponent().asString(), path);
         }
 
+        Assets::Texture* TextureReader::doReadTextureInfo(std::shared_ptr<File> file) const {
+            return doReadTexture(file);
+        }
+
+        bool TextureReader::doCanReadConcurrently() const {
+            return false;
+        }
+
         bool TextureReader::checkTextureDimensions(const size_t width, const size_t height) {
             return width <= 8192 && height <= 8192;
         }
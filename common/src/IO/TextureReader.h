@@ -90,6 +90,23 @@ namespace TrenchBroom {
             virtual ~TextureReader();
 
             Assets::Texture* readTexture(std::shared_ptr<File> file) const;
+
+            /**
+             * Reads the name, the size and the type of a texture without decoding its image data if possible. The
+             * returned texture may have no buffers and an unknown average color, so it must be given a buffer source.
+             *
+             * @param file the file containing the texture
+             * @return an Assets::Texture object allocated with new
+             */
+            Assets::Texture* readTextureInfo(std::shared_ptr<File> file) const;
+
+            /**
+             * Indicates whether this reader can read several textures concurrently from different threads. The given
+             * files must have been opened beforehand.
+             *
+             * @return true if readTexture may be called concurrently and false otherwise
+             */
+            bool canReadConcurrently() const;
         protected:
             String textureName(const String& textureName, const Path& path) const;
             String textureName(const Path& path) const;
@@ -103,6 +120,11 @@ namespace TrenchBroom {
              * @return an Assets::Texture object allocated with new
              */
             virtual Assets::Texture* doReadTexture(std::shared_ptr<File> file) const = 0;
+            /**
+             * Reads the texture without its image data. The default implementation reads the entire texture.
+             */
+            virtual Assets::Texture* doReadTextureInfo(std::shared_ptr<File> file) const;
+            virtual bool doCanReadConcurrently() const;
         protected:
             static bool checkTextureDimensions(size_t width, size_t height);
         public:
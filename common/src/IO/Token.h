@@ -22,7 +22,10 @@
 
 #include "StringType.h"
 
+#include <algorithm>
 #include <cassert>
+#include <clocale>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 
@@ -92,27 +95,166 @@ namespace TrenchBroom {
                 return m_column;
             }
 
+            /**
+             * Converts this token to a floating point number. The common case of a decimal number with a mantissa of at
+             * most 2^53 and a small exponent is converted directly and without rounding errors. All other
+             * cases are passed on to the C library. In both cases, the decimal point is always '.', regardless of the
+             * current locale.
+             */
             template <typename T>
             T toFloat() const {
-                static const size_t BufferSize = 256;
-                static char buffer[BufferSize];
-                assert(length() < BufferSize);
-
-                memcpy(buffer, m_begin, length());
-                buffer[length()] = 0;
-                const T f = static_cast<T>(std::atof(buffer));
-                return f;
+                double result;
+                if (!parseSimpleDecimal(m_begin, m_end, result)) {
+                    result = parseDecimal(m_begin, m_end);
+                }
+                return static_cast<T>(result);
             }
 
+            /**
+             * Converts the leading integer part of this token to an integer.
+             */
             template <typename T>
             T toInteger() const {
-                static char buffer[64];
-                assert(length() < 64);
+                const char* cur = m_begin;
+                const bool negative = cur < m_end && *cur == '-';
+                if (cur < m_end && (*cur == '-' || *cur == '+')) {
+                    ++cur;
+                }
+
+                uint64_t value = 0;
+                while (cur < m_end && isDigit(*cur)) {
+                    value = value * 10u + static_cast<uint64_t>(*cur - '0');
+                    ++cur;
+                }
+
+                const auto result = static_cast<int64_t>(negative ? 0u - value : value);
+                return static_cast<T>(result);
+            }
+        private:
+            static bool isDigit(const char c) {
+                return c >= '0' && c <= '9';
+            }
+
+            /**
+             * Converts the given decimal number if its mantissa and power of ten are exactly representable as double
+             * precision numbers. Then the result is a single correctly rounded multiplication or division, which is
+             * also what strtod returns.
+             *
+             * Returns false if the number is not of this form or if there are any unexpected characters.
+             */
+            static bool parseSimpleDecimal(const char* begin, const char* end, double& result) {
+                static const double PowersOfTen[] = {
+                    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+                    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+                };
+                static const int MaxExponent = 22;
+                static const int MaxDigits = 19;
+                static const uint64_t MaxMantissa = uint64_t(1) << 53;
+
+                const char* cur = begin;
+                const bool negative = cur < end && *cur == '-';
+                if (cur < end && (*cur == '-' || *cur == '+')) {
+                    ++cur;
+                }
+
+                uint64_t mantissa = 0;
+                int digits = 0;
+                int exponent = 0;
+                bool hasDigits = false;
+
+                const auto addDigit = [&](const char c) {
+                    if (mantissa == 0 && c == '0') {
+                        return true;
+                    }
+                    mantissa = mantissa * 10u + static_cast<uint64_t>(c - '0');
+                    return ++digits <= MaxDigits;
+                };
+
+                while (cur < end && isDigit(*cur)) {
+                    if (!addDigit(*cur++)) {
+                        return false;
+                    }
+                    hasDigits = true;
+                }
+
+                if (cur < end && *cur == '.') {
+                    ++cur;
+                    while (cur < end && isDigit(*cur)) {
+                        if (!addDigit(*cur++)) {
+                            return false;
+                        }
+                        --exponent;
+                        hasDigits = true;
+                    }
+                }
+
+                if (!hasDigits) {
+                    return false;
+                }
+
+                if (cur < end && (*cur == 'e' || *cur == 'E')) {
+                    ++cur;
+                    const bool negativeExponent = cur < end && *cur == '-';
+                    if (cur < end && (*cur == '-' || *cur == '+')) {
+                        ++cur;
+                    }
+                    if (cur == end || !isDigit(*cur)) {
+                        return false;
+                    }
+
+                    int value = 0;
+                    while (cur < end && isDigit(*cur)) {
+                        if (value > 1000) {
+                            return false;
+                        }
+                        value = value * 10 + (*cur++ - '0');
+                    }
+                    exponent += negativeExponent ? -value : value;
+                }
+
+                if (cur != end) {
+                    return false;
+                }
+
+                if (mantissa == 0) {
+                    result = negative ? -0.0 : 0.0;
+                    return true;
+                }
+
+                if (mantissa > MaxMantissa || exponent < -MaxExponent || exponent > MaxExponent) {
+                    return false;
+                }
+
+                result = static_cast<double>(mantissa);
+                if (exponent < 0) {
+                    result /= PowersOfTen[-exponent];
+                } else {
+                    result *= PowersOfTen[exponent];
+                }
+                if (negative) {
+                    result = -result;
+                }
+                return true;
+            }
+
+            /**
+             * Converts the given decimal number using strtod. The decimal point is replaced by the one of the current
+             * locale first, so that the conversion does not depend on the locale.
+             */
+            static double parseDecimal(const char* begin, const char* end) {
+                static const size_t BufferSize = 256;
+                char buffer[BufferSize];
+
+                const auto length = std::min(static_cast<size_t>(end - begin), BufferSize - 1);
+                assert(length == static_cast<size_t>(end - begin));
+
+                const char decimalPoint = *std::localeconv()->decimal_point;
+                for (size_t i = 0; i < length; ++i) {
+                    buffer[i] = begin[i] == '.' ? decimalPoint : begin[i];
+                }
+                buffer[length] = 0;
 
-                memcpy(buffer, m_begin, length());
-                buffer[length()] = 0;
-                const T i = static_cast<T>(std::atoi(buffer));
-                return i;
+                return std::strtod(buffer, nullptr);
             }
         };
     }
@@ -21,6 +21,9 @@
 
 #include "StringUtils.h"
 
+#include <cstdint>
+#include <cstring>
+
 namespace TrenchBroom {
     namespace IO {
         TokenizerState::TokenizerState(const char* begin, const char* end, const String& escapableChars, const char escapeChar) :
@@ -133,6 +136,35 @@ namespace TrenchBroom {
             ++m_cur;
         }
 
+        void TokenizerState::advanceDigits() {
+            const char* cur = m_cur;
+
+            // Check eight characters at a time: a character is a digit if its high nibble is 3 and adding 6 to it
+            // does not carry into the high nibble.
+            static const uint64_t HighNibbles = 0xF0F0F0F0F0F0F0F0ull;
+            static const uint64_t Threes = 0x3030303030303030ull;
+            static const uint64_t Sixes = 0x0606060606060606ull;
+            while (m_end - cur >= 8) {
+                uint64_t chars;
+                std::memcpy(&chars, cur, sizeof(chars));
+                if ((chars & HighNibbles) != Threes || ((chars + Sixes) & HighNibbles) != Threes) {
+                    break;
+                }
+                cur += 8;
+            }
+
+            while (cur < m_end && *cur >= '0' && *cur <= '9') {
+                ++cur;
+            }
+
+            // digits cannot end a line, so the column can be updated in one step
+            if (cur != m_cur) {
+                m_column += static_cast<size_t>(cur - m_cur);
+                m_cur = cur;
+                m_escaped = false;
+            }
+        }
+
         void TokenizerState::reset() {
             m_cur = m_begin;
             m_line = 1;
@@ -140,6 +172,14 @@ namespace TrenchBroom {
             m_escaped = false;
         }
 
+        void TokenizerState::seek(const char* position, const size_t line, const size_t column) {
+            assert(position >= m_begin && position <= m_end);
+            m_cur = position;
+            m_line = line;
+            m_column = column;
+            m_escaped = false;
+        }
+
         void TokenizerState::errorIfEof() const {
             if (eof()) {
                 throw ParserException("Unexpected end of file");
@@ -66,7 +66,9 @@ namespace TrenchBroom {
 
             void advance(size_t offset);
             void advance();
+            void advanceDigits();
             void reset();
+            void seek(const char* position, size_t line, size_t column);
 
             void errorIfEof() const;
 
@@ -214,6 +216,14 @@ namespace TrenchBroom {
             void restore(const TokenizerState& snapshot) {
                 m_state->restore(snapshot);
             }
+
+            /**
+             * Moves this tokenizer to the given position, which must lie within its range. The given line and column
+             * must be the ones of the position, since they cannot be recomputed cheaply.
+             */
+            void seek(const char* position, const size_t line, const size_t column) {
+                m_state->seek(position, line, column);
+            }
         protected:
             size_t offset(const char* ptr) const {
                 return m_state->offset(ptr);
@@ -268,9 +278,7 @@ namespace TrenchBroom {
                 if (curChar() == '+' || curChar() == '-') {
                     advance();
                 }
-                while (!eof() && isDigit(curChar())) {
-                    advance();
-                }
+                readDigits();
                 if (eof() || isAnyOf(curChar(), delims)) {
                     return curPos();
                 }
@@ -313,9 +321,7 @@ namespace TrenchBroom {
 
         private:
             void readDigits() {
-                while (!eof() && isDigit(curChar())) {
-                    advance();
-                }
+                m_state->advanceDigits();
             }
         protected:
             const char* readUntil(const String& delims) {
@@ -0,0 +1,215 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "InternedString.h"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+namespace TrenchBroom {
+    struct InternedString::Entry {
+        const String str;
+        const size_t shard;
+        std::atomic<size_t> refCount;
+
+        Entry(const String& i_str, const size_t i_shard) :
+        str(i_str),
+        shard(i_shard),
+        refCount(1) {}
+    };
+
+    namespace {
+        /**
+         * The pool is split into shards by the hash of the strings, each with its own lock, so that threads
+         * which intern unrelated strings rarely have to wait for each other.
+         */
+        class StringPool {
+        private:
+            static const size_t ShardCount = 16;
+
+            struct Shard {
+                std::shared_mutex mutex;
+                std::unordered_map<std::string_view, InternedString::Entry*> entries;
+            };
+
+            Shard m_shards[ShardCount];
+        public:
+            static StringPool& instance() {
+                // intentionally leaked so that handles in static objects can outlive the pool's users
+                static StringPool* pool = new StringPool();
+                return *pool;
+            }
+
+            InternedString::Entry* acquire(const String& str) {
+                const size_t shardIndex = shardFor(str);
+                Shard& shard = m_shards[shardIndex];
+
+                {
+                    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+                    auto it = shard.entries.find(std::string_view(str));
+                    if (it != std::end(shard.entries)) {
+                        ++it->second->refCount;
+                        return it->second;
+                    }
+                }
+
+                std::unique_lock<std::shared_mutex> lock(shard.mutex);
+                auto it = shard.entries.find(std::string_view(str));
+                if (it != std::end(shard.entries)) {
+                    ++it->second->refCount;
+                    return it->second;
+                }
+
+                auto entry = std::make_unique<InternedString::Entry>(str, shardIndex);
+                shard.entries.emplace(std::string_view(entry->str), entry.get());
+                return entry.release();
+            }
+
+            InternedString::Entry* find(const String& str) {
+                Shard& shard = m_shards[shardFor(str)];
+                std::shared_lock<std::shared_mutex> lock(shard.mutex);
+                auto it = shard.entries.find(std::string_view(str));
+                if (it == std::end(shard.entries)) {
+                    return nullptr;
+                }
+                ++it->second->refCount;
+                return it->second;
+            }
+
+            void release(InternedString::Entry* entry) {
+                // Dropping a reference that is not the last one does not need the lock. Only the last reference
+                // must be dropped while holding the lock, otherwise another thread could find the entry while it
+                // is being removed.
+                size_t refCount = entry->refCount.load();
+                while (refCount > 1) {
+                    if (entry->refCount.compare_exchange_weak(refCount, refCount - 1)) {
+                        return;
+                    }
+                }
+
+                Shard& shard = m_shards[entry->shard];
+                std::unique_lock<std::shared_mutex> lock(shard.mutex);
+                if (--entry->refCount == 0) {
+                    shard.entries.erase(std::string_view(entry->str));
+                    lock.unlock();
+                    delete entry;
+                }
+            }
+
+            size_t size() {
+                size_t result = 0;
+                for (Shard& shard : m_shards) {
+                    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+                    result += shard.entries.size();
+                }
+                return result;
+            }
+        private:
+            static size_t shardFor(const String& str) {
+                return std::hash<std::string_view>()(std::string_view(str)) % ShardCount;
+            }
+        };
+    }
+
+    InternedString::InternedString() :
+    m_entry(nullptr) {}
+
+    InternedString::InternedString(const String& str) :
+    m_entry(str.empty() ? nullptr : StringPool::instance().acquire(str)) {}
+
+    InternedString::InternedString(const InternedString& other) :
+    m_entry(other.m_entry) {
+        if (m_entry != nullptr) {
+            ++m_entry->refCount;
+        }
+    }
+
+    InternedString::InternedString(InternedString&& other) noexcept :
+    m_entry(other.m_entry) {
+        other.m_entry = nullptr;
+    }
+
+    InternedString::~InternedString() {
+        release();
+    }
+
+    InternedString& InternedString::operator=(InternedString other) {
+        using std::swap;
+        swap(*this, other);
+        return *this;
+    }
+
+    void swap(InternedString& lhs, InternedString& rhs) noexcept {
+        using std::swap;
+        swap(lhs.m_entry, rhs.m_entry);
+    }
+
+    bool InternedString::find(const String& str, InternedString& result) {
+        if (str.empty()) {
+            result = InternedString();
+            return true;
+        }
+
+        Entry* entry = StringPool::instance().find(str);
+        if (entry == nullptr) {
+            return false;
+        }
+
+        InternedString found;
+        found.m_entry = entry;
+        result = std::move(found);
+        return true;
+    }
+
+    size_t InternedString::poolSize() {
+        return StringPool::instance().size();
+    }
+
+    const String& InternedString::str() const {
+        return m_entry != nullptr ? m_entry->str : EmptyString;
+    }
+
+    bool InternedString::empty() const {
+        return m_entry == nullptr;
+    }
+
+    size_t InternedString::hash() const {
+        return std::hash<const Entry*>()(m_entry);
+    }
+
+    bool InternedString::operator==(const InternedString& rhs) const {
+        return m_entry == rhs.m_entry;
+    }
+
+    bool InternedString::operator!=(const InternedString& rhs) const {
+        return m_entry != rhs.m_entry;
+    }
+
+    void InternedString::release() {
+        if (m_entry != nullptr) {
+            StringPool::instance().release(m_entry);
+            m_entry = nullptr;
+        }
+    }
+}
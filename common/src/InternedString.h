@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_InternedString
+#define TrenchBroom_InternedString
+
+#include "StringType.h"
+
+#include <cstddef>
+#include <functional>
+
+namespace TrenchBroom {
+    /**
+     * A handle to a string that is stored in a global, reference counted string pool. All handles to equal
+     * strings share a single pool entry, so copying a handle does not copy the string, and two handles can be
+     * compared for equality by comparing their entries. The pool entry is removed when the last handle to it is
+     * destroyed.
+     *
+     * The empty string is not stored in the pool; a default constructed handle represents it.
+     *
+     * Handles can be created, copied and destroyed concurrently from multiple threads.
+     */
+    class InternedString {
+    public:
+        struct Entry;
+    private:
+        Entry* m_entry;
+    public:
+        InternedString();
+        explicit InternedString(const String& str);
+        InternedString(const InternedString& other);
+        InternedString(InternedString&& other) noexcept;
+        ~InternedString();
+
+        InternedString& operator=(InternedString other);
+        friend void swap(InternedString& lhs, InternedString& rhs) noexcept;
+
+        /**
+         * Looks up the given string in the pool without adding it. If the string is found, a handle to it is
+         * stored in the given result and true is returned. Since an empty string is never stored in the pool,
+         * looking it up always succeeds.
+         *
+         * @param str the string to look up
+         * @param result the handle to the pooled string, if any
+         * @return true if the string is in the pool and false otherwise
+         */
+        static bool find(const String& str, InternedString& result);
+
+        /**
+         * Returns the number of distinct strings that are currently stored in the pool.
+         */
+        static size_t poolSize();
+
+        const String& str() const;
+        bool empty() const;
+        size_t hash() const;
+
+        bool operator==(const InternedString& rhs) const;
+        bool operator!=(const InternedString& rhs) const;
+    private:
+        void release();
+    };
+}
+
+namespace std {
+    template <>
+    struct hash<TrenchBroom::InternedString> {
+        size_t operator()(const TrenchBroom::InternedString& str) const {
+            return str.hash();
+        }
+    };
+}
+
+#endif /* defined(TrenchBroom_InternedString) */
@@ -21,7 +21,9 @@
 
 #include "Assets/AttributeDefinition.h"
 #include "CollectionUtils.h"
-#include "StringMap.h"
+#include "IO/NodeTextCache.h"
+
+#include <algorithm>
 
 namespace TrenchBroom {
     namespace Model {
@@ -137,6 +139,10 @@ namespace TrenchBroom {
             return m_attributes.hasAttribute(name);
         }
 
+        bool AttributableNode::hasAttribute(const InternedString& name) const {
+            return m_attributes.hasAttribute(name);
+        }
+
         bool AttributableNode::hasAttribute(const AttributeName& name, const AttributeValue& value) const {
             return m_attributes.hasAttribute(name, value);
         }
@@ -168,6 +174,13 @@ namespace TrenchBroom {
             return *value;
         }
 
+        const AttributeValue& AttributableNode::attribute(const InternedString& name, const AttributeValue& defaultValue) const {
+            const AttributeValue* value = m_attributes.attribute(name);
+            if (value == nullptr)
+                return defaultValue;
+            return *value;
+        }
+
         const AttributeValue& AttributableNode::classname(const AttributeValue& defaultClassname) const {
             return m_classname.empty() ? defaultClassname : m_classname;
         }
@@ -249,7 +262,7 @@ namespace TrenchBroom {
             if (!attributes.empty()) {
                 const NotifyAttributeChange notifyChange(this);
 
-                for (const EntityAttribute& attribute : m_attributes.attributes()) {
+                for (const EntityAttribute& attribute : attributes) {
                     const AttributeName& name = attribute.name();
                     const AttributeValue& value = attribute.value();
 
@@ -284,12 +297,15 @@ namespace TrenchBroom {
         void AttributableNode::attributesWillChange() {}
 
         void AttributableNode::attributesDidChange(const vm::bbox3& oldPhysicalBounds) {
+            if (m_attributeTextCache != nullptr) {
+                m_attributeTextCache->invalidate();
+            }
             updateClassname();
             doAttributesDidChange(oldPhysicalBounds);
         }
 
         void AttributableNode::updateClassname() {
-            m_classname = attribute(AttributeNames::Classname);
+            m_classname = attribute(AttributeNames::ClassnameKey);
         }
 
         void AttributableNode::addAttributesToIndex() {
@@ -306,8 +322,8 @@ namespace TrenchBroom {
             EntityAttribute::List oldSorted = m_attributes.attributes();
             EntityAttribute::List newSorted = newAttributes;
 
-            oldSorted.sort();
-            newSorted.sort();
+            std::sort(std::begin(oldSorted), std::end(oldSorted));
+            std::sort(std::begin(newSorted), std::end(newSorted));
 
             auto oldIt = std::begin(oldSorted);
             auto oldEnd = std::end(oldSorted);
@@ -357,6 +373,13 @@ namespace TrenchBroom {
             addToIndex(this, newName, newValue);
         }
 
+        IO::NodeTextCache& AttributableNode::attributeTextCache() const {
+            if (m_attributeTextCache == nullptr) {
+                m_attributeTextCache = std::make_unique<IO::NodeTextCache>();
+            }
+            return *m_attributeTextCache;
+        }
+
         const AttributableNodeList& AttributableNode::linkSources() const {
             return m_linkSources;
         }
@@ -384,7 +407,7 @@ namespace TrenchBroom {
         bool AttributableNode::hasMissingSources() const {
             return (m_linkSources.empty() &&
                     m_killSources.empty() &&
-                    hasAttribute(AttributeNames::Targetname));
+                    hasAttribute(AttributeNames::TargetnameKey));
         }
 
         AttributeNameList AttributableNode::findMissingLinkTargets() const {
@@ -462,7 +485,7 @@ namespace TrenchBroom {
                 AttributableNodeList::iterator it = std::begin(m_linkTargets);
                 while (it != rem) {
                     AttributableNode* target = *it;
-                    const AttributeValue& targetTargetname = target->attribute(AttributeNames::Targetname);
+                    const AttributeValue& targetTargetname = target->attribute(AttributeNames::TargetnameKey);
                     if (targetTargetname == targetname) {
                         target->removeLinkSource(this);
                         --rem;
@@ -481,7 +504,7 @@ namespace TrenchBroom {
                 AttributableNodeList::iterator it = std::begin(m_killTargets);
                 while (it != rem) {
                     AttributableNode* target = *it;
-                    const AttributeValue& targetTargetname = target->attribute(AttributeNames::Targetname);
+                    const AttributeValue& targetTargetname = target->attribute(AttributeNames::TargetnameKey);
                     if (targetTargetname == targetname) {
                         target->removeKillSource(this);
                         --rem;
@@ -607,7 +630,7 @@ namespace TrenchBroom {
             addAllLinkTargets();
             addAllKillTargets();
 
-            const AttributeValue* targetname = m_attributes.attribute(AttributeNames::Targetname);
+            const AttributeValue* targetname = m_attributes.attribute(AttributeNames::TargetnameKey);
             if (targetname != nullptr && !targetname->empty()) {
                 addAllLinkSources(*targetname);
                 addAllKillSources(*targetname);
@@ -27,7 +27,13 @@
 #include "Model/ModelTypes.h"
 #include "Model/Node.h"
 
+#include <memory>
+
 namespace TrenchBroom {
+    namespace IO {
+        class NodeTextCache;
+    }
+
     namespace Model {
         class AttributableNode : public Node {
         public: // some helper methods
@@ -47,6 +53,9 @@ namespace TrenchBroom {
 
             // cache the classname for faster access
             AttributeValue m_classname;
+
+            // created when the attributes are first written to a map file
+            mutable std::unique_ptr<IO::NodeTextCache> m_attributeTextCache;
         public:
             virtual ~AttributableNode() override;
         public: // definition
@@ -68,6 +77,7 @@ namespace TrenchBroom {
             AttributeNameSet attributeNames() const;
 
             bool hasAttribute(const AttributeName& name) const;
+            bool hasAttribute(const InternedString& name) const;
             bool hasAttribute(const AttributeName& name, const AttributeValue& value) const;
             bool hasAttributeWithPrefix(const AttributeName& prefix, const AttributeValue& value) const;
             bool hasNumberedAttribute(const AttributeName& prefix, const AttributeValue& value) const;
@@ -77,6 +87,7 @@ namespace TrenchBroom {
             EntityAttribute::List numberedAttributes(const String& prefix) const;
 
             const AttributeValue& attribute(const AttributeName& name, const AttributeValue& defaultValue = DefaultAttributeValue) const;
+            const AttributeValue& attribute(const InternedString& name, const AttributeValue& defaultValue = DefaultAttributeValue) const;
             const AttributeValue& classname(const AttributeValue& defaultClassname = AttributeValues::NoClassname) const;
 
             EntityAttributeSnapshot attributeSnapshot(const AttributeName& name) const;
@@ -116,6 +127,12 @@ namespace TrenchBroom {
             void addAttributeToIndex(const AttributeName& name, const AttributeValue& value);
             void removeAttributeFromIndex(const AttributeName& name, const AttributeValue& value);
             void updateAttributeIndex(const AttributeName& oldName, const AttributeValue& oldValue, const AttributeName& newName, const AttributeValue& newValue);
+        public: // serializer cache
+            /**
+             * Returns the text that the attributes of this node were last written as by a map file serializer. The
+             * cache is invalidated whenever the attributes change.
+             */
+            IO::NodeTextCache& attributeTextCache() const;
         public: // link management
             const AttributableNodeList& linkSources() const;
             const AttributableNodeList& linkTargets() const;
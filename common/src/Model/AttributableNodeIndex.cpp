@@ -19,14 +19,142 @@
 
 #include "AttributableNodeIndex.h"
 
-#include "CollectionUtils.h"
+#include "Exceptions.h"
 #include "Macros.h"
+#include "StringUtils.h"
 #include "Model/AttributableNode.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 
 namespace TrenchBroom {
     namespace Model {
+        static bool compareKeys(const InternedString& lhs, const InternedString& rhs) {
+            return lhs.str() < rhs.str();
+        }
+
+        static void sortAndRemoveDuplicates(AttributableNodeList& nodes) {
+            std::sort(std::begin(nodes), std::end(nodes));
+            nodes.erase(std::unique(std::begin(nodes), std::end(nodes)), std::end(nodes));
+        }
+
+        void AttributableNodeStringIndex::NodeSet::insert(AttributableNode* attributable) {
+            ++m_nodes[attributable];
+        }
+
+        void AttributableNodeStringIndex::NodeSet::remove(AttributableNode* attributable) {
+            const auto it = m_nodes.find(attributable);
+            if (it == std::end(m_nodes))
+                throw Exception("Cannot remove attribute from index.");
+            if (--it->second == 0)
+                m_nodes.erase(it);
+        }
+
+        bool AttributableNodeStringIndex::NodeSet::empty() const {
+            return m_nodes.empty();
+        }
+
+        void AttributableNodeStringIndex::NodeSet::appendTo(AttributableNodeList& result) const {
+            result.reserve(result.size() + m_nodes.size());
+            for (const auto& entry : m_nodes)
+                result.push_back(entry.first);
+        }
+
+        AttributableNodeStringIndex::AttributableNodeStringIndex(const bool sortKeys) :
+        m_sortKeys(sortKeys) {}
+
+        void AttributableNodeStringIndex::insert(const InternedString& key, AttributableNode* attributable) {
+            auto it = m_nodes.find(key);
+            if (it == std::end(m_nodes)) {
+                it = m_nodes.emplace(key, NodeSet()).first;
+                if (m_sortKeys)
+                    m_sortedKeys.insert(std::upper_bound(std::begin(m_sortedKeys), std::end(m_sortedKeys), key, compareKeys), key);
+            }
+            it->second.insert(attributable);
+        }
+
+        void AttributableNodeStringIndex::remove(const InternedString& key, AttributableNode* attributable) {
+            const auto it = m_nodes.find(key);
+            if (it == std::end(m_nodes))
+                throw Exception("Cannot remove attribute from index.");
+
+            NodeSet& nodes = it->second;
+            nodes.remove(attributable);
+
+            if (nodes.empty()) {
+                m_nodes.erase(it);
+                if (m_sortKeys) {
+                    const auto range = std::equal_range(std::begin(m_sortedKeys), std::end(m_sortedKeys), key, compareKeys);
+                    assert(std::distance(range.first, range.second) == 1);
+                    m_sortedKeys.erase(range.first);
+                }
+            }
+        }
+
+        AttributableNodeList AttributableNodeStringIndex::queryExactMatches(const String& key) const {
+            InternedString internedKey;
+            if (!InternedString::find(key, internedKey))
+                return AttributableNodeList();
+
+            const auto it = m_nodes.find(internedKey);
+            if (it == std::end(m_nodes))
+                return AttributableNodeList();
+
+            AttributableNodeList result;
+            it->second.appendTo(result);
+            std::sort(std::begin(result), std::end(result));
+            return result;
+        }
+
+        AttributableNodeList AttributableNodeStringIndex::queryPrefixMatches(const String& prefix) const {
+            return queryMatches(prefix, [](const String& /* key */) { return true; });
+        }
+
+        AttributableNodeList AttributableNodeStringIndex::queryNumberedMatches(const String& prefix) const {
+            return queryMatches(prefix, [&](const String& key) { return isNumberedAttribute(prefix, key); });
+        }
+
+        StringList AttributableNodeStringIndex::keys() const {
+            StringList result;
+            result.reserve(m_nodes.size());
+
+            if (m_sortKeys) {
+                for (const InternedString& key : m_sortedKeys)
+                    result.push_back(key.str());
+            } else {
+                for (const auto& entry : m_nodes)
+                    result.push_back(entry.first.str());
+                std::sort(std::begin(result), std::end(result));
+            }
+
+            return result;
+        }
+
+        template <typename P>
+        AttributableNodeList AttributableNodeStringIndex::queryMatches(const String& prefix, const P& predicate) const {
+            AttributableNodeList result;
+
+            if (m_sortKeys) {
+                auto it = std::lower_bound(std::begin(m_sortedKeys), std::end(m_sortedKeys), prefix, [](const InternedString& key, const String& str) {
+                    return key.str() < str;
+                });
+                for (; it != std::end(m_sortedKeys) && StringUtils::isPrefix(it->str(), prefix); ++it) {
+                    if (predicate(it->str()))
+                        m_nodes.at(*it).appendTo(result);
+                }
+            } else {
+                for (const auto& entry : m_nodes) {
+                    const String& key = entry.first.str();
+                    if (StringUtils::isPrefix(key, prefix) && predicate(key))
+                        entry.second.appendTo(result);
+                }
+            }
+
+            sortAndRemoveDuplicates(result);
+            return result;
+        }
+
         AttributableNodeIndexQuery AttributableNodeIndexQuery::exact(const String& pattern) {
             return AttributableNodeIndexQuery(Type_Exact, pattern);
         }
@@ -43,7 +171,7 @@ namespace TrenchBroom {
             return AttributableNodeIndexQuery(Type_Any);
         }
 
-        AttributableNodeSet AttributableNodeIndexQuery::execute(const AttributableNodeStringIndex& index) const {
+        AttributableNodeList AttributableNodeIndexQuery::execute(const AttributableNodeStringIndex& index) const {
             switch (m_type) {
                 case Type_Exact:
                     return index.queryExactMatches(m_pattern);
@@ -52,7 +180,7 @@ namespace TrenchBroom {
                 case Type_Numbered:
                     return index.queryNumberedMatches(m_pattern);
                 case Type_Any:
-                    return EmptyAttributableNodeSet;
+                    return EmptyAttributableNodeList;
                 switchDefault()
             }
         }
@@ -89,56 +217,64 @@ namespace TrenchBroom {
         m_type(type),
         m_pattern(pattern) {}
 
+        AttributableNodeIndex::AttributableNodeIndex() :
+        m_nameIndex(true),
+        m_valueIndex(false) {}
+
         void AttributableNodeIndex::addAttributableNode(AttributableNode* attributable) {
             for (const EntityAttribute& attribute : attributable->attributes())
-                addAttribute(attributable, attribute.name(), attribute.value());
+                addAttribute(attributable, attribute.internedName(), attribute.internedValue());
         }
 
         void AttributableNodeIndex::removeAttributableNode(AttributableNode* attributable) {
             for (const EntityAttribute& attribute : attributable->attributes())
-                removeAttribute(attributable, attribute.name(), attribute.value());
+                removeAttribute(attributable, attribute.internedName(), attribute.internedValue());
         }
 
         void AttributableNodeIndex::addAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
+            addAttribute(attributable, InternedString(name), InternedString(value));
+        }
+
+        void AttributableNodeIndex::addAttribute(AttributableNode* attributable, const InternedString& name, const InternedString& value) {
             m_nameIndex.insert(name, attributable);
             m_valueIndex.insert(value, attributable);
         }
 
         void AttributableNodeIndex::removeAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value) {
+            // every indexed string is kept alive by the index itself, so these lookups only fail if the attribute
+            // was never added
+            InternedString internedName, internedValue;
+            if (!InternedString::find(name, internedName) || !InternedString::find(value, internedValue))
+                throw Exception("Cannot remove attribute from index.");
+            removeAttribute(attributable, internedName, internedValue);
+        }
+
+        void AttributableNodeIndex::removeAttribute(AttributableNode* attributable, const InternedString& name, const InternedString& value) {
             m_nameIndex.remove(name, attributable);
             m_valueIndex.remove(value, attributable);
         }
 
         AttributableNodeList AttributableNodeIndex::findAttributableNodes(const AttributableNodeIndexQuery& nameQuery, const AttributeValue& value) const {
-            const AttributableNodeSet nameResult = nameQuery.execute(m_nameIndex);
-            const AttributableNodeSet valueResult = m_valueIndex.queryExactMatches(value);
+            // Only few nodes share a value such as a targetname, whereas a name such as target may be used by most
+            // nodes. Therefore, the nodes with the given value are found first and then checked against the name query.
+            AttributableNodeList result = m_valueIndex.queryExactMatches(value);
 
-            if (nameResult.empty() || valueResult.empty())
-                return EmptyAttributableNodeList;
-
-            AttributableNodeList result;
-            SetUtils::intersection(nameResult, valueResult, result);
-
-            AttributableNodeList::iterator it = std::begin(result);
-            while (it != std::end(result)) {
-                const AttributableNode* node = *it;
-                if (!nameQuery.execute(node, value))
-                    it = result.erase(it);
-                else
-                    ++it;
-            }
+            const auto it = std::remove_if(std::begin(result), std::end(result), [&](const AttributableNode* node) {
+                return !nameQuery.execute(node, value);
+            });
+            result.erase(it, std::end(result));
 
             return result;
         }
 
         StringList AttributableNodeIndex::allNames() const {
-            return m_nameIndex.getKeys();
+            return m_nameIndex.keys();
         }
 
         StringList AttributableNodeIndex::allValuesForNames(const AttributableNodeIndexQuery& keyQuery) const {
             StringList result;
 
-            const AttributableNodeSet nameResult = keyQuery.execute(m_nameIndex);
+            const AttributableNodeList nameResult = keyQuery.execute(m_nameIndex);
             for (const auto node : nameResult) {
                 const Model::EntityAttribute::List matchingAttributes = keyQuery.execute(node);
                 for (const auto& attribute : matchingAttributes) {
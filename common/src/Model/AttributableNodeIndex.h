@@ -20,15 +20,64 @@
 #ifndef TrenchBroom_EntityAttributeIndex
 #define TrenchBroom_EntityAttributeIndex
 
+#include "InternedString.h"
+#include "StringList.h"
 #include "StringType.h"
 #include "Model/ModelTypes.h"
 #include "Model/EntityAttributes.h"
-#include "StringMap.h"
+
+#include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
-        using AttributableNodeIndexValueContainer = StringMultiMapValueContainer<AttributableNode*>;
-        using AttributableNodeStringIndex = StringMap<AttributableNode*, AttributableNodeIndexValueContainer>;
+        /**
+         * Maps strings to the nodes that have an attribute with that string as its name or as its value.
+         *
+         * Exact queries are answered by a hash map. Prefix and numbered queries need the distinct keys in sorted order,
+         * so that they only visit the keys that start with the given prefix. Keeping the keys sorted costs linear time
+         * whenever a key is added, which is only affordable if there are few distinct keys, such as attribute names.
+         * Therefore, an index can be created without sorted keys, and then its prefix and numbered queries visit every
+         * key instead.
+         *
+         * Queries do not modify the index, so they can be run concurrently as long as the index is not changed.
+         *
+         * The query results are sorted and contain every node only once.
+         */
+        class AttributableNodeStringIndex {
+        private:
+            /**
+             * A multiset of nodes that contains a node once for every attribute it has with the same key. Every node
+             * is mapped to the number of times it is contained, so that insertions and removals take constant time
+             * even for keys such as classname that most nodes share.
+             */
+            class NodeSet {
+            private:
+                std::unordered_map<AttributableNode*, size_t> m_nodes;
+            public:
+                void insert(AttributableNode* attributable);
+                void remove(AttributableNode* attributable);
+                bool empty() const;
+                void appendTo(AttributableNodeList& result) const;
+            };
+
+            std::unordered_map<InternedString, NodeSet> m_nodes;
+            bool m_sortKeys;
+            std::vector<InternedString> m_sortedKeys;
+        public:
+            explicit AttributableNodeStringIndex(bool sortKeys);
+
+            void insert(const InternedString& key, AttributableNode* attributable);
+            void remove(const InternedString& key, AttributableNode* attributable);
+
+            AttributableNodeList queryExactMatches(const String& key) const;
+            AttributableNodeList queryPrefixMatches(const String& prefix) const;
+            AttributableNodeList queryNumberedMatches(const String& prefix) const;
+            StringList keys() const;
+        private:
+            template <typename P>
+            AttributableNodeList queryMatches(const String& prefix, const P& predicate) const;
+        };
 
         class AttributableNodeIndexQuery {
         public:
@@ -47,7 +96,7 @@ namespace TrenchBroom {
             static AttributableNodeIndexQuery numbered(const String& pattern);
             static AttributableNodeIndexQuery any();
 
-            AttributableNodeSet execute(const AttributableNodeStringIndex& index) const;
+            AttributableNodeList execute(const AttributableNodeStringIndex& index) const;
             bool execute(const AttributableNode* node, const String& value) const;
             Model::EntityAttribute::List execute(const AttributableNode* node) const;
         private:
@@ -59,11 +108,15 @@ namespace TrenchBroom {
             AttributableNodeStringIndex m_nameIndex;
             AttributableNodeStringIndex m_valueIndex;
         public:
+            AttributableNodeIndex();
+
             void addAttributableNode(AttributableNode* attributable);
             void removeAttributableNode(AttributableNode* attributable);
 
             void addAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
+            void addAttribute(AttributableNode* attributable, const InternedString& name, const InternedString& value);
             void removeAttribute(AttributableNode* attributable, const AttributeName& name, const AttributeValue& value);
+            void removeAttribute(AttributableNode* attributable, const InternedString& name, const InternedString& value);
 
             AttributableNodeList findAttributableNodes(const AttributableNodeIndexQuery& keyQuery, const AttributeValue& value) const;
             StringList allNames() const;
@@ -21,6 +21,7 @@
 
 #include "CollectionUtils.h"
 #include "Constants.h"
+#include "ParallelUtils.h"
 #include "Polyhedron_Matcher.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
@@ -35,6 +36,7 @@
 #include "Model/PickResult.h"
 #include "Model/TagVisitor.h"
 #include "Model/World.h"
+#include "IO/NodeTextCache.h"
 #include "Renderer/BrushRendererBrushCache.h"
 
 #include <vecmath/intersection.h>
@@ -48,7 +50,9 @@
 #include <vecmath/util.h>
 
 #include <algorithm>
+#include <exception>
 #include <iterator>
+#include <limits>
 
 namespace TrenchBroom {
     namespace Model {
@@ -1173,23 +1177,55 @@ namespace TrenchBroom {
         }
 
         BrushList Brush::subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const String& defaultTextureName, const BrushList& subtrahends) const {
+            return createBrushes(factory, worldBounds, defaultTextureName, subtractGeometry(subtrahends), subtrahends);
+        }
+
+        std::vector<BrushList> Brush::subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const String& defaultTextureName, const BrushList& minuends, const BrushList& subtrahends) {
+            std::vector<std::list<BrushGeometry>> fragments(minuends.size());
+            ParallelUtils::parallelFor(minuends.size(), [&](const size_t i) {
+                fragments[i] = minuends[i]->subtractGeometry(subtrahends);
+            });
+
+            // creating brushes updates the usage counts of textures, which is not thread safe
+            std::vector<BrushList> result;
+            result.reserve(minuends.size());
+            for (size_t i = 0; i < minuends.size(); ++i) {
+                result.push_back(minuends[i]->createBrushes(factory, worldBounds, defaultTextureName, fragments[i], subtrahends));
+            }
+            return result;
+        }
+
+        std::list<BrushGeometry> Brush::subtractGeometry(const BrushList& subtrahends) const {
             auto result = std::list<BrushGeometry>{*m_geometry};
 
             for (auto* subtrahend : subtrahends) {
+                const auto& subtrahendBounds = subtrahend->logicalBounds();
+                if (!logicalBounds().intersects(subtrahendBounds)) {
+                    continue;
+                }
+
                 auto nextResults = std::list<BrushGeometry>();
 
                 for (const BrushGeometry& fragment : result) {
-                    const auto subFragments = fragment.subtract(*subtrahend->m_geometry);
-                    ListUtils::append(nextResults, subFragments);
+                    if (!fragment.bounds().intersects(subtrahendBounds)) {
+                        nextResults.push_back(fragment);
+                    } else {
+                        const auto subFragments = fragment.subtract(*subtrahend->m_geometry);
+                        ListUtils::append(nextResults, subFragments);
+                    }
                 }
 
                 result = nextResults;
             }
 
+            return result;
+        }
+
+        BrushList Brush::createBrushes(const ModelFactory& factory, const vm::bbox3& worldBounds, const String& defaultTextureName, const std::list<BrushGeometry>& fragments, const BrushList& subtrahends) const {
             BrushList brushes;
-            brushes.reserve(result.size());
+            brushes.reserve(fragments.size());
 
-            for (const auto& geometry : result) {
+            for (const auto& geometry : fragments) {
                 try {
                     auto* brush = createBrush(factory, worldBounds, defaultTextureName, geometry, subtrahends);
                     brushes.push_back(brush);
@@ -1212,17 +1248,30 @@ namespace TrenchBroom {
         }
 
         bool Brush::canTransform(const vm::mat4x4& transformation, const vm::bbox3& worldBounds) const {
-            auto* testBrush = clone(worldBounds);
-            bool result = true;
+            // Only the face planes matter here, so the faces are copied without their textures. Copying a texture
+            // would change its usage count, which must not happen on a worker thread.
+            BrushFaceList testFaces;
+            testFaces.reserve(m_faces.size());
 
             try {
-                testBrush->doTransform(transformation, false, worldBounds);
-            } catch (GeometryException&) {
-                result = false;
+                for (const auto* face : m_faces) {
+                    const auto& points = face->points();
+                    auto* testFace = BrushFace::createParaxial(points[0], points[1], points[2], face->textureName());
+                    testFaces.push_back(testFace);
+                    testFace->transform(transformation, false);
+                }
+            } catch (const GeometryException&) {
+                VectorUtils::clearAndDelete(testFaces);
+                return false;
             }
 
-            delete testBrush;
-            return result;
+            try {
+                // the test brush takes ownership of the faces
+                const Brush testBrush(worldBounds, testFaces);
+                return true;
+            } catch (const GeometryException&) {
+                return false;
+            }
         }
 
         Brush* Brush::createBrush(const ModelFactory& factory, const vm::bbox3& worldBounds, const String& defaultTextureName, const BrushGeometry& geometry, const BrushList& subtrahends) const {
@@ -1292,6 +1341,7 @@ namespace TrenchBroom {
 
             AddFacesToGeometry addFacesToGeometry(*m_geometry, m_faces);
             updateFacesFromGeometry(worldBounds, *m_geometry);
+            updateRayTestPlanes();
 
             if (addFacesToGeometry.brushEmpty()) {
                 throw GeometryException("Brush is empty");
@@ -1311,6 +1361,21 @@ namespace TrenchBroom {
             }
             delete m_geometry;
             m_geometry = nullptr;
+            m_rayTestPlanes.clear();
+        }
+
+        void Brush::updateRayTestPlanes() {
+            const auto count = m_faces.size();
+            m_rayTestPlanes.resize(4u * count);
+            m_rayTestPlanes.shrink_to_fit();
+
+            for (size_t i = 0; i < count; ++i) {
+                const auto& boundary = m_faces[i]->boundary();
+                m_rayTestPlanes[0u * count + i] = boundary.normal.x();
+                m_rayTestPlanes[1u * count + i] = boundary.normal.y();
+                m_rayTestPlanes[2u * count + i] = boundary.normal.z();
+                m_rayTestPlanes[3u * count + i] = boundary.distance;
+            }
         }
 
         bool Brush::checkGeometry() const {
@@ -1423,17 +1488,41 @@ namespace TrenchBroom {
         Brush::BrushFaceHit::BrushFaceHit(BrushFace* i_face, const FloatType i_distance) : face(i_face), distance(i_distance) {}
 
         Brush::BrushFaceHit Brush::findFaceHit(const vm::ray3& ray) const {
-            if (vm::is_nan(vm::intersect_ray_bbox(ray, logicalBounds()))) {
-                return BrushFaceHit();
+            const auto count = m_faces.size();
+            const auto* normalX = m_rayTestPlanes.data();
+            const auto* normalY = normalX + count;
+            const auto* normalZ = normalY + count;
+            const auto* distance = normalZ + count;
+
+            const auto& origin = ray.origin;
+            const auto& direction = ray.direction;
+
+            // the ray is inside of all half spaces for distances in [enter, exit]
+            auto enter = -std::numeric_limits<FloatType>::infinity();
+            auto exit = std::numeric_limits<FloatType>::infinity();
+            auto enterIndex = count;
+            auto outside = false;
+
+            // the loop has no early exits and only selects values, so that the compiler can vectorize it
+            for (size_t i = 0; i < count; ++i) {
+                const auto cos = normalX[i] * direction.x() + normalY[i] * direction.y() + normalZ[i] * direction.z();
+                const auto originDistance = normalX[i] * origin.x() + normalY[i] * origin.y() + normalZ[i] * origin.z() - distance[i];
+                const auto t = -originDistance / cos;
+
+                const auto entering = cos < FloatType(0.0);
+                const auto exiting = cos > FloatType(0.0);
+                if (entering && t > enter) {
+                    enter = t;
+                    enterIndex = i;
+                }
+                exit = exiting && t < exit ? t : exit;
+                outside = outside || (!entering && !exiting && originDistance > FloatType(0.0));
             }
 
-            for (auto* face : m_faces) {
-                const auto distance = face->intersectWithRay(ray);
-                if (!vm::is_nan(distance)) {
-                    return BrushFaceHit(face, distance);
-                }
+            if (outside || enterIndex == count || enter > exit || enter < FloatType(0.0)) {
+                return BrushFaceHit();
             }
-            return BrushFaceHit();
+            return BrushFaceHit(m_faces[enterIndex], enter);
         }
 
         Node* Brush::doGetContainer() const {
@@ -1457,11 +1546,51 @@ namespace TrenchBroom {
         void Brush::doTransform(const vm::mat4x4& transformation, bool lockTextures, const vm::bbox3& worldBounds) {
             const NotifyNodeChange nodeChange(this);
 
+            const vm::bbox3 oldBounds = physicalBounds();
+            transformFacesAndGeometry(transformation, lockTextures, worldBounds);
+            nodePhysicalBoundsDidChange(oldBounds);
+        }
+
+        void Brush::transformFacesAndGeometry(const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) {
             for (auto* face : m_faces) {
                 face->transform(transformation, lockTextures);
             }
 
-            rebuildGeometry(worldBounds);
+            deleteGeometry();
+            buildGeometry(worldBounds);
+        }
+
+        void Brush::transformBrushes(const BrushList& brushes, const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) {
+            std::vector<vm::bbox3> oldBounds;
+            oldBounds.reserve(brushes.size());
+            for (auto* brush : brushes) {
+                brush->nodeWillChange();
+                oldBounds.push_back(brush->physicalBounds());
+            }
+
+            // records which brushes were transformed, a vector<bool> cannot be written to concurrently
+            std::vector<char> transformed(brushes.size(), 0);
+            std::exception_ptr exception;
+            try {
+                ParallelUtils::parallelFor(brushes.size(), [&](const size_t i) {
+                    brushes[i]->transformFacesAndGeometry(transformation, lockTextures, worldBounds);
+                    transformed[i] = 1;
+                }, 16);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+
+            // notify in the same way as doTransform, even if a brush could not be transformed
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                if (transformed[i]) {
+                    brushes[i]->nodePhysicalBoundsDidChange(oldBounds[i]);
+                }
+                brushes[i]->nodeDidChange();
+            }
+
+            if (exception != nullptr) {
+                std::rethrow_exception(exception);
+            }
         }
 
         class Brush::Contains : public ConstNodeVisitor, public NodeQuery<bool> {
@@ -1534,12 +1663,22 @@ namespace TrenchBroom {
 
         void Brush::invalidateVertexCache() {
             m_brushRendererBrushCache->invalidateVertexCache();
+            if (m_faceTextCache != nullptr) {
+                m_faceTextCache->invalidate();
+            }
         }
 
         Renderer::BrushRendererBrushCache& Brush::brushRendererBrushCache() const {
             return *m_brushRendererBrushCache;
         }
 
+        IO::NodeTextCache& Brush::faceTextCache() const {
+            if (m_faceTextCache == nullptr) {
+                m_faceTextCache = std::make_unique<IO::NodeTextCache>();
+            }
+            return *m_faceTextCache;
+        }
+
         void Brush::initializeTags(TagManager& tagManager) {
             Taggable::initializeTags(tagManager);
             for (auto* face : m_faces) {
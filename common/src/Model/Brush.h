@@ -32,6 +32,7 @@
 #include <vecmath/vec.h>
 #include <vecmath/polygon.h>
 
+#include <list>
 #include <set>
 #include <vector>
 
@@ -39,6 +40,10 @@ template <typename P>
 class PolyhedronMatcher;
 
 namespace TrenchBroom {
+    namespace IO {
+        class NodeTextCache;
+    }
+
     namespace Renderer {
         class BrushRendererBrushCache;
     }
@@ -78,8 +83,16 @@ namespace TrenchBroom {
             BrushFaceList m_faces;
             BrushGeometry* m_geometry;
 
+            /**
+             * The boundary planes of the faces in the order of m_faces, stored as all x components of the normals,
+             * followed by all y components, all z components and all distances. Rays are intersected with these
+             * planes only, so picking doesn't have to traverse the geometry.
+             */
+            std::vector<FloatType> m_rayTestPlanes;
+
             mutable bool m_transparent;
             mutable std::unique_ptr<Renderer::BrushRendererBrushCache> m_brushRendererBrushCache; // unique_ptr for breaking header dependencies
+            mutable std::unique_ptr<IO::NodeTextCache> m_faceTextCache; // created when the brush is first written to a map file
         public:
             Brush(const vm::bbox3& worldBounds, const BrushFaceList& faces);
             ~Brush() override;
@@ -249,11 +262,54 @@ namespace TrenchBroom {
              */
             BrushList subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const String& defaultTextureName, const BrushList& subtrahends) const;
             BrushList subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const String& defaultTextureName, Brush* subtrahend) const;
+
+            /**
+             * Subtracts the given subtrahends from each of the given minuends without modifying any of them. The
+             * geometry of the results is computed in parallel, and the resulting brushes are created on the calling
+             * thread.
+             *
+             * @param minuends the brushes to subtract from
+             * @param subtrahends the brushes to subtract
+             * @return the subtraction results, one list for each minuend and in the order of the minuends
+             */
+            static std::vector<BrushList> subtract(const ModelFactory& factory, const vm::bbox3& worldBounds, const String& defaultTextureName, const BrushList& minuends, const BrushList& subtrahends);
             void intersect(const vm::bbox3& worldBounds, const Brush* brush);
 
             // transformation
+            /**
+             * Checks whether this brush can be transformed by the given transformation without becoming invalid. This
+             * does not modify this brush or any shared state and can be called from multiple threads at once.
+             */
             bool canTransform(const vm::mat4x4& transformation, const vm::bbox3& worldBounds) const;
+
+            /**
+             * Transforms each of the given brushes in the same way as Object::transform. The faces and geometries of
+             * the brushes are updated in parallel, and the change notifications for the brushes are sent on the
+             * calling thread before and after that.
+             *
+             * @param brushes the brushes to transform
+             * @param transformation the transformation to apply
+             * @param lockTextures whether to keep the textures locked to the faces
+             * @param worldBounds the world bounds
+             */
+            static void transformBrushes(const BrushList& brushes, const vm::mat4x4& transformation, bool lockTextures, const vm::bbox3& worldBounds);
         private:
+            /**
+             * Geometric step of CSG subtraction; subtracts the geometry of the given subtrahends from the geometry of
+             * `this`. Subtrahends that do not intersect the bounds of a fragment are skipped. This does not create
+             * any nodes and can be called from multiple threads at once.
+             *
+             * @param subtrahends the brushes to subtract
+             * @return the fragments that remain
+             */
+            std::list<BrushGeometry> subtractGeometry(const BrushList& subtrahends) const;
+
+            /**
+             * Creates a brush for each of the given fragments, see createBrush. Fragments that do not form a valid
+             * brush are dropped.
+             */
+            BrushList createBrushes(const ModelFactory& factory, const vm::bbox3& worldBounds, const String& defaultTextureName, const std::list<BrushGeometry>& fragments, const BrushList& subtrahends) const;
+
             /**
              * Final step of CSG subtraction; takes the geometry that is the result of the subtraction, and turns it
              * into a Brush by copying texturing from `this` (for un-clipped faces) or the brushes in `subtrahends`
@@ -275,6 +331,7 @@ namespace TrenchBroom {
         private:
             void buildGeometry(const vm::bbox3& worldBounds);
             void deleteGeometry();
+            void updateRayTestPlanes();
             bool checkGeometry() const;
         public:
             void findIntegerPlanePoints(const vm::bbox3& worldBounds);
@@ -308,6 +365,11 @@ namespace TrenchBroom {
                 BrushFaceHit(BrushFace* i_face, FloatType i_distance);
             };
 
+            /**
+             * Finds the face through which the given ray enters this brush by clipping the ray against the boundary
+             * planes of all faces. Since a brush is convex, the ray enters the brush through the face whose plane it
+             * crosses last when entering, provided that it hasn't left any half space before.
+             */
             BrushFaceHit findFaceHit(const vm::ray3& ray) const;
 
             Node* doGetContainer() const override;
@@ -316,6 +378,11 @@ namespace TrenchBroom {
 
             void doTransform(const vm::mat4x4& transformation, bool lockTextures, const vm::bbox3& worldBounds) override;
 
+            /**
+             * Transforms the faces of this brush and rebuilds its geometry without sending any notifications.
+             */
+            void transformFacesAndGeometry(const vm::mat4x4& transformation, bool lockTextures, const vm::bbox3& worldBounds);
+
             class Contains;
             bool doContains(const Node* node) const override;
 
@@ -327,6 +394,12 @@ namespace TrenchBroom {
              */
             void invalidateVertexCache();
             Renderer::BrushRendererBrushCache& brushRendererBrushCache() const;
+        public: // serializer cache
+            /**
+             * Returns the text that the faces of this brush were last written as by a map file serializer. The cache
+             * is invalidated together with the vertex cache, which happens whenever a face changes.
+             */
+            IO::NodeTextCache& faceTextCache() const;
         private: // implement Taggable interface
         public:
             void initializeTags(TagManager& tagManager) override;
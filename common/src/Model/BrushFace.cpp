@@ -124,6 +124,10 @@ namespace TrenchBroom {
             return m_texCoordSystem->takeSnapshot();
         }
 
+        std::unique_ptr<TexCoordSystem> BrushFace::cloneTexCoordSystem() const {
+            return m_texCoordSystem->clone();
+        }
+
         void BrushFace::restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot& coordSystemSnapshot) {
             coordSystemSnapshot.restore(*m_texCoordSystem);
             invalidateVertexCache();
@@ -329,6 +333,7 @@ namespace TrenchBroom {
             }
 
             m_attribs.setColor(color);
+            updateBrush();
             return true;
         }
 
@@ -630,6 +635,10 @@ namespace TrenchBroom {
             return m_lineNumber;
         }
 
+        size_t BrushFace::lineCount() const {
+            return m_lineCount;
+        }
+
         void BrushFace::setFilePosition(const size_t lineNumber, const size_t lineCount) {
             m_lineNumber = lineNumber;
             m_lineCount = lineCount;
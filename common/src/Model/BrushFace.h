@@ -106,6 +106,7 @@ namespace TrenchBroom {
 
             BrushFaceSnapshot* takeSnapshot();
             std::unique_ptr<TexCoordSystemSnapshot> takeTexCoordSystemSnapshot() const;
+            std::unique_ptr<TexCoordSystem> cloneTexCoordSystem() const;
             void restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot& coordSystemSnapshot);
             void copyTexCoordSystemFromFace(const TexCoordSystemSnapshot& coordSystemSnapshot, const BrushFaceAttributes& attribs, const vm::plane3& sourceFacePlane, WrapStyle wrapStyle);
 
@@ -196,6 +197,7 @@ namespace TrenchBroom {
             void invalidate();
 
             size_t lineNumber() const;
+            size_t lineCount() const;
             void setFilePosition(size_t lineNumber, size_t lineCount);
 
             bool selected() const;
@@ -19,32 +19,131 @@
 
 #include "BrushSnapshot.h"
 
-#include "CollectionUtils.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 
+#include <algorithm>
+#include <cassert>
+
 namespace TrenchBroom {
     namespace Model {
+        BrushSnapshot::FaceData::FaceData(const size_t i_index, const BrushFace* face) :
+        index(i_index),
+        points{ face->points()[0], face->points()[1], face->points()[2] },
+        attribs(face->attribs().takeSnapshot()),
+        coordSystemSnapshot(face->takeTexCoordSystemSnapshot()),
+        unchanged(false) {}
+
         BrushSnapshot::BrushSnapshot(Brush* brush) :
-        m_brush(brush) {
+        m_brush(brush),
+        m_faceCount(0) {
             takeSnapshot(brush);
         }
 
-        BrushSnapshot::~BrushSnapshot() {
-            VectorUtils::clearAndDelete(m_faces);
-        }
+        BrushSnapshot::~BrushSnapshot() = default;
 
         void BrushSnapshot::takeSnapshot(Brush* brush) {
-            for (BrushFace* face : brush->faces()) {
-                BrushFace *faceClone = face->clone();
-                faceClone->setTexture(nullptr);
-                m_faces.push_back(faceClone);
+            const auto& faces = brush->faces();
+            m_faceCount = faces.size();
+            m_faces.reserve(m_faceCount);
+            for (size_t i = 0; i < m_faceCount; ++i) {
+                m_faces.emplace_back(i, faces[i]);
             }
         }
 
         void BrushSnapshot::doRestore(const vm::bbox3& worldBounds) {
-            m_brush->setFaces(worldBounds, m_faces);
+            const auto& currentFaces = m_brush->faces();
+            assert(!currentFaces.empty());
+
+            BrushFaceList faces;
+            faces.reserve(m_faceCount);
+
+            auto data = std::begin(m_faces);
+            for (size_t i = 0; i < m_faceCount; ++i) {
+                if (data != std::end(m_faces) && data->index == i) {
+                    faces.push_back(createFace(*data, currentFaces.front()));
+                    ++data;
+                } else {
+                    // the face was discarded by compact(), so the brush still has the same number of faces and this
+                    // one is unchanged
+                    assert(currentFaces.size() == m_faceCount);
+                    auto* face = currentFaces[i]->clone();
+                    face->setTexture(nullptr);
+                    faces.push_back(face);
+                }
+            }
+
+            m_brush->setFaces(worldBounds, faces);
             m_faces.clear();
         }
+
+        void BrushSnapshot::doPrepareCompaction() {
+            const auto& currentFaces = m_brush->faces();
+            const auto sameFaceCount = currentFaces.size() == m_faceCount;
+            for (auto& data : m_faces) {
+                data.unchanged = sameFaceCount && isUnchanged(data, currentFaces[data.index]);
+            }
+        }
+
+        void BrushSnapshot::doCompact() {
+            const auto end = std::remove_if(std::begin(m_faces), std::end(m_faces), [](const FaceData& data) {
+                return data.unchanged;
+            });
+            m_faces.erase(end, std::end(m_faces));
+            m_faces.shrink_to_fit();
+        }
+
+        size_t BrushSnapshot::doGetMemorySize() const {
+            size_t result = sizeof(BrushSnapshot) + m_faces.capacity() * sizeof(FaceData);
+            for (const auto& data : m_faces) {
+                result += data.attribs.textureName().capacity();
+                if (data.coordSystemSnapshot != nullptr) {
+                    // a coordinate system snapshot stores at most two texture axes
+                    result += sizeof(TexCoordSystemSnapshot) + 2u * sizeof(vm::vec3);
+                }
+            }
+            return result;
+        }
+
+        static bool isEqual(const BrushFaceAttributes& lhs, const BrushFaceAttributes& rhs) {
+            return (lhs.textureName() == rhs.textureName() &&
+                    lhs.offset() == rhs.offset() &&
+                    lhs.scale() == rhs.scale() &&
+                    lhs.rotation() == rhs.rotation() &&
+                    lhs.surfaceContents() == rhs.surfaceContents() &&
+                    lhs.surfaceFlags() == rhs.surfaceFlags() &&
+                    lhs.surfaceValue() == rhs.surfaceValue() &&
+                    lhs.color() == rhs.color());
+        }
+
+        bool BrushSnapshot::isUnchanged(const FaceData& data, const BrushFace* face) {
+            const auto& points = face->points();
+            if (data.points[0] != points[0] || data.points[1] != points[1] || data.points[2] != points[2]) {
+                return false;
+            }
+
+            if (!isEqual(data.attribs, face->attribs())) {
+                return false;
+            }
+
+            if (data.coordSystemSnapshot != nullptr) {
+                auto coordSystem = face->cloneTexCoordSystem();
+                data.coordSystemSnapshot->restore(*coordSystem);
+                return coordSystem->xAxis() == face->textureXAxis() && coordSystem->yAxis() == face->textureYAxis();
+            }
+
+            // the texture coordinate system is computed from the points and attributes
+            return true;
+        }
+
+        BrushFace* BrushSnapshot::createFace(const FaceData& data, const BrushFace* prototype) {
+            // all faces of a brush use the same type of texture coordinate system
+            auto* face = new BrushFace(data.points[0], data.points[1], data.points[2], data.attribs, prototype->cloneTexCoordSystem());
+            face->resetTexCoordSystemCache();
+            if (data.coordSystemSnapshot != nullptr) {
+                face->restoreTexCoordSystemSnapshot(*data.coordSystemSnapshot);
+            }
+            return face;
+        }
     }
 }
@@ -20,26 +20,53 @@
 #ifndef TrenchBroom_BrushSnapshot
 #define TrenchBroom_BrushSnapshot
 
+#include "Model/BrushFaceAttributes.h"
 #include "Model/ModelTypes.h"
 #include "Model/NodeSnapshot.h"
+#include "Model/TexCoordSystem.h"
 
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom {
     namespace Model {
         class Brush;
-        class BrushFaceSnapshot;
+        class BrushFace;
 
+        /**
+         * Stores the face planes and attributes of a brush. Once the brush has been changed, the snapshot can be
+         * compacted so that it only stores the faces that differ from the state in which the change left the brush.
+         * The remaining faces are then copied from the brush when the snapshot is restored.
+         */
         class BrushSnapshot : public NodeSnapshot {
         private:
+            struct FaceData {
+                size_t index;
+                vm::vec3 points[3];
+                BrushFaceAttributes attribs;
+                // only set for texture coordinate systems that cannot be recomputed from the points and attributes
+                std::unique_ptr<TexCoordSystemSnapshot> coordSystemSnapshot;
+                // set by prepareCompaction() if the face is identical to the corresponding face of the brush
+                bool unchanged;
+
+                explicit FaceData(size_t index, const BrushFace* face);
+            };
+
             Brush* m_brush;
-            BrushFaceList m_faces;
+            size_t m_faceCount;
+            std::vector<FaceData> m_faces;
         public:
             BrushSnapshot(Brush* brush);
             ~BrushSnapshot() override;
         private:
             void takeSnapshot(Brush* brush);
             void doRestore(const vm::bbox3& worldBounds) override;
+            void doPrepareCompaction() override;
+            void doCompact() override;
+            size_t doGetMemorySize() const override;
+
+            static bool isUnchanged(const FaceData& data, const BrushFace* face);
+            static BrushFace* createFace(const FaceData& data, const BrushFace* prototype);
         };
     }
 }
@@ -20,6 +20,7 @@
 #include "Entity.h"
 
 #include "Assets/EntityModel.h"
+#include "Model/AssortNodesVisitor.h"
 #include "Model/BoundsContainsNodeVisitor.h"
 #include "Model/BoundsIntersectsNodeVisitor.h"
 #include "Model/Brush.h"
@@ -113,7 +114,7 @@ namespace TrenchBroom {
         }
 
         void Entity::cacheAttributes() {
-            m_cachedOrigin = vm::parse<FloatType, 3>(attribute(AttributeNames::Origin, ""), vm::vec3::zero());
+            m_cachedOrigin = vm::parse<FloatType, 3>(attribute(AttributeNames::OriginKey, ""), vm::vec3::zero());
             if (vm::is_nan(m_cachedOrigin)) {
                 m_cachedOrigin = vm::vec3::zero();
             }
@@ -179,7 +180,7 @@ namespace TrenchBroom {
         }
 
         NodeSnapshot* Entity::doTakeSnapshot() {
-            const EntityAttribute origin(AttributeNames::Origin, attribute(AttributeNames::Origin), nullptr);
+            const EntityAttribute origin(AttributeNames::Origin, attribute(AttributeNames::OriginKey), nullptr);
 
             const AttributeName rotationName = EntityRotationPolicy::getAttribute(this);
             const EntityAttribute rotation(rotationName, attribute(rotationName), nullptr);
@@ -346,29 +347,12 @@ namespace TrenchBroom {
             return visitor.hasResult() ? visitor.result() : nullptr;
         }
 
-        class TransformEntity : public NodeVisitor {
-        private:
-            const vm::mat4x4& m_transformation;
-            bool m_lockTextures;
-            const vm::bbox3& m_worldBounds;
-        public:
-            TransformEntity(const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) :
-            m_transformation(transformation),
-            m_lockTextures(lockTextures),
-            m_worldBounds(worldBounds) {}
-        private:
-            void doVisit(World* world) override   {}
-            void doVisit(Layer* layer) override   {}
-            void doVisit(Group* group) override   {}
-            void doVisit(Entity* entity) override {}
-            void doVisit(Brush* brush) override   { brush->transform(m_transformation, m_lockTextures, m_worldBounds); }
-        };
-
         void Entity::doTransform(const vm::mat4x4& transformation, const bool lockTextures, const vm::bbox3& worldBounds) {
             if (hasChildren()) {
                 const NotifyNodeChange nodeChange(this);
-                TransformEntity visitor(transformation, lockTextures, worldBounds);
-                iterate(visitor);
+                CollectBrushesVisitor collect;
+                iterate(collect);
+                Brush::transformBrushes(collect.brushes(), transformation, lockTextures, worldBounds);
             } else {
                 // node change is called by setOrigin already
                 const auto center = logicalBounds().center();
@@ -39,5 +39,18 @@ namespace TrenchBroom {
             else
                 node->addOrUpdateAttribute(m_name, m_value);
         }
+
+        size_t EntityAttributeSnapshot::memorySize(const Map& snapshots) {
+            // map and list nodes store three and two pointers, respectively
+            size_t result = 0;
+            for (const auto& entry : snapshots) {
+                result += sizeof(Map::value_type) + 3u * sizeof(void*);
+                for (const auto& snapshot : entry.second) {
+                    result += sizeof(EntityAttributeSnapshot) + 2u * sizeof(void*);
+                    result += snapshot.m_name.capacity() + snapshot.m_value.capacity();
+                }
+            }
+            return result;
+        }
     }
 }
@@ -40,6 +40,11 @@ namespace TrenchBroom {
             EntityAttributeSnapshot(const AttributeName& name);
 
             void restore(AttributableNode* node) const;
+
+            /**
+             * Returns an estimate of the number of bytes occupied by the given snapshots.
+             */
+            static size_t memorySize(const Map& snapshots);
         };
     }
 }
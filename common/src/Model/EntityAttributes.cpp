@@ -20,7 +20,9 @@
 #include "EntityAttributes.h"
 
 #include "Assets/EntityDefinition.h"
-#include "StringMap.h"
+#include "StringUtils.h"
+
+#include <iterator>
 
 namespace TrenchBroom {
     namespace Model {
@@ -50,6 +52,12 @@ namespace TrenchBroom {
             const AttributeName Group             = "_tb_group";
             const AttributeName Message           = "_tb_message";
             const AttributeName ValveVersion      = "mapversion";
+
+            const InternedString ClassnameKey(Classname);
+            const InternedString OriginKey(Origin);
+            const InternedString TargetKey(Target);
+            const InternedString TargetnameKey(Targetname);
+            const InternedString KilltargetKey(Killtarget);
         }
 
         namespace AttributeValues {
@@ -96,22 +104,39 @@ namespace TrenchBroom {
         m_value(value),
         m_definition(definition) {}
 
+        EntityAttribute::EntityAttribute(const InternedString& name, const InternedString& value, const Assets::AttributeDefinition* definition) :
+        m_name(name),
+        m_value(value),
+        m_definition(definition) {}
+
         bool EntityAttribute::operator<(const EntityAttribute& rhs) const {
             return compare(rhs) < 0;
         }
 
         int EntityAttribute::compare(const EntityAttribute& rhs) const {
-            const int nameCmp = m_name.compare(rhs.m_name);
-            if (nameCmp != 0)
-                return nameCmp;
-            return m_value.compare(rhs.m_value);
+            if (m_name != rhs.m_name) {
+                const int nameCmp = m_name.str().compare(rhs.m_name.str());
+                if (nameCmp != 0)
+                    return nameCmp;
+            }
+            if (m_value == rhs.m_value)
+                return 0;
+            return m_value.str().compare(rhs.m_value.str());
         }
 
         const AttributeName& EntityAttribute::name() const {
-            return m_name;
+            return m_name.str();
         }
 
         const AttributeValue& EntityAttribute::value() const {
+            return m_value.str();
+        }
+
+        const InternedString& EntityAttribute::internedName() const {
+            return m_name;
+        }
+
+        const InternedString& EntityAttribute::internedValue() const {
             return m_value;
         }
 
@@ -120,12 +145,14 @@ namespace TrenchBroom {
         }
 
         void EntityAttribute::setName(const AttributeName& name, const Assets::AttributeDefinition* definition) {
-            m_name = name;
+            if (name != m_name.str())
+                m_name = InternedString(name);
             m_definition = definition;
         }
 
         void EntityAttribute::setValue(const AttributeValue& value) {
-            m_value = value;
+            if (value != m_value.str())
+                m_value = InternedString(value);
         }
 
         bool isLayer(const String& classname, const EntityAttribute::List& attributes) {
@@ -154,9 +181,17 @@ namespace TrenchBroom {
             return defaultValue;
         }
 
+        const AttributeValue& findAttribute(const EntityAttribute::List& attributes, const InternedString& name, const AttributeValue& defaultValue) {
+            for (const EntityAttribute& attribute : attributes) {
+                if (name == attribute.internedName())
+                    return attribute.value();
+            }
+            return defaultValue;
+        }
+
         // EntityAttributes
 
-        EntityAttributes::EntityAttributes() : m_index(std::make_unique<AttributeIndex>()) {}
+        EntityAttributes::EntityAttributes() = default;
 
         EntityAttributes::~EntityAttributes() = default;
 
@@ -170,14 +205,19 @@ namespace TrenchBroom {
         }
 
         const EntityAttribute& EntityAttributes::addOrUpdateAttribute(const AttributeName& name, const AttributeValue& value, const Assets::AttributeDefinition* definition) {
-            EntityAttribute::List::iterator it = findAttribute(name);
-            if (it != std::end(m_attributes)) {
-                assert(it->definition() == definition);
-                it->setValue(value);
-                return *it;
+            const InternedString key(name);
+            const size_t index = findAttribute(key);
+            if (index < m_attributes.size()) {
+                EntityAttribute& attribute = m_attributes[index];
+                assert(attribute.definition() == definition);
+                attribute.setValue(value);
+                return attribute;
             } else {
-                m_attributes.push_back(EntityAttribute(name, value, definition));
-                m_index->insert(name, --std::end(m_attributes));
+                m_attributes.push_back(EntityAttribute(key, InternedString(value), definition));
+                if (m_index != nullptr)
+                    m_index->emplace(key, m_attributes.size() - 1u);
+                else if (m_attributes.size() > IndexThreshold)
+                    rebuildIndex();
                 return m_attributes.back();
             }
         }
@@ -195,8 +235,20 @@ namespace TrenchBroom {
             EntityAttribute::List::iterator it = findAttribute(name);
             if (it == std::end(m_attributes))
                 return;
-            m_index->remove(name, it);
+
+            const size_t index = static_cast<size_t>(std::distance(std::begin(m_attributes), it));
+            const InternedString key = it->internedName();
             m_attributes.erase(it);
+
+            if (m_attributes.size() <= IndexThreshold) {
+                m_index.reset();
+            } else if (m_index != nullptr) {
+                m_index->erase(key);
+                for (auto& entry : *m_index) {
+                    if (entry.second > index)
+                        --entry.second;
+                }
+            }
         }
 
         void EntityAttributes::updateDefinitions(const Assets::EntityDefinition* entityDefinition) {
@@ -211,6 +263,10 @@ namespace TrenchBroom {
             return findAttribute(name) != std::end(m_attributes);
         }
 
+        bool EntityAttributes::hasAttribute(const InternedString& name) const {
+            return findAttribute(name) < m_attributes.size();
+        }
+
         bool EntityAttributes::hasAttribute(const AttributeName& name, const AttributeValue& value) const {
             const EntityAttribute::List::const_iterator it = findAttribute(name);
             if (it == std::end(m_attributes))
@@ -219,44 +275,26 @@ namespace TrenchBroom {
         }
 
         bool EntityAttributes::hasAttributeWithPrefix(const AttributeName& prefix, const AttributeValue& value) const {
-            return containsValue(m_index->queryPrefixMatches(prefix), value);
+            for (const EntityAttribute& attribute : m_attributes) {
+                if (attribute.value() == value && StringUtils::isPrefix(attribute.name(), prefix))
+                    return true;
+            }
+            return false;
         }
 
         bool EntityAttributes::hasNumberedAttribute(const AttributeName& prefix, const AttributeValue& value) const {
-            return containsValue(m_index->queryNumberedMatches(prefix), value);
-        }
-
-        EntityAttributeSnapshot EntityAttributes::snapshot(const AttributeName& name) const {
-            const AttributeIndex::QueryResult matches = m_index->queryExactMatches(name);
-            if (matches.empty())
-                return EntityAttributeSnapshot(name);
-
-            assert(matches.size() == 1);
-            return EntityAttributeSnapshot(name, matches.front()->value());
-        }
-
-        bool EntityAttributes::containsValue(const std::vector<IndexValue>& matches, const AttributeValue& value) const {
-            if (matches.empty())
-                return false;
-
-            for (auto attrIt : matches) {
-                const EntityAttribute& attribute = *attrIt;
-                if (attribute.value() == value)
+            for (const EntityAttribute& attribute : m_attributes) {
+                if (attribute.value() == value && isNumberedAttribute(prefix, attribute.name()))
                     return true;
             }
-
             return false;
         }
 
-        EntityAttribute::List EntityAttributes::listFromQueryResult(const std::vector<IndexValue>& matches) const {
-            EntityAttribute::List result;
-
-            for (auto attrIt : matches) {
-                const EntityAttribute& attribute = *attrIt;
-                result.push_back(attribute);
-            }
-
-            return result;
+        EntityAttributeSnapshot EntityAttributes::snapshot(const AttributeName& name) const {
+            const EntityAttribute::List::const_iterator it = findAttribute(name);
+            if (it == std::end(m_attributes))
+                return EntityAttributeSnapshot(name);
+            return EntityAttributeSnapshot(name, it->value());
         }
 
         const AttributeNameSet EntityAttributes::names() const {
@@ -273,6 +311,13 @@ namespace TrenchBroom {
             return &it->value();
         }
 
+        const AttributeValue* EntityAttributes::attribute(const InternedString& name) const {
+            const size_t index = findAttribute(name);
+            if (index == m_attributes.size())
+                return nullptr;
+            return &m_attributes[index].value();
+        }
+
         const AttributeValue& EntityAttributes::safeAttribute(const AttributeName& name, const AttributeValue& defaultValue) const {
             const AttributeValue* value = attribute(name);
             if (value == nullptr)
@@ -281,11 +326,21 @@ namespace TrenchBroom {
         }
 
         EntityAttribute::List EntityAttributes::attributeWithName(const AttributeName& name) const {
-            return listFromQueryResult(m_index->queryExactMatches(name));
+            const EntityAttribute::List::const_iterator it = findAttribute(name);
+            if (it == std::end(m_attributes))
+                return EntityAttribute::List();
+            return EntityAttribute::List(1, *it);
         }
 
         EntityAttribute::List EntityAttributes::attributesWithPrefix(const AttributeName& prefix) const{
-            return listFromQueryResult(m_index->queryPrefixMatches(prefix));
+            EntityAttribute::List result;
+
+            for (const EntityAttribute& attribute : m_attributes) {
+                if (StringUtils::isPrefix(attribute.name(), prefix))
+                    result.push_back(attribute);
+            }
+
+            return result;
         }
 
         EntityAttribute::List EntityAttributes::numberedAttributes(const String& prefix) const {
@@ -300,30 +355,46 @@ namespace TrenchBroom {
         }
 
         EntityAttribute::List::const_iterator EntityAttributes::findAttribute(const AttributeName& name) const {
-            const AttributeIndex::QueryResult matches = m_index->queryExactMatches(name);
-            if (matches.empty())
+            // a name that is not in the string pool cannot be the name of any attribute
+            InternedString key;
+            if (!InternedString::find(name, key))
                 return std::end(m_attributes);
-
-            assert(matches.size() == 1);
-            return matches.front();
+            return std::next(std::begin(m_attributes), static_cast<std::ptrdiff_t>(findAttribute(key)));
         }
 
         EntityAttribute::List::iterator EntityAttributes::findAttribute(const AttributeName& name) {
-            const AttributeIndex::QueryResult matches = m_index->queryExactMatches(name);
-            if (matches.empty())
+            InternedString key;
+            if (!InternedString::find(name, key))
                 return std::end(m_attributes);
+            return std::next(std::begin(m_attributes), static_cast<std::ptrdiff_t>(findAttribute(key)));
+        }
+
+        size_t EntityAttributes::findAttribute(const InternedString& name) const {
+            if (m_index != nullptr) {
+                const auto it = m_index->find(name);
+                return it != std::end(*m_index) ? it->second : m_attributes.size();
+            }
 
-            assert(matches.size() == 1);
-            return matches.front();
+            for (size_t i = 0; i < m_attributes.size(); ++i) {
+                if (m_attributes[i].internedName() == name)
+                    return i;
+            }
+            return m_attributes.size();
         }
 
         void EntityAttributes::rebuildIndex() {
+            if (m_attributes.size() <= IndexThreshold) {
+                m_index.reset();
+                return;
+            }
+
+            if (m_index == nullptr)
+                m_index = std::make_unique<AttributeIndex>();
             m_index->clear();
+            m_index->reserve(m_attributes.size());
 
-            for (auto it = std::begin(m_attributes), end = std::end(m_attributes); it != end; ++it) {
-                const EntityAttribute& attribute = *it;
-                m_index->insert(attribute.name(), it);
-            }
+            for (size_t i = 0; i < m_attributes.size(); ++i)
+                m_index->emplace(m_attributes[i].internedName(), i);
         }
     }
 }
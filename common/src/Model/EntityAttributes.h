@@ -20,20 +20,17 @@
 #ifndef TrenchBroom_EntityProperties
 #define TrenchBroom_EntityProperties
 
+#include "InternedString.h"
+#include "Macros.h"
 #include "StringType.h"
 #include "Model/EntityAttributeSnapshot.h"
 #include "Model/ModelTypes.h"
 
-#include <list>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
-    template <typename V>
-    class StringMapValueContainer;
-
-    template <typename V, typename P>
-    class StringMap;
-
     namespace Assets {
         class EntityDefinition;
         class AttributeDefinition;
@@ -66,6 +63,16 @@ namespace TrenchBroom {
             extern const AttributeName Group;
             extern const AttributeName Message;
             extern const AttributeName ValveVersion;
+
+            /**
+             * Interned keys for the names that are looked up most often. Looking up an attribute by one of these
+             * does not have to search the string pool for the name first.
+             */
+            extern const InternedString ClassnameKey;
+            extern const InternedString OriginKey;
+            extern const InternedString TargetKey;
+            extern const InternedString TargetnameKey;
+            extern const InternedString KilltargetKey;
         }
 
         namespace AttributeValues {
@@ -82,20 +89,23 @@ namespace TrenchBroom {
 
         class EntityAttribute {
         public:
-            using List = std::list<EntityAttribute>;
+            using List = std::vector<EntityAttribute>;
             static const List EmptyList;
         private:
-            AttributeName m_name;
-            AttributeValue m_value;
+            InternedString m_name;
+            InternedString m_value;
             const Assets::AttributeDefinition* m_definition;
         public:
             EntityAttribute();
             EntityAttribute(const AttributeName& name, const AttributeValue& value, const Assets::AttributeDefinition* definition = nullptr);
+            EntityAttribute(const InternedString& name, const InternedString& value, const Assets::AttributeDefinition* definition = nullptr);
             bool operator<(const EntityAttribute& rhs) const;
             int compare(const EntityAttribute& rhs) const;
 
             const AttributeName& name() const;
             const AttributeValue& value() const;
+            const InternedString& internedName() const;
+            const InternedString& internedValue() const;
             const Assets::AttributeDefinition* definition() const;
 
             void setName(const AttributeName& name, const Assets::AttributeDefinition* definition);
@@ -106,19 +116,27 @@ namespace TrenchBroom {
         bool isGroup(const String& classname, const EntityAttribute::List& attributes);
         bool isWorldspawn(const String& classname, const EntityAttribute::List& attributes);
         const AttributeValue& findAttribute(const EntityAttribute::List& attributes, const AttributeName& name, const AttributeValue& defaultValue = EmptyString);
+        const AttributeValue& findAttribute(const EntityAttribute::List& attributes, const InternedString& name, const AttributeValue& defaultValue = EmptyString);
 
+        /**
+         * Stores the attributes of an entity in a contiguous list. Most entities have only a handful of attributes,
+         * and these are found by a linear scan that compares interned names. An index that maps names to positions
+         * is only built for entities that have more than IndexThreshold attributes.
+         */
         class EntityAttributes {
         private:
+            static const size_t IndexThreshold = 8;
+
             EntityAttribute::List m_attributes;
 
-            using IndexValue = EntityAttribute::List::iterator;
-            using IndexValueContainer = StringMapValueContainer<IndexValue>;
-            using AttributeIndex = StringMap<IndexValue, IndexValueContainer>;
+            using AttributeIndex = std::unordered_map<InternedString, size_t>;
             std::unique_ptr<AttributeIndex> m_index;
         public:
             explicit EntityAttributes();
             ~EntityAttributes();
 
+            deleteCopy(EntityAttributes)
+
             const EntityAttribute::List& attributes() const;
             void setAttributes(const EntityAttribute::List& attributes);
 
@@ -128,17 +146,16 @@ namespace TrenchBroom {
             void updateDefinitions(const Assets::EntityDefinition* entityDefinition);
 
             bool hasAttribute(const AttributeName& name) const;
+            bool hasAttribute(const InternedString& name) const;
             bool hasAttribute(const AttributeName& name, const AttributeValue& value) const;
             bool hasAttributeWithPrefix(const AttributeName& prefix, const AttributeValue& value) const;
             bool hasNumberedAttribute(const AttributeName& prefix, const AttributeValue& value) const;
 
             EntityAttributeSnapshot snapshot(const AttributeName& name) const;
-        private:
-            bool containsValue(const std::vector<IndexValue>& matches, const AttributeValue& value) const;
-            EntityAttribute::List listFromQueryResult(const std::vector<IndexValue>& matches) const;
         public:
             const AttributeNameSet names() const;
             const AttributeValue* attribute(const AttributeName& name) const;
+            const AttributeValue* attribute(const InternedString& name) const;
             const AttributeValue& safeAttribute(const AttributeName& name, const AttributeValue& defaultValue) const;
 
             EntityAttribute::List attributeWithName(const AttributeName& name) const;
@@ -147,6 +164,11 @@ namespace TrenchBroom {
         private:
             EntityAttribute::List::const_iterator findAttribute(const AttributeName& name) const;
             EntityAttribute::List::iterator findAttribute(const AttributeName& name);
+            /**
+             * Returns the position of the attribute with the given name, or the number of attributes if there is no
+             * such attribute.
+             */
+            size_t findAttribute(const InternedString& name) const;
 
             void rebuildIndex();
         };
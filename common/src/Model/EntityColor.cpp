@@ -19,6 +19,8 @@
 
 #include "EntityColor.h"
 
+#include "StringStream.h"
+#include "StringUtils.h"
 #include "Model/AttributableNode.h"
 #include "Assets/ColorRange.h"
 #include "Model/Entity.h"
@@ -167,7 +167,7 @@ namespace TrenchBroom {
                         // spotlight without a target, update mangle
                         type = RotationType_Mangle;
                         attribute = AttributeNames::Mangle;
-                    } else if (!entity->hasAttribute(AttributeNames::Target)) {
+                    } else if (!entity->hasAttribute(AttributeNames::TargetKey)) {
                         // not a spotlight, but might have a rotatable model, so change angle or angles
                         if (entity->hasAttribute(AttributeNames::Angles)) {
                             type = RotationType_Euler;
@@ -0,0 +1,78 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EstimateMemorySizeVisitor.h"
+
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/Node.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        EstimateMemorySizeVisitor::EstimateMemorySizeVisitor() :
+        m_result(0) {}
+
+        size_t EstimateMemorySizeVisitor::result() const {
+            return m_result;
+        }
+
+        void EstimateMemorySizeVisitor::doVisit(const World* world) {
+            m_result += sizeof(World);
+        }
+
+        void EstimateMemorySizeVisitor::doVisit(const Layer* layer) {
+            m_result += sizeof(Layer) + layer->name().capacity();
+        }
+
+        void EstimateMemorySizeVisitor::doVisit(const Group* group) {
+            m_result += sizeof(Group) + group->name().capacity();
+        }
+
+        void EstimateMemorySizeVisitor::doVisit(const Entity* entity) {
+            m_result += sizeof(Entity);
+            for (const auto& attribute : entity->attributes()) {
+                // names and values are interned, but values such as origins are rarely shared
+                m_result += sizeof(EntityAttribute) + attribute.value().size();
+            }
+        }
+
+        void EstimateMemorySizeVisitor::doVisit(const Brush* brush) {
+            m_result += sizeof(Brush);
+            m_result += brush->faceCount() * (sizeof(BrushFace) + sizeof(BrushFaceGeometry));
+            m_result += brush->vertexCount() * sizeof(BrushVertex);
+            // every edge consists of two half edges
+            m_result += brush->edgeCount() * (sizeof(BrushEdge) + 2u * sizeof(BrushHalfEdge));
+        }
+
+        size_t estimateMemorySize(const ParentChildrenMap& nodes) {
+            EstimateMemorySizeVisitor visitor;
+            for (const auto& entry : nodes) {
+                const NodeList& children = entry.second;
+                Node::acceptAndRecurse(std::begin(children), std::end(children), visitor);
+            }
+            return visitor.result();
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_EstimateMemorySizeVisitor
+#define TrenchBroom_EstimateMemorySizeVisitor
+
+#include "TrenchBroom.h"
+#include "Model/ModelTypes.h"
+#include "Model/NodeVisitor.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Estimates the number of bytes occupied by the visited nodes. This is used to account for nodes that are
+         * owned by undoable commands, so it does not need to be exact.
+         */
+        class EstimateMemorySizeVisitor : public ConstNodeVisitor {
+        private:
+            size_t m_result;
+        public:
+            EstimateMemorySizeVisitor();
+            size_t result() const;
+        private:
+            void doVisit(const World* world) override;
+            void doVisit(const Layer* layer) override;
+            void doVisit(const Group* group) override;
+            void doVisit(const Entity* entity) override;
+            void doVisit(const Brush* brush) override;
+        };
+
+        /**
+         * Estimates the number of bytes occupied by the given children and their descendants.
+         */
+        size_t estimateMemorySize(const ParentChildrenMap& nodes);
+    }
+}
+
+#endif /* defined(TrenchBroom_EstimateMemorySizeVisitor) */
@@ -73,6 +73,10 @@ namespace TrenchBroom {
             doWriteMap(world, path);
         }
 
+        void Game::serializeMap(World& world, IO::MapTextSnapshot& snapshot) const {
+            doSerializeMap(world, snapshot);
+        }
+
         void Game::exportMap(World& world, const Model::ExportFormat format, const IO::Path& path) const {
             doExportMap(world, format, path);
         }
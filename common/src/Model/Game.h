@@ -39,6 +39,10 @@ namespace TrenchBroom {
         class TextureManager;
     }
 
+    namespace IO {
+        class MapTextSnapshot;
+    }
+
     namespace Model {
         class SmartTag;
 
@@ -68,6 +72,7 @@ namespace TrenchBroom {
             std::unique_ptr<World> newMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const;
             std::unique_ptr<World> loadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const;
             void writeMap(World& world, const IO::Path& path) const;
+            void serializeMap(World& world, IO::MapTextSnapshot& snapshot) const;
             void exportMap(World& world, Model::ExportFormat format, const IO::Path& path) const;
         public: // parsing and serializing objects
             NodeList parseNodes(const String& str, World& world, const vm::bbox3& worldBounds, Logger& logger) const;
@@ -110,6 +115,7 @@ namespace TrenchBroom {
             virtual std::unique_ptr<World> doNewMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const = 0;
             virtual std::unique_ptr<World> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const = 0;
             virtual void doWriteMap(World& world, const IO::Path& path) const = 0;
+            virtual void doSerializeMap(World& world, IO::MapTextSnapshot& snapshot) const = 0;
             virtual void doExportMap(World& world, Model::ExportFormat format, const IO::Path& path) const = 0;
 
             virtual NodeList doParseNodes(const String& str, World& world, const vm::bbox3& worldBounds, Logger& logger) const = 0;
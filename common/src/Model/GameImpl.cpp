@@ -20,6 +20,8 @@
 #include "GameImpl.h"
 
 #include "Macros.h"
+#include "PreferenceManager.h"
+#include "Preferences.h"
 #include "Assets/Palette.h"
 #include "IO/AseParser.h"
 #include "IO/BrushFaceReader.h"
@@ -33,6 +35,7 @@
 #include "IO/FileMatcher.h"
 #include "IO/FileSystem.h"
 #include "IO/IOUtils.h"
+#include "IO/MapTextSnapshot.h"
 #include "IO/MdlParser.h"
 #include "IO/Md2Parser.h"
 #include "IO/Md3Parser.h"
@@ -54,6 +57,8 @@
 
 #include "Exceptions.h"
 
+#include <algorithm>
+
 namespace TrenchBroom {
     namespace Model {
         GameImpl::GameImpl(GameConfig& config, const IO::Path& gamePath, Logger& logger) :
@@ -132,7 +137,7 @@ namespace TrenchBroom {
 
         std::unique_ptr<World> GameImpl::doLoadMap(const MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const {
             IO::SimpleParserStatus parserStatus(logger);
-            auto file = IO::Disk::openFile(IO::Disk::fixPath(path));
+            auto file = IO::Disk::mapFile(IO::Disk::fixPath(path));
             auto fileReader = file->reader().buffer();
             IO::WorldReader worldReader(std::begin(fileReader), std::end(fileReader));
             return worldReader.read(format, worldBounds, parserStatus);
@@ -148,6 +153,17 @@ namespace TrenchBroom {
             writer.writeMap();
         }
 
+        void GameImpl::doSerializeMap(World& world, IO::MapTextSnapshot& snapshot) const {
+            const auto mapFormatName = formatName(world.format());
+
+            String comment;
+            IO::writeGameComment(comment, gameName(), mapFormatName);
+            snapshot.append(std::move(comment));
+
+            IO::NodeWriter writer(world, snapshot);
+            writer.writeMap();
+        }
+
         void GameImpl::doExportMap(World& world, const Model::ExportFormat format, const IO::Path& path) const {
             switch (format) {
                 case Model::WavefrontObj:
@@ -196,6 +212,10 @@ namespace TrenchBroom {
 
             const auto fileSearchPaths = textureCollectionSearchPaths(documentPath);
             IO::TextureLoader textureLoader(m_fs, fileSearchPaths, m_config.textureConfig(), logger);
+            if (pref(Preferences::TextureCacheEnabled)) {
+                const auto sizeLimit = static_cast<size_t>(std::max(0, pref(Preferences::TextureCacheSize))) * 1024u * 1024u;
+                textureLoader.enableCache(IO::SystemPaths::userDataDirectory() + IO::Path("TextureCache"), sizeLimit);
+            }
             textureLoader.loadTextures(paths, textureManager);
         }
 
@@ -47,5 +47,25 @@ namespace TrenchBroom {
             for (NodeSnapshot* snapshot : m_snapshots)
                 snapshot->restore(worldBounds);
         }
+
+        void GroupSnapshot::doPrepareCompaction() {
+            for (NodeSnapshot* snapshot : m_snapshots) {
+                snapshot->prepareCompaction();
+            }
+        }
+
+        void GroupSnapshot::doCompact() {
+            for (NodeSnapshot* snapshot : m_snapshots) {
+                snapshot->compact();
+            }
+        }
+
+        size_t GroupSnapshot::doGetMemorySize() const {
+            size_t result = sizeof(GroupSnapshot) + m_snapshots.capacity() * sizeof(NodeSnapshot*);
+            for (const NodeSnapshot* snapshot : m_snapshots) {
+                result += snapshot->memorySize();
+            }
+            return result;
+        }
     }
 }
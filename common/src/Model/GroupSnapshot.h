@@ -38,6 +38,9 @@ namespace TrenchBroom {
         private:
             void takeSnapshot(Group* group);
             void doRestore(const vm::bbox3& worldBounds) override;
+            void doPrepareCompaction() override;
+            void doCompact() override;
+            size_t doGetMemorySize() const override;
         };
     }
 }
@@ -25,6 +25,8 @@
 #include "Model/EditorContext.h"
 #include "Model/Node.h"
 
+#include <atomic>
+
 namespace TrenchBroom {
     namespace Model {
         Issue::~Issue() = default;
@@ -86,7 +88,7 @@ namespace TrenchBroom {
         }
 
         size_t Issue::nextSeqId() {
-            static size_t seqId = 0;
+            static std::atomic<size_t> seqId(0);
             return seqId++;
         }
 
@@ -44,6 +44,10 @@ namespace TrenchBroom {
             return m_quickFixes;
         }
 
+        bool IssueGenerator::isThreadSafe() const {
+            return doIsThreadSafe();
+        }
+
         void IssueGenerator::generate(World* world, IssueList& issues) const {
             doGenerate(world, issues);
         }
@@ -74,6 +78,10 @@ namespace TrenchBroom {
             m_quickFixes.push_back(quickFix);
         }
 
+        bool IssueGenerator::doIsThreadSafe() const {
+            return true;
+        }
+
         void IssueGenerator::doGenerate(World* world,           IssueList& issues) const { doGenerate(static_cast<AttributableNode*>(world), issues); }
         void IssueGenerator::doGenerate(Layer* layer,           IssueList& issues) const {}
         void IssueGenerator::doGenerate(Group* group,           IssueList& issues) const {}
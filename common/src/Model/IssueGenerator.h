@@ -53,6 +53,14 @@ namespace TrenchBroom {
             const String& description() const;
             const IssueQuickFixList& quickFixes() const;
 
+            /**
+             * Indicates whether this generator may generate the issues of distinct nodes concurrently. A generator is
+             * thread safe if it only reads the node it generates issues for and keeps no state of its own. Generators
+             * that query other nodes, e.g. through the attribute index of the world, or that remember what they
+             * generated before are not thread safe, and their issues are always generated on the calling thread.
+             */
+            bool isThreadSafe() const;
+
             void generate(World* world,   IssueList& issues) const;
             void generate(Layer* layer,   IssueList& issues) const;
             void generate(Group* group,   IssueList& issues) const;
@@ -62,6 +70,8 @@ namespace TrenchBroom {
             IssueGenerator(IssueType type, const String& description);
             void addQuickFix(IssueQuickFix* quickFix);
         private:
+            virtual bool doIsThreadSafe() const;
+
             virtual void doGenerate(World* world,           IssueList& issues) const;
             virtual void doGenerate(Layer* layer,           IssueList& issues) const;
             virtual void doGenerate(Group* group,           IssueList& issues) const;
@@ -81,6 +81,11 @@ namespace TrenchBroom {
             addQuickFix(new LinkTargetIssueQuickFix());
         }
 
+        bool LinkTargetIssueGenerator::doIsThreadSafe() const {
+            // looks up the link targets in the attribute index of the world
+            return false;
+        }
+
         void LinkTargetIssueGenerator::doGenerate(AttributableNode* node, IssueList& issues) const {
             processKeys(node, node->findMissingLinkTargets(), issues);
             processKeys(node, node->findMissingKillTargets(), issues);
@@ -32,6 +32,7 @@ namespace TrenchBroom {
         public:
             LinkTargetIssueGenerator();
         private:
+            bool doIsThreadSafe() const override;
             void doGenerate(AttributableNode* node, IssueList& issues) const override;
             void processKeys(AttributableNode* node, const Model::AttributeNameList& names, IssueList& issues) const;
         };
@@ -64,7 +64,7 @@ namespace TrenchBroom {
         }
 
         void MissingClassnameIssueGenerator::doGenerate(AttributableNode* node, IssueList& issues) const {
-            if (!node->hasAttribute(AttributeNames::Classname))
+            if (!node->hasAttribute(AttributeNames::ClassnameKey))
                 issues.push_back(new MissingClassnameIssue(node));
         }
     }
@@ -95,6 +95,11 @@ namespace TrenchBroom {
             addQuickFix(new MissingModIssueQuickFix());
         }
 
+        bool MissingModIssueGenerator::doIsThreadSafe() const {
+            // remembers the mods it has checked last
+            return false;
+        }
+
         void MissingModIssueGenerator::doGenerate(AttributableNode* node, IssueList& issues) const {
             assert(node != nullptr);
 
@@ -36,6 +36,7 @@ namespace TrenchBroom {
         public:
             MissingModIssueGenerator(GameWPtr game);
         private:
+            bool doIsThreadSafe() const override;
             void doGenerate(AttributableNode* node, IssueList& issues) const override;
         };
     }
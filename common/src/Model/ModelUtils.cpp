@@ -18,6 +18,8 @@
  */
 
 #include "ModelUtils.h"
+
+#include "CollectionUtils.h"
 #include "Model/CollectNodesVisitor.h"
 
 namespace TrenchBroom {
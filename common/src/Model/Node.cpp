@@ -26,9 +26,13 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
+#include <utility>
 
 namespace TrenchBroom {
     namespace Model {
+        const size_t Node::NoPendingNodeTreeUpdate = std::numeric_limits<size_t>::max();
+
         Node::Node() :
         m_parent(nullptr),
         m_descendantCount(0),
@@ -40,7 +44,8 @@ namespace TrenchBroom {
         m_lineNumber(0),
         m_lineCount(0),
         m_issuesValid(false),
-        m_hiddenIssues(0) {}
+        m_hiddenIssues(0),
+        m_pendingNodeTreeUpdateIndex(NoPendingNodeTreeUpdate) {}
 
         Node::~Node() {
             clearChildren();
@@ -594,13 +599,28 @@ namespace TrenchBroom {
 
         void Node::validateIssues(const IssueGeneratorList& issueGenerators) {
             if (!m_issuesValid) {
-                for (const auto* generator : issueGenerators) {
-                    doGenerateIssues(generator, m_issues);
-                }
-                m_issuesValid = true;
+                IssueList issues;
+                generateIssues(issueGenerators, issues);
+                setIssues(std::move(issues));
             }
         }
 
+        bool Node::issuesValid() const {
+            return m_issuesValid;
+        }
+
+        void Node::generateIssues(const IssueGeneratorList& issueGenerators, IssueList& issues) {
+            for (const auto* generator : issueGenerators) {
+                doGenerateIssues(generator, issues);
+            }
+        }
+
+        void Node::setIssues(IssueList issues) {
+            clearIssues();
+            m_issues = std::move(issues);
+            m_issuesValid = true;
+        }
+
         void Node::invalidateIssues() const {
             clearIssues();
             m_issuesValid = false;
@@ -610,6 +630,14 @@ namespace TrenchBroom {
             VectorUtils::clearAndDelete(m_issues);
         }
 
+        size_t Node::pendingNodeTreeUpdateIndex() const {
+            return m_pendingNodeTreeUpdateIndex;
+        }
+
+        void Node::setPendingNodeTreeUpdateIndex(const size_t index) {
+            m_pendingNodeTreeUpdateIndex = index;
+        }
+
         void Node::findAttributableNodesWithAttribute(const AttributeName& name, const AttributeValue& value, AttributableNodeList& result) const {
             return doFindAttributableNodesWithAttribute(name, value, result);
         }
@@ -47,6 +47,14 @@ namespace TrenchBroom {
             mutable IssueList m_issues;
             mutable bool m_issuesValid;
             IssueType m_hiddenIssues;
+
+            /**
+             * The position of this node in the world's list of deferred node tree updates, or NoPendingNodeTreeUpdate
+             * if no update of this node is pending.
+             */
+            size_t m_pendingNodeTreeUpdateIndex;
+        public:
+            static const size_t NoPendingNodeTreeUpdate;
         protected:
             Node();
         private:
@@ -270,10 +278,35 @@ namespace TrenchBroom {
 
             bool issueHidden(IssueType type) const;
             void setIssueHidden(IssueType type, bool hidden);
+            /**
+             * Generates the issues of this node using the given generators unless they are still valid.
+             */
+            void validateIssues(const IssueGeneratorList& issueGenerators);
+            bool issuesValid() const;
+            /**
+             * Generates the issues of this node using the given generators and appends them to the given list. The
+             * issues of this node are not changed.
+             *
+             * If all of the given generators are thread safe, this may be called concurrently for distinct nodes as
+             * long as the node tree is not modified at the same time.
+             */
+            void generateIssues(const IssueGeneratorList& issueGenerators, IssueList& issues);
+            /**
+             * Replaces the issues of this node with the given issues, which this node takes ownership of, and marks
+             * them as valid.
+             */
+            void setIssues(IssueList issues);
         public: // should only be called from this and from the world
+            /**
+             * Deletes the issues of this node and marks them as invalid. Issues may refer to parts of this node, such
+             * as brush faces, which might be deleted once this node changes, so they must not outlive the change. The
+             * issues are only generated again when they are validated next.
+             */
             void invalidateIssues() const;
+
+            size_t pendingNodeTreeUpdateIndex() const;
+            void setPendingNodeTreeUpdateIndex(size_t index);
         private:
-            void validateIssues(const IssueGeneratorList& issueGenerators);
             void clearIssues() const;
         public: // visitors
             template <class V>
@@ -26,5 +26,20 @@ namespace TrenchBroom {
         void NodeSnapshot::restore(const vm::bbox3& worldBounds) {
             doRestore(worldBounds);
         }
+
+        void NodeSnapshot::prepareCompaction() {
+            doPrepareCompaction();
+        }
+
+        void NodeSnapshot::compact() {
+            doCompact();
+        }
+
+        size_t NodeSnapshot::memorySize() const {
+            return doGetMemorySize();
+        }
+
+        void NodeSnapshot::doPrepareCompaction() {}
+        void NodeSnapshot::doCompact() {}
     }
 }
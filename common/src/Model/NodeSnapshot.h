@@ -32,8 +32,29 @@ namespace TrenchBroom {
         public:
             virtual ~NodeSnapshot();
             void restore(const vm::bbox3& worldBounds);
+
+            /**
+             * Determines the parts of this snapshot that are identical to the current state of the snapshotted node.
+             * This must only be called while the node is in the state in which it will be when this snapshot is
+             * restored.
+             */
+            void prepareCompaction();
+
+            /**
+             * Discards the parts of this snapshot that were found to be redundant by the last call to
+             * prepareCompaction(). The node may have been changed since then.
+             */
+            void compact();
+
+            /**
+             * Returns an estimate of the number of bytes occupied by this snapshot.
+             */
+            size_t memorySize() const;
         private:
             virtual void doRestore(const vm::bbox3& worldBounds) = 0;
+            virtual void doPrepareCompaction();
+            virtual void doCompact();
+            virtual size_t doGetMemorySize() const = 0;
         };
     }
 }
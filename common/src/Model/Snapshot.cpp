@@ -41,6 +41,27 @@ namespace TrenchBroom {
                 snapshot->restore();
         }
 
+        void Snapshot::prepareCompaction() {
+            for (NodeSnapshot* snapshot : m_nodeSnapshots) {
+                snapshot->prepareCompaction();
+            }
+        }
+
+        void Snapshot::compact() {
+            for (NodeSnapshot* snapshot : m_nodeSnapshots) {
+                snapshot->compact();
+            }
+        }
+
+        size_t Snapshot::memorySize() const {
+            size_t result = sizeof(Snapshot);
+            for (const NodeSnapshot* snapshot : m_nodeSnapshots) {
+                result += sizeof(NodeSnapshot*) + snapshot->memorySize();
+            }
+            result += m_brushFaceSnapshots.size() * (sizeof(BrushFaceSnapshot*) + sizeof(BrushFaceSnapshot));
+            return result;
+        }
+
         void Snapshot::takeSnapshot(Node* node) {
             NodeSnapshot* snapshot = node->takeSnapshot();
             if (snapshot != nullptr)
@@ -46,6 +46,24 @@ namespace TrenchBroom {
 
             void restoreNodes(const vm::bbox3& worldBounds);
             void restoreBrushFaces();
+
+            /**
+             * Determines the parts of the node snapshots that are identical to the current state of their nodes. This
+             * must only be called while the nodes are in the state in which they will be when this snapshot is
+             * restored.
+             */
+            void prepareCompaction();
+
+            /**
+             * Discards the parts of the node snapshots that were found to be redundant by the last call to
+             * prepareCompaction().
+             */
+            void compact();
+
+            /**
+             * Returns an estimate of the number of bytes occupied by this snapshot.
+             */
+            size_t memorySize() const;
         private:
             void takeSnapshot(Node* node);
             void takeSnapshot(BrushFace* face);
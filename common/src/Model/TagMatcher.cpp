@@ -19,6 +19,8 @@
 
 #include "TagMatcher.h"
 
+#include "CollectionUtils.h"
+#include "StringUtils.h"
 #include "Assets/EntityDefinitionManager.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureManager.h"
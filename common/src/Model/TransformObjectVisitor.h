@@ -21,17 +21,25 @@
 #define TrenchBroom_TransformObjectVisitor
 
 #include "TrenchBroom.h"
+#include "Model/ModelTypes.h"
 #include "Model/NodeVisitor.h"
 
 namespace TrenchBroom {
     namespace Model {
+        /**
+         * Transforms the visited groups and entities immediately. The visited brushes are only collected so that they
+         * can be transformed in parallel by calling transformBrushes once the visitor is done.
+         */
         class TransformObjectVisitor : public NodeVisitor {
         private:
             const vm::mat4x4& m_transformation;
             bool m_lockTextures;
             const vm::bbox3& m_worldBounds;
+            BrushList m_brushes;
         public:
             TransformObjectVisitor(const vm::mat4x4& transformation, bool lockTextures, const vm::bbox3& worldBounds);
+
+            void transformBrushes();
         private:
             void doVisit(World* world) override;
             void doVisit(Layer* layer) override;
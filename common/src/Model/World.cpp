@@ -20,20 +20,27 @@
 #include "World.h"
 
 #include "AABBTree.h"
+#include "CollectionUtils.h"
+#include "HalfSpaceUtils.h"
 #include "Model/AssortNodesVisitor.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/CollectNodesWithDescendantSelectionCountVisitor.h"
 #include "Model/IssueGenerator.h"
+#include "Model/PickResult.h"
 #include "Model/TagVisitor.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace TrenchBroom {
     namespace Model {
         World::World(MapFormat mapFormat, const vm::bbox3& worldBounds) :
         m_factory(mapFormat),
         m_defaultLayer(nullptr),
         m_nodeTree(std::make_unique<NodeTree>()),
-        m_updateNodeTree(true) {
+        m_updateNodeTree(true),
+        m_deferNodeTreeUpdates(false) {
             addOrUpdateAttribute(AttributeNames::Classname, AttributeValues::WorldspawnClassname);
             createDefaultLayer(worldBounds);
         }
@@ -102,9 +109,11 @@ namespace TrenchBroom {
         class World::RemoveNodeFromNodeTree : public NodeVisitor {
         private:
             NodeTree& m_nodeTree;
+            NodeList& m_pendingNodes;
         public:
-            explicit RemoveNodeFromNodeTree(NodeTree& nodeTree) :
-            m_nodeTree(nodeTree) {}
+            RemoveNodeFromNodeTree(NodeTree& nodeTree, NodeList& pendingNodes) :
+            m_nodeTree(nodeTree),
+            m_pendingNodes(pendingNodes) {}
         private:
             void doVisit(World* world) override   {}
             void doVisit(Layer* layer) override   {}
@@ -113,6 +122,16 @@ namespace TrenchBroom {
             void doVisit(Brush* brush) override   { doRemove(brush, brush->physicalBounds()); }
 
             void doRemove(Node* node, const vm::bbox3& bounds) {
+                const auto pendingIndex = node->pendingNodeTreeUpdateIndex();
+                if (pendingIndex != Node::NoPendingNodeTreeUpdate) {
+                    m_pendingNodes[pendingIndex] = nullptr;
+                    node->setPendingNodeTreeUpdateIndex(Node::NoPendingNodeTreeUpdate);
+
+                    // a node that was added while the node tree updates were deferred is not in the tree yet
+                    if (!m_nodeTree.contains(node)) {
+                        return;
+                    }
+                }
                 if (!m_nodeTree.remove(node)) {
                     NodeTreeException ex;
                     ex << "Node not found with bounds [ (" << bounds.min << ") (" << bounds.max << ") ]: " << node;
@@ -135,12 +154,35 @@ namespace TrenchBroom {
             void doVisit(Brush* brush) override   { m_nodeTree.update(brush->physicalBounds(), brush); }
         };
 
+        class World::AddNodeToPendingNodeTreeUpdates : public NodeVisitor {
+        private:
+            NodeList& m_pendingNodes;
+        public:
+            explicit AddNodeToPendingNodeTreeUpdates(NodeList& pendingNodes) :
+            m_pendingNodes(pendingNodes) {}
+        private:
+            void doVisit(World* world) override   {}
+            void doVisit(Layer* layer) override   {}
+            void doVisit(Group* group) override   {}
+            void doVisit(Entity* entity) override { addPending(entity); }
+            void doVisit(Brush* brush) override   { addPending(brush); }
+
+            void addPending(Node* node) {
+                if (node->pendingNodeTreeUpdateIndex() == Node::NoPendingNodeTreeUpdate) {
+                    node->setPendingNodeTreeUpdateIndex(m_pendingNodes.size());
+                    m_pendingNodes.push_back(node);
+                }
+            }
+        };
+
         class World::MatchTreeNodes {
         public:
             bool operator()(const Model::Node* node) const   { return node->shouldAddToSpacialIndex(); }
         };
 
         void World::disableNodeTreeUpdates() {
+            // the node tree will be rebuilt, and the pending nodes might be deleted in the meantime
+            discardPendingNodeTreeUpdates();
             m_updateNodeTree = false;
         }
 
@@ -154,9 +196,94 @@ namespace TrenchBroom {
             CollectTreeNodes collect;
             acceptAndRecurse(collect);
 
+            discardPendingNodeTreeUpdates();
             m_nodeTree->clearAndBuild(collect.nodes(), [](const auto* node){ return node->physicalBounds(); });
         }
 
+        void World::deferNodeTreeUpdates() {
+            m_deferNodeTreeUpdates = true;
+        }
+
+        void World::resumeNodeTreeUpdates() {
+            m_deferNodeTreeUpdates = false;
+            applyPendingNodeTreeUpdates();
+        }
+
+        void World::applyPendingNodeTreeUpdates() {
+            // Every pending node is either new or has changed its bounds any number of times, so it is inserted or
+            // updated exactly once.
+            for (auto* node : m_pendingNodeTreeUpdates) {
+                if (node != nullptr) {
+                    node->setPendingNodeTreeUpdateIndex(Node::NoPendingNodeTreeUpdate);
+                    if (m_nodeTree->contains(node)) {
+                        m_nodeTree->update(node->physicalBounds(), node);
+                    } else {
+                        m_nodeTree->insert(node->physicalBounds(), node);
+                    }
+                }
+            }
+            m_pendingNodeTreeUpdates.clear();
+        }
+
+        void World::discardPendingNodeTreeUpdates() {
+            for (auto* node : m_pendingNodeTreeUpdates) {
+                if (node != nullptr) {
+                    node->setPendingNodeTreeUpdateIndex(Node::NoPendingNodeTreeUpdate);
+                }
+            }
+            m_pendingNodeTreeUpdates.clear();
+        }
+
+        bool World::pendingNodeTreeUpdate(const Node* node) {
+            return node->pendingNodeTreeUpdateIndex() != Node::NoPendingNodeTreeUpdate;
+        }
+
+        void World::findNodesIntersecting(const vm::bbox3& bounds, NodeList& result) const {
+            m_nodeTree->findIntersectors(bounds, std::back_inserter(result));
+            if (!m_pendingNodeTreeUpdates.empty()) {
+                // the node tree might contain stale bounds for the pending nodes, so they are tested separately
+                result.erase(std::remove_if(std::begin(result), std::end(result), pendingNodeTreeUpdate), std::end(result));
+                for (auto* node : m_pendingNodeTreeUpdates) {
+                    if (node != nullptr && node->physicalBounds().intersects(bounds)) {
+                        result.push_back(node);
+                    }
+                }
+            }
+        }
+
+        void World::findNodesIntersecting(const std::vector<vm::plane3>& planes, NodeList& result) const {
+            m_nodeTree->findIntersectorsOfConvexVolume(planes, std::back_inserter(result));
+            if (!m_pendingNodeTreeUpdates.empty()) {
+                result.erase(std::remove_if(std::begin(result), std::end(result), pendingNodeTreeUpdate), std::end(result));
+                for (auto* node : m_pendingNodeTreeUpdates) {
+                    if (node != nullptr) {
+                        const auto& bounds = node->physicalBounds();
+                        if (!HalfSpaceUtils::boxOutside(planes, bounds.min, bounds.max)) {
+                            result.push_back(node);
+                        }
+                    }
+                }
+            }
+        }
+
+        void World::pickRays(const std::vector<vm::ray3>& rays, std::vector<PickResult>& pickResults) const {
+            ensure(pickResults.size() == rays.size(), "one pick result per ray");
+
+            m_nodeTree->findIntersectors(rays, [&](const size_t rayIndex, const Node* node) {
+                if (!pendingNodeTreeUpdate(node)) {
+                    node->pick(rays[rayIndex], pickResults[rayIndex]);
+                }
+            });
+
+            for (const auto* node : m_pendingNodeTreeUpdates) {
+                if (node != nullptr) {
+                    for (size_t i = 0; i < rays.size(); ++i) {
+                        node->pick(rays[i], pickResults[i]);
+                    }
+                }
+            }
+        }
+
         class World::InvalidateAllIssuesVisitor : public NodeVisitor {
         private:
             void doVisit(World* world) override   { invalidateIssues(world);  }
@@ -256,22 +383,32 @@ namespace TrenchBroom {
             // In some cases, (e.g. if `node` is a Group), `node` will not be added to the spatial index, but some of its descendants may be.
             // We need to recursively search the `node` being connected and add it or any descendants that need to be added.
             if (m_updateNodeTree) {
-                AddNodeToNodeTree visitor(*m_nodeTree);
-                node->acceptAndRecurse(visitor);
+                if (m_deferNodeTreeUpdates) {
+                    AddNodeToPendingNodeTreeUpdates visitor(m_pendingNodeTreeUpdates);
+                    node->acceptAndRecurse(visitor);
+                } else {
+                    AddNodeToNodeTree visitor(*m_nodeTree);
+                    node->acceptAndRecurse(visitor);
+                }
             }
         }
 
         void World::doDescendantWillBeRemoved(Node* node, const size_t depth) {
             if (m_updateNodeTree) {
-                RemoveNodeFromNodeTree visitor(*m_nodeTree);
+                RemoveNodeFromNodeTree visitor(*m_nodeTree, m_pendingNodeTreeUpdates);
                 node->acceptAndRecurse(visitor);
             }
         }
 
         void World::doDescendantPhysicalBoundsDidChange(Node* node, const vm::bbox3& oldBounds, const size_t depth) {
             if (m_updateNodeTree) {
-                UpdateNodeInNodeTree visitor(*m_nodeTree);
-                node->accept(visitor);
+                if (m_deferNodeTreeUpdates) {
+                    AddNodeToPendingNodeTreeUpdates visitor(m_pendingNodeTreeUpdates);
+                    node->accept(visitor);
+                } else {
+                    UpdateNodeInNodeTree visitor(*m_nodeTree);
+                    node->accept(visitor);
+                }
             }
         }
 
@@ -280,13 +417,28 @@ namespace TrenchBroom {
         }
 
         void World::doPick(const vm::ray3& ray, PickResult& pickResult) const {
-            for (const auto* node : m_nodeTree->findIntersectors(ray)) {
-                node->pick(ray, pickResult);
+            NodeList candidates;
+            m_nodeTree->findIntersectors(ray, std::back_inserter(candidates));
+            for (const auto* node : candidates) {
+                if (!pendingNodeTreeUpdate(node)) {
+                    node->pick(ray, pickResult);
+                }
+            }
+
+            // the pending nodes are not picked using the node tree because their bounds in the tree might be stale
+            for (const auto* node : m_pendingNodeTreeUpdates) {
+                if (node != nullptr) {
+                    node->pick(ray, pickResult);
+                }
             }
         }
 
         void World::doFindNodesContaining(const vm::vec3& point, NodeList& result) {
-            for (auto* node : m_nodeTree->findContainers(point)) {
+            applyPendingNodeTreeUpdates();
+
+            NodeList candidates;
+            m_nodeTree->findContainers(point, std::back_inserter(candidates));
+            for (auto* node : candidates) {
                 node->findNodesContaining(point, result);
             }
         }
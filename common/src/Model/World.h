@@ -46,6 +46,14 @@ namespace TrenchBroom {
             using NodeTree = AABBTree<FloatType, 3, Node*>;
             std::unique_ptr<NodeTree> m_nodeTree;
             bool m_updateNodeTree;
+            bool m_deferNodeTreeUpdates;
+            /**
+             * The nodes whose node tree updates are deferred, in the order in which they were collected, so that the
+             * updates are applied in a deterministic order. Each node stores its index in this list, so that it is
+             * collected only once and can be dropped quickly if it is removed before the updates are applied. Such
+             * entries are set to null.
+             */
+            NodeList m_pendingNodeTreeUpdates;
         public:
             World(MapFormat mapFormat, const vm::bbox3& worldBounds);
             ~World() override;
@@ -72,6 +80,55 @@ namespace TrenchBroom {
             void disableNodeTreeUpdates();
             void enableNodeTreeUpdates();
             void rebuildNodeTree();
+
+            /**
+             * Collects the nodes that are added to this world or whose bounds change instead of updating the node
+             * tree for each of them. The collected nodes are inserted or updated once when the updates are resumed.
+             * Until then, spatial queries test the collected nodes separately, so they still see the current bounds
+             * of all nodes without modifying the node tree. Removed nodes are still removed from the node tree
+             * immediately.
+             */
+            void deferNodeTreeUpdates();
+
+            /**
+             * Applies the node tree updates collected since the last call to deferNodeTreeUpdates() and updates the
+             * node tree immediately again.
+             */
+            void resumeNodeTreeUpdates();
+        private:
+            class AddNodeToPendingNodeTreeUpdates;
+            void applyPendingNodeTreeUpdates();
+            void discardPendingNodeTreeUpdates();
+            static bool pendingNodeTreeUpdate(const Node* node);
+        public: // spatial queries
+            /**
+             * Finds every entity and brush whose physical bounds intersect the given bounds and appends it to the
+             * given list. Layers and groups are not returned.
+             *
+             * @param bounds the bounds to test
+             * @param result the list to append to
+             */
+            void findNodesIntersecting(const vm::bbox3& bounds, NodeList& result) const;
+
+            /**
+             * Finds every entity and brush whose physical bounds are not entirely in front of any of the given planes
+             * and appends it to the given list. If the planes bound a convex volume with their normals pointing
+             * outward, such as a view frustum, these are the nodes that might intersect that volume.
+             *
+             * @param planes the planes bounding the volume
+             * @param result the list to append to
+             */
+            void findNodesIntersecting(const std::vector<vm::plane3>& planes, NodeList& result) const;
+
+            /**
+             * Picks the given rays at once. The node tree is traversed only once for all rays, which is much faster
+             * than picking each ray on its own if there are many rays.
+             *
+             * @param rays the rays to pick
+             * @param pickResults the pick results to add the hits to, the hits of each ray are added to the pick result
+             * with the same index, must contain one pick result per ray
+             */
+            void pickRays(const std::vector<vm::ray3>& rays, std::vector<PickResult>& pickResults) const;
         private:
             class InvalidateAllIssuesVisitor;
             void invalidateAllIssues();
@@ -0,0 +1,213 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_ParallelUtils_h
+#define TrenchBroom_ParallelUtils_h
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ParallelUtils {
+    /**
+     * Returns the number of threads that parallel operations should use, which is at least 1.
+     */
+    inline size_t workerCount() {
+        return static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u));
+    }
+
+    /**
+     * A fixed set of threads that run the tasks passed to it in the order in which they were submitted. The
+     * threads are created once and live until the pool is destroyed.
+     */
+    class WorkerPool {
+    private:
+        std::vector<std::thread> m_threads;
+        std::deque<std::function<void()>> m_tasks;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_stopped;
+    public:
+        explicit WorkerPool(const size_t threadCount) :
+        m_stopped(false) {
+            m_threads.reserve(threadCount);
+            for (size_t i = 0; i < threadCount; ++i) {
+                m_threads.emplace_back([this]() { run(); });
+            }
+        }
+
+        ~WorkerPool() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopped = true;
+            }
+            m_condition.notify_all();
+            for (auto& thread : m_threads) {
+                thread.join();
+            }
+        }
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        size_t threadCount() const {
+            return m_threads.size();
+        }
+
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_tasks.push_back(std::move(task));
+            }
+            m_condition.notify_one();
+        }
+    private:
+        void run() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_condition.wait(lock, [this]() { return m_stopped || !m_tasks.empty(); });
+                    if (m_tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+            }
+        }
+    };
+
+    /**
+     * Returns the pool shared by all parallel operations. Since the calling thread always participates in the
+     * work, the pool has one thread less than the number of workers.
+     */
+    inline WorkerPool& workerPool() {
+        static WorkerPool pool(workerCount() - 1);
+        return pool;
+    }
+
+    /**
+     * Calls the given function for every index in [0, count). The indices are distributed over the threads of
+     * the worker pool in batches of the given size, and the calling thread participates in the work. This
+     * function returns once every index has been processed.
+     *
+     * The calling thread claims batches until none are left, so this function also makes progress if all pool
+     * threads are busy, e.g. if it is called from within another parallel operation.
+     *
+     * If the given function throws, no further batches are started and the first exception is rethrown on
+     * the calling thread after all started batches have finished.
+     *
+     * @tparam F the type of the function, must be callable with a size_t argument
+     * @param count the number of indices to process
+     * @param func the function to call
+     * @param batchSize the number of consecutive indices that each worker processes at a time, must be positive
+     */
+    template <typename F>
+    void parallelFor(const size_t count, const F& func, const size_t batchSize = 1) {
+        assert(batchSize > 0);
+
+        auto& pool = workerPool();
+        if (count <= batchSize || pool.threadCount() == 0) {
+            for (size_t i = 0; i < count; ++i) {
+                func(i);
+            }
+            return;
+        }
+
+        // Tasks may still be dequeued by the pool after this function has returned, so the state they share
+        // with it is reference counted. They only call the function while there are unclaimed batches left,
+        // and this function does not return before every batch has been claimed and finished.
+        struct State {
+            size_t count;
+            size_t batchSize;
+            size_t batchCount;
+            const F* func;
+            std::atomic<size_t> nextBatch;
+            std::atomic<bool> failed;
+            std::exception_ptr exception;
+            size_t finishedBatches;
+            std::mutex mutex;
+            std::condition_variable finished;
+        };
+
+        auto state = std::make_shared<State>();
+        state->count = count;
+        state->batchSize = batchSize;
+        state->batchCount = (count + batchSize - 1) / batchSize;
+        state->func = &func;
+        state->nextBatch = 0;
+        state->failed = false;
+        state->finishedBatches = 0;
+
+        const auto work = [](State& s) {
+            size_t batch = s.nextBatch.fetch_add(1);
+            while (batch < s.batchCount) {
+                if (!s.failed) {
+                    try {
+                        const size_t begin = batch * s.batchSize;
+                        const size_t end = std::min(begin + s.batchSize, s.count);
+                        for (size_t i = begin; i < end; ++i) {
+                            (*s.func)(i);
+                        }
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(s.mutex);
+                        if (s.exception == nullptr) {
+                            s.exception = std::current_exception();
+                        }
+                        s.failed = true;
+                    }
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(s.mutex);
+                    if (++s.finishedBatches == s.batchCount) {
+                        s.finished.notify_all();
+                    }
+                }
+                batch = s.nextBatch.fetch_add(1);
+            }
+        };
+
+        const size_t helperCount = std::min(pool.threadCount(), state->batchCount - 1);
+        for (size_t i = 0; i < helperCount; ++i) {
+            pool.submit([state, work]() { work(*state); });
+        }
+        work(*state);
+
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&]() { return state->finishedBatches == state->batchCount; });
+
+        if (state->exception != nullptr) {
+            std::rethrow_exception(state->exception);
+        }
+    }
+}
+
+#endif
@@ -123,6 +123,9 @@ namespace TrenchBroom {
 
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
         Preference<bool> UVLock(IO::Path("Editor/UV lock"), false);
+        Preference<int> UndoMemoryBudget(IO::Path("Editor/Undo memory budget"), 1024);
+        Preference<bool> TextureCacheEnabled(IO::Path("Renderer/Texture cache enabled"), true);
+        Preference<int> TextureCacheSize(IO::Path("Renderer/Texture cache size"), 1024);
 
         Preference<IO::Path>& RendererFontPath() {
             static Preference<IO::Path> fontPath(IO::Path("Renderer/Font name"), IO::Path("fonts/SourceSansPro-Regular.otf"));
@@ -249,6 +252,9 @@ namespace TrenchBroom {
                 &TextureMagFilter,
                 &TextureLock,
                 &UVLock,
+                &UndoMemoryBudget,
+                &TextureCacheEnabled,
+                &TextureCacheSize,
                 &RendererFontPath(),
                 &RendererFontSize,
                 &BrowserFontSize,
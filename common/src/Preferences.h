@@ -121,6 +121,17 @@ namespace TrenchBroom {
         extern Preference<bool> TextureLock;
         extern Preference<bool> UVLock;
 
+        /**
+         * The maximum amount of memory in megabytes that the undo history may occupy, or 0 if it is unlimited.
+         */
+        extern Preference<int> UndoMemoryBudget;
+
+        /**
+         * Whether decoded textures are cached on disk, and the maximum size of the cache in megabytes.
+         */
+        extern Preference<bool> TextureCacheEnabled;
+        extern Preference<int> TextureCacheSize;
+
         Preference<IO::Path>& RendererFontPath();
         extern Preference<int> RendererFontSize;
 
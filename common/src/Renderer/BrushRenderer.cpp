@@ -19,8 +19,10 @@
 
 #include "BrushRenderer.h"
 
+#include "HalfSpaceUtils.h"
 #include "Preferences.h"
 #include "PreferenceManager.h"
+#include "ParallelUtils.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
@@ -29,11 +31,19 @@
 #include "Renderer/IndexArrayMapBuilder.h"
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/BrushRendererBrushCache.h"
+#include "Renderer/Camera.h"
+#include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderUtils.h"
 
+#include <vecmath/bbox.h>
+#include <vecmath/plane.h>
+
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstring>
+#include <iterator>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -112,6 +122,19 @@ namespace TrenchBroom {
 
         // BrushRenderer
 
+        // Chunk
+
+        BrushRenderer::Chunk::Chunk(const ChunkKey& i_key) :
+        key(i_key),
+        vertexArray(std::make_shared<BrushVertexArray>()),
+        edgeIndices(std::make_shared<BrushIndexArray>()),
+        transparentFaces(std::make_shared<TextureToBrushIndicesMap>()),
+        opaqueFaces(std::make_shared<TextureToBrushIndicesMap>()),
+        brushTreeValid(false),
+        brushCount(0) {}
+
+        const FloatType BrushRenderer::ChunkSize = 1024.0;
+
         BrushRenderer::BrushRenderer() :
         m_filter(std::make_unique<NoFilter>()),
         m_showEdges(false),
@@ -154,6 +177,13 @@ namespace TrenchBroom {
         }
 
         void BrushRenderer::invalidate() {
+            // the trees will be rebuilt once all brushes are valid again
+            for (auto& entry : m_chunks) {
+                auto& chunk = *entry.second;
+                chunk.brushTree.clear();
+                chunk.brushTreeValid = false;
+            }
+
             for (auto& brush : m_allBrushes) {
                 // this will also invalidate already invalid brushes, which
                 // is unnecessary
@@ -162,8 +192,7 @@ namespace TrenchBroom {
             m_invalidBrushes = m_allBrushes;
 
             assert(m_brushInfo.empty());
-            assert(m_transparentFaces->empty());
-            assert(m_opaqueFaces->empty());
+            assert(m_chunks.empty());
         }
 
         void BrushRenderer::invalidateBrushes(const Model::BrushList& brushes) {
@@ -191,15 +220,7 @@ namespace TrenchBroom {
             m_brushInfo.clear();
             m_allBrushes.clear();
             m_invalidBrushes.clear();
-
-            m_vertexArray = std::make_shared<BrushVertexArray>();
-            m_edgeIndices = std::make_shared<BrushIndexArray>();
-            m_transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
-            m_opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
-
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            m_chunks.clear();
         }
 
         void BrushRenderer::setFaceColor(const Color& faceColor) {
@@ -254,16 +275,40 @@ namespace TrenchBroom {
             renderTransparent(renderContext, renderBatch);
         }
 
+        static std::vector<vm::plane3> frustumPlanes(const Camera& camera) {
+            vm::plane3f frustumPlanes[4];
+            camera.frustumPlanes(frustumPlanes[0], frustumPlanes[1], frustumPlanes[2], frustumPlanes[3]);
+
+            std::vector<vm::plane3> planes;
+            planes.reserve(4);
+            for (const auto& plane : frustumPlanes) {
+                planes.emplace_back(static_cast<FloatType>(plane.distance), vm::vec3(plane.normal));
+            }
+            return planes;
+        }
+
         void BrushRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
             if (!m_allBrushes.empty()) {
                 if (!valid()) {
                     validate();
                 }
-                if (renderContext.showFaces()) {
-                    renderOpaqueFaces(renderBatch);
-                }
-                if (renderContext.showEdges() || m_showEdges) {
-                    renderEdges(renderBatch);
+
+                const auto planes = frustumPlanes(renderContext.camera());
+                for (auto& entry : m_chunks) {
+                    auto& chunk = *entry.second;
+
+                    const auto visibility = findVisibleBrushes(chunk, planes, m_visibleBrushes);
+                    if (visibility == Visibility::None) {
+                        continue;
+                    }
+
+                    const auto* visible = visibility == Visibility::Partial ? &m_visibleBrushes : nullptr;
+                    if (renderContext.showFaces()) {
+                        renderOpaqueFaces(chunk, renderBatch, visible);
+                    }
+                    if (renderContext.showEdges() || m_showEdges) {
+                        renderEdges(chunk, renderBatch, visible);
+                    }
                 }
             }
         }
@@ -274,31 +319,145 @@ namespace TrenchBroom {
                     validate();
                 }
                 if (renderContext.showFaces()) {
-                    renderTransparentFaces(renderBatch);
+                    const auto planes = frustumPlanes(renderContext.camera());
+                    for (auto& entry : m_chunks) {
+                        auto& chunk = *entry.second;
+
+                        const auto visibility = findVisibleBrushes(chunk, planes, m_visibleBrushes);
+                        if (visibility != Visibility::None) {
+                            renderTransparentFaces(chunk, renderBatch, visibility == Visibility::Partial ? &m_visibleBrushes : nullptr);
+                        }
+                    }
                 }
             }
         }
 
-        void BrushRenderer::renderOpaqueFaces(RenderBatch& renderBatch) {
-            m_opaqueFaceRenderer.setGrayscale(m_grayscale);
-            m_opaqueFaceRenderer.setTint(m_tint);
-            m_opaqueFaceRenderer.setTintColor(m_tintColor);
-            m_opaqueFaceRenderer.render(renderBatch);
+        void BrushRenderer::renderOpaqueFaces(Chunk& chunk, RenderBatch& renderBatch, const std::vector<const Model::Brush*>* visibleBrushes) {
+            auto& faceRenderer = chunk.opaqueFaceRenderer;
+            faceRenderer.setGrayscale(m_grayscale);
+            faceRenderer.setTint(m_tint);
+            faceRenderer.setTintColor(m_tintColor);
+            if (visibleBrushes == nullptr) {
+                faceRenderer.render(renderBatch);
+            } else {
+                renderBatch.addOneShot(new FaceRenderer(faceRenderer, visibleFaceRanges(*visibleBrushes, chunk.visibleOpaqueRanges, false)));
+            }
         }
 
-        void BrushRenderer::renderTransparentFaces(RenderBatch& renderBatch) {
-            m_transparentFaceRenderer.setGrayscale(m_grayscale);
-            m_transparentFaceRenderer.setTint(m_tint);
-            m_transparentFaceRenderer.setTintColor(m_tintColor);
-            m_transparentFaceRenderer.setAlpha(m_transparencyAlpha);
-            m_transparentFaceRenderer.render(renderBatch);
+        void BrushRenderer::renderTransparentFaces(Chunk& chunk, RenderBatch& renderBatch, const std::vector<const Model::Brush*>* visibleBrushes) {
+            auto& faceRenderer = chunk.transparentFaceRenderer;
+            faceRenderer.setGrayscale(m_grayscale);
+            faceRenderer.setTint(m_tint);
+            faceRenderer.setTintColor(m_tintColor);
+            faceRenderer.setAlpha(m_transparencyAlpha);
+            if (visibleBrushes == nullptr) {
+                faceRenderer.render(renderBatch);
+            } else {
+                renderBatch.addOneShot(new FaceRenderer(faceRenderer, visibleFaceRanges(*visibleBrushes, chunk.visibleTransparentRanges, true)));
+            }
         }
 
-        void BrushRenderer::renderEdges(RenderBatch& renderBatch) {
+        void BrushRenderer::renderEdges(Chunk& chunk, RenderBatch& renderBatch, const std::vector<const Model::Brush*>* visibleBrushes) {
+            // the edge renderer creates a one shot renderable for every call, so the copy need not outlive this call
+            auto edgeRenderer = IndexedEdgeRenderer(chunk.edgeRenderer, visibleBrushes != nullptr ? visibleEdgeRanges(*visibleBrushes, chunk.visibleEdgeRanges) : nullptr);
             if (m_showOccludedEdges) {
-                m_edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+                edgeRenderer.renderOnTop(renderBatch, m_occludedEdgeColor);
+            }
+            edgeRenderer.render(renderBatch, m_edgeColor);
+        }
+
+        BrushRenderer::Visibility BrushRenderer::findVisibleBrushes(Chunk& chunk, const std::vector<vm::plane3>& frustumPlanes, std::vector<const Model::Brush*>& visibleBrushes) const {
+            assert(chunk.brushCount > 0);
+            assert(chunk.brushTreeValid);
+
+            const auto& bounds = chunk.brushTree.bounds();
+            if (HalfSpaceUtils::boxOutside(frustumPlanes, bounds.min, bounds.max)) {
+                return Visibility::None;
+            }
+            if (HalfSpaceUtils::boxContained(frustumPlanes, bounds.min, bounds.max)) {
+                return Visibility::All;
+            }
+
+            visibleBrushes.clear();
+            chunk.brushTree.findIntersectorsOfConvexVolume(frustumPlanes, std::back_inserter(visibleBrushes));
+            if (visibleBrushes.empty()) {
+                return Visibility::None;
+            } else if (visibleBrushes.size() == chunk.brushCount) {
+                return Visibility::All;
+            } else {
+                return Visibility::Partial;
+            }
+        }
+
+        /**
+         * Sorts the given index ranges and joins adjacent ranges, so that they can be rendered with fewer draw calls.
+         */
+        static void joinAdjacentRanges(BrushIndexRanges& ranges) {
+            if (ranges.empty()) {
+                return;
             }
-            m_edgeRenderer.render(renderBatch, m_edgeColor);
+
+            std::sort(std::begin(ranges), std::end(ranges));
+
+            size_t last = 0;
+            for (size_t i = 1; i < ranges.size(); ++i) {
+                auto& [lastOffset, lastCount] = ranges[last];
+                const auto& [offset, count] = ranges[i];
+                if (lastOffset + lastCount == offset) {
+                    lastCount += count;
+                } else {
+                    ranges[++last] = ranges[i];
+                }
+            }
+            ranges.resize(last + 1);
+        }
+
+        /**
+         * Returns the given buffer for reuse, or replaces it with a new buffer if it is still referenced by a renderer
+         * that was queued earlier and has not been rendered yet.
+         */
+        template <typename T>
+        static T& reuseBuffer(std::shared_ptr<T>& buffer) {
+            if (buffer == nullptr || buffer.use_count() > 1) {
+                buffer = std::make_shared<T>();
+            }
+            return *buffer;
+        }
+
+        TextureToBrushIndexRangesMapPtr BrushRenderer::visibleFaceRanges(const std::vector<const Model::Brush*>& visibleBrushes, std::shared_ptr<TextureToBrushIndexRangesMap>& buffer, const bool transparent) const {
+            auto& result = reuseBuffer(buffer);
+            // keep the range vectors of every texture to avoid reallocating them every frame
+            for (auto& entry : result) {
+                entry.second.clear();
+            }
+
+            for (const auto* brush : visibleBrushes) {
+                const auto& info = m_brushInfo.at(brush);
+                const auto& keys = transparent ? info.transparentFaceIndicesKeys : info.opaqueFaceIndicesKeys;
+                for (const auto& [texture, key] : keys) {
+                    result[texture].emplace_back(key->pos, key->size);
+                }
+            }
+
+            for (auto& entry : result) {
+                joinAdjacentRanges(entry.second);
+            }
+            return buffer;
+        }
+
+        BrushIndexRangesPtr BrushRenderer::visibleEdgeRanges(const std::vector<const Model::Brush*>& visibleBrushes, std::shared_ptr<BrushIndexRanges>& buffer) const {
+            auto& result = reuseBuffer(buffer);
+            result.clear();
+
+            for (const auto* brush : visibleBrushes) {
+                const auto& info = m_brushInfo.at(brush);
+                if (info.edgeIndicesKey != nullptr) {
+                    result.emplace_back(info.edgeIndicesKey->pos, info.edgeIndicesKey->size);
+                }
+            }
+
+            joinAdjacentRanges(result);
+            return buffer;
         }
 
         class BrushRenderer::FilterWrapper : public BrushRenderer::Filter {
@@ -324,18 +483,92 @@ namespace TrenchBroom {
             }
         };
 
+        /**
+         * Describes how a brush is inserted into the VBO.
+         */
+        struct BrushRenderer::BrushUpload {
+            /**
+             * A run of consecutive faces with the same texture in the brush's cached faces sorted by texture, and
+             * whose indices are either all opaque or all transparent.
+             */
+            struct FaceRange {
+                const Assets::Texture* texture;
+                size_t firstFace;
+                size_t endFace;
+                bool transparent;
+                size_t indexCount;
+                BrushIndexArray* indexArray;
+                AllocationTracker::Block* key;
+            };
+
+            const Model::Brush* brush;
+            Chunk* chunk;
+            bool skip;
+            bool forceTransparent;
+            Filter::EdgeRenderPolicy edgePolicy;
+            size_t vertexCount;
+            size_t edgeIndexCount;
+            std::vector<FaceRange> faceRanges;
+            AllocationTracker::Block* vertexKey;
+            AllocationTracker::Block* edgeIndicesKey;
+
+            explicit BrushUpload(const Model::Brush* i_brush) :
+            brush(i_brush),
+            chunk(nullptr),
+            skip(false),
+            forceTransparent(false),
+            edgePolicy(Filter::EdgeRenderPolicy::RenderNone),
+            vertexCount(0),
+            edgeIndexCount(0),
+            vertexKey(nullptr),
+            edgeIndicesKey(nullptr) {}
+        };
+
         void BrushRenderer::validate() {
             assert(!valid());
 
+            std::vector<BrushUpload> uploads;
+            uploads.reserve(m_invalidBrushes.size());
             for (auto brush : m_invalidBrushes) {
-                validateBrush(brush);
+                uploads.emplace_back(brush);
+            }
+
+            const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
+            ParallelUtils::parallelFor(uploads.size(), [&](const size_t i) {
+                prepareUpload(wrapper, uploads[i]);
+            }, 64);
+
+            // allocating the blocks modifies the shared arrays, so this must be done sequentially
+            for (auto& upload : uploads) {
+                allocateUpload(upload);
             }
+
+            ParallelUtils::parallelFor(uploads.size(), [&](const size_t i) {
+                writeUpload(uploads[i]);
+            }, 64);
+
             m_invalidBrushes.clear();
             assert(valid());
 
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
-            m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
+            // only new chunks have invalid trees, and all of their brushes were just uploaded
+            std::map<Chunk*, std::vector<const Model::Brush*>> newChunkBrushes;
+            for (const auto& upload : uploads) {
+                if (!upload.skip && !upload.chunk->brushTreeValid) {
+                    newChunkBrushes[upload.chunk].push_back(upload.brush);
+                }
+            }
+            for (auto& [chunk, brushes] : newChunkBrushes) {
+                assert(brushes.size() == chunk->brushCount);
+                chunk->brushTree.clearAndBuild(brushes, [](const Model::Brush* brush) { return brush->logicalBounds(); });
+                chunk->brushTreeValid = true;
+            }
+
+            for (auto& entry : m_chunks) {
+                auto& chunk = *entry.second;
+                chunk.opaqueFaceRenderer = FaceRenderer(chunk.vertexArray, chunk.opaqueFaces, m_faceColor);
+                chunk.transparentFaceRenderer = FaceRenderer(chunk.vertexArray, chunk.transparentFaces, m_faceColor);
+                chunk.edgeRenderer = IndexedEdgeRenderer(chunk.vertexArray, chunk.edgeIndices);
+            }
         }
 
         static size_t triIndicesCountForPolygon(const size_t vertexCount) {
@@ -405,58 +638,38 @@ namespace TrenchBroom {
             }
         }
 
-        void BrushRenderer::validateBrush(const Model::Brush* brush) {
-            assert(m_allBrushes.find(brush) != m_allBrushes.end());
-            assert(m_invalidBrushes.find(brush) != m_invalidBrushes.end());
-            assert(m_brushInfo.find(brush) == m_brushInfo.end());
+        static bool isTransparent(const BrushRendererBrushCache::CachedFace& cache, const bool forceTransparent) {
+            return forceTransparent || cache.face->hasAttribute(Model::TagAttributes::Transparency);
+        }
 
-            const FilterWrapper wrapper(*m_filter, m_showHiddenBrushes);
+        void BrushRenderer::prepareUpload(const Filter& filter, BrushUpload& upload) const {
+            const auto* brush = upload.brush;
 
             // evaluate filter. only evaluate the filter once per brush.
-            const auto settings = wrapper.markFaces(brush);
+            const auto settings = filter.markFaces(brush);
             const auto [facePolicy, edgePolicy] = settings;
 
             if (facePolicy == Filter::FaceRenderPolicy::RenderNone &&
                 edgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
                 // NOTE: this skips inserting the brush into m_brushInfo
+                upload.skip = true;
                 return;
             }
 
-            BrushInfo& info = m_brushInfo[brush];
-
             // collect vertices
             auto& brushCache = brush->brushRendererBrushCache();
             brushCache.validateVertexCache(brush);
-            const auto& cachedVertices = brushCache.cachedVertices();
-            ensure(!cachedVertices.empty(), "Brush must have cached vertices");
+            upload.vertexCount = brushCache.cachedVertices().size();
+            ensure(upload.vertexCount > 0, "Brush must have cached vertices");
 
-            assert(m_vertexArray != nullptr);
-            auto [vertBlock, dest] = m_vertexArray->getPointerToInsertVerticesAt(cachedVertices.size());
-            std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
-            info.vertexHolderKey = vertBlock;
+            // count edge indices
+            upload.edgePolicy = edgePolicy;
+            upload.edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
 
-            const auto brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
-
-            // insert edge indices into VBO
-            {
-                const size_t edgeIndexCount = countMarkedEdgeIndices(brush, edgePolicy);
-                if (edgeIndexCount > 0) {
-                    auto[key, dest] = m_edgeIndices->getPointerToInsertElementsAt(edgeIndexCount);
-                    info.edgeIndicesKey = key;
-                    getMarkedEdgeIndices(brush, edgePolicy, brushVerticesStartIndex, dest);
-                } else {
-                    // it's possible to have no edges to render
-                    // e.g. select all faces of a brush, and the unselected brush renderer
-                    // will hit this branch.
-                    ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
-                }
-            }
-
-            // insert face indices
-
-            auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
+            // count face indices
+            const auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
             const size_t facesSortedByTexSize = facesSortedByTex.size();
-            const auto forceTransparent = m_transparent || brush->hasAttribute(Model::TagAttributes::Transparency);
+            upload.forceTransparent = m_transparent || brush->hasAttribute(Model::TagAttributes::Transparency);
 
             size_t nextI;
             for (size_t i = 0; i < facesSortedByTexSize; i = nextI) {
@@ -473,7 +686,7 @@ namespace TrenchBroom {
                     const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
                     if (cache.face->isMarked()) {
                         assert(cache.texture == texture);
-                        if (forceTransparent || cache.face->hasAttribute(Model::TagAttributes::Transparency)) {
+                        if (isTransparent(cache, upload.forceTransparent)) {
                             transparentIndexCount += triIndicesCountForPolygon(cache.vertexCount);
                         } else {
                             opaqueIndexCount += triIndicesCountForPolygon(cache.vertexCount);
@@ -482,58 +695,104 @@ namespace TrenchBroom {
                 }
 
                 if (transparentIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_transparentFaces;
-                    auto& holderPtr = faceVboMap[texture];
-                    if (holderPtr == nullptr) {
-                        // inserts into map!
-                        holderPtr = std::make_shared<BrushIndexArray>();
-                    }
+                    upload.faceRanges.push_back({ texture, i, nextI, true, transparentIndexCount, nullptr, nullptr });
+                }
+                if (opaqueIndexCount > 0) {
+                    upload.faceRanges.push_back({ texture, i, nextI, false, opaqueIndexCount, nullptr, nullptr });
+                }
+            }
+        }
 
-                    auto [key, dest] = holderPtr->getPointerToInsertElementsAt(transparentIndexCount);
-                    info.transparentFaceIndicesKeys.push_back({texture, key});
+        void BrushRenderer::allocateUpload(BrushUpload& upload) {
+            const auto* brush = upload.brush;
+            assert(m_allBrushes.find(brush) != m_allBrushes.end());
+            assert(m_invalidBrushes.find(brush) != m_invalidBrushes.end());
+            assert(m_brushInfo.find(brush) == m_brushInfo.end());
 
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = dest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && (forceTransparent || cache.face->hasAttribute(Model::TagAttributes::Transparency))) {
-                            addTriIndicesForPolygon(currentDest,
-                                                    static_cast<GLuint>(brushVerticesStartIndex +
-                                                                        cache.indexOfFirstVertexRelativeToBrush),
-                                                    cache.vertexCount);
+            if (upload.skip) {
+                return;
+            }
 
-                            currentDest += triIndicesCountForPolygon(cache.vertexCount);
-                        }
-                    }
-                    assert(currentDest == (dest + transparentIndexCount));
+            auto& chunk = findOrCreateChunk(brush);
+            ++chunk.brushCount;
+            if (chunk.brushTreeValid) {
+                chunk.brushTree.insert(brush->logicalBounds(), brush);
+            }
+            upload.chunk = &chunk;
+
+            BrushInfo& info = m_brushInfo[brush];
+            info.chunk = &chunk;
+
+            upload.vertexKey = chunk.vertexArray->allocateVertices(upload.vertexCount);
+            info.vertexHolderKey = upload.vertexKey;
+
+            if (upload.edgeIndexCount > 0) {
+                upload.edgeIndicesKey = chunk.edgeIndices->allocateElements(upload.edgeIndexCount);
+                info.edgeIndicesKey = upload.edgeIndicesKey;
+            } else {
+                // it's possible to have no edges to render
+                // e.g. select all faces of a brush, and the unselected brush renderer
+                // will hit this branch.
+                ensure(info.edgeIndicesKey == nullptr, "BrushInfo not initialized");
+            }
+
+            for (auto& range : upload.faceRanges) {
+                TextureToBrushIndicesMap& faceVboMap = range.transparent ? *chunk.transparentFaces : *chunk.opaqueFaces;
+                auto& holderPtr = faceVboMap[range.texture];
+                if (holderPtr == nullptr) {
+                    // inserts into map!
+                    holderPtr = std::make_shared<BrushIndexArray>();
                 }
 
-                if (opaqueIndexCount > 0) {
-                    TextureToBrushIndicesMap& faceVboMap = *m_opaqueFaces;
-                    auto& holderPtr = faceVboMap[texture];
-                    if (holderPtr == nullptr) {
-                        // inserts into map!
-                        holderPtr = std::make_shared<BrushIndexArray>();
-                    }
+                range.indexArray = holderPtr.get();
+                range.key = holderPtr->allocateElements(range.indexCount);
+                if (range.transparent) {
+                    info.transparentFaceIndicesKeys.push_back({range.texture, range.key});
+                } else {
+                    info.opaqueFaceIndicesKeys.push_back({range.texture, range.key});
+                }
+            }
+        }
 
-                    auto [key, dest] = holderPtr->getPointerToInsertElementsAt(opaqueIndexCount);
-                    info.opaqueFaceIndicesKeys.push_back({texture, key});
+        void BrushRenderer::writeUpload(const BrushUpload& upload) const {
+            if (upload.skip) {
+                return;
+            }
 
-                    // process all faces with this texture (they'll be consecutive)
-                    GLuint *currentDest = dest;
-                    for (size_t j = i; j < nextI; ++j) {
-                        const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
-                        if (cache.face->isMarked() && !(forceTransparent || cache.face->hasAttribute(Model::TagAttributes::Transparency))) {
-                            addTriIndicesForPolygon(currentDest,
-                                                    static_cast<GLuint>(brushVerticesStartIndex +
-                                                                        cache.indexOfFirstVertexRelativeToBrush),
-                                                    cache.vertexCount);
+            const auto* brush = upload.brush;
+            const auto& brushCache = brush->brushRendererBrushCache();
 
-                            currentDest += triIndicesCountForPolygon(cache.vertexCount);
-                        }
+            // insert vertices into VBO
+            const auto& cachedVertices = brushCache.cachedVertices();
+            auto& chunk = *upload.chunk;
+            auto* vertexDest = chunk.vertexArray->getPointerToWriteVertices(upload.vertexKey);
+            std::memcpy(vertexDest, cachedVertices.data(), cachedVertices.size() * sizeof(*vertexDest));
+
+            const auto brushVerticesStartIndex = static_cast<GLuint>(upload.vertexKey->pos);
+
+            // insert edge indices into VBO
+            if (upload.edgeIndicesKey != nullptr) {
+                auto* edgeDest = chunk.edgeIndices->getPointerToWriteElements(upload.edgeIndicesKey);
+                getMarkedEdgeIndices(brush, upload.edgePolicy, brushVerticesStartIndex, edgeDest);
+            }
+
+            // insert face indices into VBO
+            const auto& facesSortedByTex = brushCache.cachedFacesSortedByTexture();
+            for (const auto& range : upload.faceRanges) {
+                GLuint* dest = range.indexArray->getPointerToWriteElements(range.key);
+                GLuint* currentDest = dest;
+                for (size_t j = range.firstFace; j < range.endFace; ++j) {
+                    const BrushRendererBrushCache::CachedFace& cache = facesSortedByTex[j];
+                    if (cache.face->isMarked() && isTransparent(cache, upload.forceTransparent) == range.transparent) {
+                        addTriIndicesForPolygon(currentDest,
+                                                static_cast<GLuint>(brushVerticesStartIndex +
+                                                                    cache.indexOfFirstVertexRelativeToBrush),
+                                                cache.vertexCount);
+
+                        currentDest += triIndicesCountForPolygon(cache.vertexCount);
                     }
-                    assert(currentDest == (dest + opaqueIndexCount));
                 }
+                assert(currentDest == (dest + range.indexCount));
             }
         }
 
@@ -579,33 +838,58 @@ namespace TrenchBroom {
             }
 
             const BrushInfo& info = it->second;
+            auto& chunk = *info.chunk;
 
             // update Vbo's
-            m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
+            chunk.vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
             if (info.edgeIndicesKey != nullptr) {
-                m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
+                chunk.edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
             }
 
             for (const auto& [texture, opaqueKey] : info.opaqueFaceIndicesKeys) {
-                std::shared_ptr<BrushIndexArray> faceIndexHolder = m_opaqueFaces->at(texture);
+                std::shared_ptr<BrushIndexArray> faceIndexHolder = chunk.opaqueFaces->at(texture);
                 faceIndexHolder->zeroElementsWithKey(opaqueKey);
 
                 if (!faceIndexHolder->hasValidIndices()) {
                     // There are no indices left to render for this texture, so delete the <Texture, BrushIndexArray> entry from the map
-                    m_opaqueFaces->erase(texture);
+                    chunk.opaqueFaces->erase(texture);
                 }
             }
             for (const auto& [texture, transparentKey] : info.transparentFaceIndicesKeys) {
-                std::shared_ptr<BrushIndexArray> faceIndexHolder = m_transparentFaces->at(texture);
+                std::shared_ptr<BrushIndexArray> faceIndexHolder = chunk.transparentFaces->at(texture);
                 faceIndexHolder->zeroElementsWithKey(transparentKey);
 
                 if (!faceIndexHolder->hasValidIndices()) {
                     // There are no indices left to render for this texture, so delete the <Texture, BrushIndexArray> entry from the map
-                    m_transparentFaces->erase(texture);
+                    chunk.transparentFaces->erase(texture);
                 }
             }
 
+            if (chunk.brushTreeValid) {
+                chunk.brushTree.remove(brush);
+            }
             m_brushInfo.erase(it);
+
+            assert(chunk.brushCount > 0);
+            if (--chunk.brushCount == 0) {
+                const auto key = chunk.key;
+                m_chunks.erase(key);
+            }
+        }
+
+        BrushRenderer::Chunk& BrushRenderer::findOrCreateChunk(const Model::Brush* brush) {
+            const auto center = brush->logicalBounds().center();
+            ChunkKey key;
+            for (size_t i = 0; i < 3; ++i) {
+                key[i] = static_cast<int>(std::floor(center[i] / ChunkSize));
+            }
+
+            auto& chunk = m_chunks[key];
+            if (chunk == nullptr) {
+                chunk = std::make_unique<Chunk>(key);
+            }
+            return *chunk;
         }
+
     }
 }
@@ -20,16 +20,21 @@
 #ifndef TrenchBroom_BrushRenderer
 #define TrenchBroom_BrushRenderer
 
+#include "AABBTree.h"
 #include "Color.h"
+#include "TrenchBroom.h"
 #include "Model/ModelTypes.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/FaceRenderer.h"
 #include "Model/Brush.h"
 #include "Renderer/AllocationTracker.h"
 
+#include <array>
+#include <map>
 #include <memory>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Model {
@@ -37,6 +42,7 @@ namespace TrenchBroom {
     }
 
     namespace Renderer {
+        class Camera;
         class RenderBatch;
         class RenderContext;
         class Vbo;
@@ -116,10 +122,59 @@ namespace TrenchBroom {
             };
         private:
             class FilterWrapper;
+            struct BrushUpload;
         private:
             std::unique_ptr<Filter> m_filter;
 
+            using BrushTree = AABBTree<FloatType, 3, const Model::Brush*>;
+            using ChunkKey = std::array<int, 3>;
+            static const FloatType ChunkSize;
+
+            /**
+             * A group of brushes whose centers lie in the same cell of a grid with a cell size of ChunkSize. Every
+             * chunk has its own vertex and index arrays, so that changing a brush only modifies and uploads the arrays
+             * of its chunk, and chunks outside of the view frustum can be skipped entirely.
+             */
+            struct Chunk {
+                ChunkKey key;
+                BrushVertexArrayPtr vertexArray;
+                BrushIndexArrayPtr edgeIndices;
+                std::shared_ptr<TextureToBrushIndicesMap> transparentFaces;
+                std::shared_ptr<TextureToBrushIndicesMap> opaqueFaces;
+
+                FaceRenderer opaqueFaceRenderer;
+                FaceRenderer transparentFaceRenderer;
+                IndexedEdgeRenderer edgeRenderer;
+
+                /**
+                 * The index ranges of the visible brushes in the last frame where this chunk was partially visible.
+                 * The buffers are reused in the next frame unless a queued renderer still refers to them.
+                 */
+                std::shared_ptr<TextureToBrushIndexRangesMap> visibleOpaqueRanges;
+                std::shared_ptr<TextureToBrushIndexRangesMap> visibleTransparentRanges;
+                std::shared_ptr<BrushIndexRanges> visibleEdgeRanges;
+
+                /**
+                 * Contains the bounds of the brushes in this chunk and is used to cull the brushes outside of the view
+                 * frustum. While brushTreeValid is true, the tree is updated along with the brushes in this chunk.
+                 * Otherwise, it is rebuilt from scratch when it is needed next, which is faster after many brushes
+                 * were added.
+                 */
+                BrushTree brushTree;
+                bool brushTreeValid;
+                size_t brushCount;
+
+                explicit Chunk(const ChunkKey& i_key);
+            };
+
+            enum class Visibility {
+                None,
+                Partial,
+                All
+            };
+
             struct BrushInfo {
+                Chunk* chunk;
                 AllocationTracker::Block* vertexHolderKey;
                 AllocationTracker::Block* edgeIndicesKey;
                 std::vector<std::pair<const Assets::Texture*, AllocationTracker::Block*>> opaqueFaceIndicesKeys;
@@ -138,14 +193,16 @@ namespace TrenchBroom {
             std::set<const Model::Brush*> m_allBrushes;
             std::set<const Model::Brush*> m_invalidBrushes;
 
-            BrushVertexArrayPtr m_vertexArray;
-            BrushIndexArrayPtr m_edgeIndices;
-            std::shared_ptr<TextureToBrushIndicesMap> m_transparentFaces;
-            std::shared_ptr<TextureToBrushIndicesMap> m_opaqueFaces;
+            /**
+             * The chunks containing the brushes in the VBO. A chunk is deleted when its last brush is removed.
+             */
+            std::map<ChunkKey, std::unique_ptr<Chunk>> m_chunks;
 
-            FaceRenderer m_opaqueFaceRenderer;
-            FaceRenderer m_transparentFaceRenderer;
-            IndexedEdgeRenderer m_edgeRenderer;
+            /**
+             * Receives the visible brushes of each partially visible chunk while rendering. It is a member so that it
+             * need not be reallocated for every chunk and frame.
+             */
+            std::vector<const Model::Brush*> m_visibleBrushes;
 
             Color m_faceColor;
             bool m_showEdges;
@@ -192,8 +249,8 @@ namespace TrenchBroom {
              *
              * Until a brush is invalidated, we don't re-evaluate the Filter, and don't check the Brush object for modification.
              *
-             * Additionally, calling `invalidate()` guarantees the m_brushInfo, m_transparentFaces, and m_opaqueFaces
-             * maps will be empty, so the BrushRenderer will not have any lingering Texture* pointers.
+             * Additionally, calling `invalidate()` guarantees the m_brushInfo and m_chunks maps will be empty, so the
+             * BrushRenderer will not have any lingering Texture* pointers.
              */
             void invalidate();
             void invalidateBrushes(const Model::BrushList& brushes);
@@ -263,17 +320,48 @@ namespace TrenchBroom {
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
         private:
-            void renderOpaqueFaces(RenderBatch& renderBatch);
-            void renderTransparentFaces(RenderBatch& renderBatch);
-            void renderEdges(RenderBatch& renderBatch);
+            void renderOpaqueFaces(Chunk& chunk, RenderBatch& renderBatch, const std::vector<const Model::Brush*>* visibleBrushes);
+            void renderTransparentFaces(Chunk& chunk, RenderBatch& renderBatch, const std::vector<const Model::Brush*>* visibleBrushes);
+            void renderEdges(Chunk& chunk, RenderBatch& renderBatch, const std::vector<const Model::Brush*>* visibleBrushes);
+
+            /**
+             * Determines whether the brushes of the given chunk are within the view frustum bounded by the given
+             * planes. If the chunk is only partially visible, the given vector is replaced with the brushes whose
+             * bounds intersect the frustum.
+             */
+            Visibility findVisibleBrushes(Chunk& chunk, const std::vector<vm::plane3>& frustumPlanes, std::vector<const Model::Brush*>& visibleBrushes) const;
+            TextureToBrushIndexRangesMapPtr visibleFaceRanges(const std::vector<const Model::Brush*>& visibleBrushes, std::shared_ptr<TextureToBrushIndexRangesMap>& buffer, bool transparent) const;
+            BrushIndexRangesPtr visibleEdgeRanges(const std::vector<const Model::Brush*>& visibleBrushes, std::shared_ptr<BrushIndexRanges>& buffer) const;
 
         public:
             /**
+             * Inserts the vertices and indices of all invalid brushes into the VBO. The filter is evaluated and the
+             * vertices and indices are generated on multiple threads, only the allocation of the blocks in the VBO is
+             * done sequentially. The data is uploaded to the GPU when the VBO is prepared for rendering.
+             *
              * Only exposed for benchmarking.
              */
             void validate();
         private:
-            void validateBrush(const Model::Brush* brush);
+            /**
+             * Evaluates the filter for the given brush and counts the vertices and indices to insert into the VBO.
+             * May be called concurrently for different brushes.
+             */
+            void prepareUpload(const Filter& filter, BrushUpload& upload) const;
+            /**
+             * Allocates the blocks for the vertices and indices of the given brush and records them in m_brushInfo.
+             */
+            void allocateUpload(BrushUpload& upload);
+            /**
+             * Writes the vertices and indices of the given brush into its allocated blocks. May be called concurrently
+             * for different brushes once all blocks have been allocated.
+             */
+            void writeUpload(const BrushUpload& upload) const;
+
+            /**
+             * Returns the chunk that the given brush belongs to, creating it if necessary.
+             */
+            Chunk& findOrCreateChunk(const Model::Brush* brush);
             void addBrush(const Model::Brush* brush);
             void removeBrush(const Model::Brush* brush);
 
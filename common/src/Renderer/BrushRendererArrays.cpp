@@ -86,6 +86,25 @@ namespace TrenchBroom {
             glAssert(glDrawElements(primType, renderCount, glType<Index>(), renderOffset));
         }
 
+        void IndexHolder::render(const PrimType primType, const std::vector<std::pair<size_t, size_t>>& ranges) const {
+            if (ranges.empty()) {
+                return;
+            }
+
+            std::vector<GLsizei> counts;
+            std::vector<const GLvoid*> offsets;
+            counts.reserve(ranges.size());
+            offsets.reserve(ranges.size());
+
+            for (const auto& [offset, count] : ranges) {
+                counts.push_back(static_cast<GLsizei>(count));
+                offsets.push_back(reinterpret_cast<const GLvoid*>(m_block->offset() + sizeof(Index) * offset));
+            }
+
+            const auto drawCount = static_cast<GLsizei>(ranges.size());
+            glAssert(glMultiDrawElements(primType, counts.data(), glType<Index>(), offsets.data(), drawCount));
+        }
+
         std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index> &elements) {
             return std::make_shared<IndexHolder>(elements);
         }
@@ -102,24 +121,30 @@ namespace TrenchBroom {
         }
 
         std::pair<AllocationTracker::Block*, GLuint*> BrushIndexArray::getPointerToInsertElementsAt(const size_t elementCount) {
+            auto* block = allocateElements(elementCount);
+            return {block, getPointerToWriteElements(block)};
+        }
+
+        AllocationTracker::Block* BrushIndexArray::allocateElements(const size_t elementCount) {
             auto block = m_allocationTracker.allocate(elementCount);
-            if (block != nullptr) {
-                GLuint* dest = m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
-                return {block, dest};
+            if (block == nullptr) {
+                // retry
+                const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
+                                                m_allocationTracker.capacity() + elementCount);
+                m_allocationTracker.expand(newSize);
+                m_indexHolder.resize(newSize);
+
+                // insert again
+                block = m_allocationTracker.allocate(elementCount);
+                assert(block != nullptr);
             }
 
-            // retry
-            const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
-                                            m_allocationTracker.capacity() + elementCount);
-            m_allocationTracker.expand(newSize);
-            m_indexHolder.resize(newSize);
-
-            // insert again
-            block = m_allocationTracker.allocate(elementCount);
-            assert(block != nullptr);
+            m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
+            return block;
+        }
 
-            GLuint* dest = m_indexHolder.getPointerToWriteElementsTo(block->pos, elementCount);
-            return {block, dest};
+        GLuint* BrushIndexArray::getPointerToWriteElements(const AllocationTracker::Block* key) {
+            return m_indexHolder.getPointerToElements(key->pos);
         }
 
         void BrushIndexArray::zeroElementsWithKey(AllocationTracker::Block* key) {
@@ -135,6 +160,11 @@ namespace TrenchBroom {
             m_indexHolder.render(primType, 0, m_indexHolder.size());
         }
 
+        void BrushIndexArray::render(const PrimType primType, const std::vector<std::pair<size_t, size_t>>& ranges) const {
+            assert(m_indexHolder.prepared());
+            m_indexHolder.render(primType, ranges);
+        }
+
         bool BrushIndexArray::prepared() const {
             return m_indexHolder.prepared();
         }
@@ -150,24 +180,30 @@ namespace TrenchBroom {
                                                m_allocationTracker(0) {}
 
         std::pair<AllocationTracker::Block*, BrushVertexArray::Vertex*> BrushVertexArray::getPointerToInsertVerticesAt(const size_t vertexCount) {
+            auto* block = allocateVertices(vertexCount);
+            return {block, getPointerToWriteVertices(block)};
+        }
+
+        AllocationTracker::Block* BrushVertexArray::allocateVertices(const size_t vertexCount) {
             auto block = m_allocationTracker.allocate(vertexCount);
-            if (block != nullptr) {
-                Vertex* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
-                return {block, dest};
+            if (block == nullptr) {
+                // retry
+                const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
+                                                m_allocationTracker.capacity() + vertexCount);
+                m_allocationTracker.expand(newSize);
+                m_vertexHolder.resize(newSize);
+
+                // insert again
+                block = m_allocationTracker.allocate(vertexCount);
+                assert(block != nullptr);
             }
 
-            // retry
-            const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
-                                            m_allocationTracker.capacity() + vertexCount);
-            m_allocationTracker.expand(newSize);
-            m_vertexHolder.resize(newSize);
-
-            // insert again
-            block = m_allocationTracker.allocate(vertexCount);
-            assert(block != nullptr);
+            m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
+            return block;
+        }
 
-            Vertex* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
-            return {block, dest};
+        BrushVertexArray::Vertex* BrushVertexArray::getPointerToWriteVertices(const AllocationTracker::Block* key) {
+            return m_vertexHolder.getPointerToElements(key->pos);
         }
 
         void BrushVertexArray::deleteVerticesWithKey(AllocationTracker::Block* key) {
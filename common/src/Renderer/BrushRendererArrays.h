@@ -141,6 +141,15 @@ namespace TrenchBroom {
                 return m_snapshot.data() + offsetWithinBlock;
             }
 
+            /**
+             * Returns a pointer to the elements starting at the given offset without marking them as dirty. The
+             * pointer is invalidated by a call to resize().
+             */
+            T* getPointerToElements(const size_t offsetWithinBlock) {
+                assert(offsetWithinBlock <= m_snapshot.size());
+                return m_snapshot.data() + offsetWithinBlock;
+            }
+
             bool prepared() const {
                 // NOTE: this returns true if the capacity is 0
                 return m_dirtyRange.clean();
@@ -208,6 +217,10 @@ namespace TrenchBroom {
             explicit IndexHolder(std::vector<Index>& elements);
             void zeroRange(size_t offsetWithinBlock, size_t count);
             void render(PrimType primType, size_t offset, size_t count) const;
+            /**
+             * Renders the given (offset, count) ranges of indices with a single draw call.
+             */
+            void render(PrimType primType, const std::vector<std::pair<size_t, size_t>>& ranges) const;
 
             static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
         };
@@ -238,12 +251,31 @@ namespace TrenchBroom {
              */
             std::pair<AllocationTracker::Block*, GLuint*> getPointerToInsertElementsAt(size_t elementCount);
 
+            /**
+             * Allocates and marks as dirty the given number of indices like getPointerToInsertElementsAt(), but
+             * does not return a pointer to write to. This allows the space for many brushes to be allocated up front.
+             * Afterwards, the indices of each allocation can be written using getPointerToWriteElements(), also
+             * concurrently for different allocations.
+             */
+            AllocationTracker::Block* allocateElements(size_t elementCount);
+
+            /**
+             * Returns a pointer to write the indices of the given allocation to. The pointer is invalidated by the
+             * next allocation.
+             */
+            GLuint* getPointerToWriteElements(const AllocationTracker::Block* key);
+
             /**
              * Deletes indices for the given brush and marks the allocation as free.
              */
             void zeroElementsWithKey(AllocationTracker::Block* key);
 
             void render(const PrimType primType) const;
+            /**
+             * Renders only the given (offset, count) ranges of indices, which must be allocations returned by
+             * getPointerToInsertElementsAt() or unions of adjacent allocations.
+             */
+            void render(const PrimType primType, const std::vector<std::pair<size_t, size_t>>& ranges) const;
             bool prepared() const;
             void prepare(Vbo& vbo);
         };
@@ -311,6 +343,16 @@ namespace TrenchBroom {
              */
             std::pair<AllocationTracker::Block*, Vertex*> getPointerToInsertVerticesAt(size_t vertexCount);
 
+            /**
+             * Same as BrushIndexArray::allocateElements() but for vertices.
+             */
+            AllocationTracker::Block* allocateVertices(size_t vertexCount);
+
+            /**
+             * Same as BrushIndexArray::getPointerToWriteElements() but for vertices.
+             */
+            Vertex* getPointerToWriteVertices(const AllocationTracker::Block* key);
+
             void deleteVerticesWithKey(AllocationTracker::Block* key);
 
             // setting up GL attributes
@@ -26,6 +26,8 @@
 #include "Renderer/VertexArray.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -37,6 +39,8 @@ namespace TrenchBroom {
 
         using BrushVertexArrayPtr = std::shared_ptr<BrushVertexArray>;
         using BrushIndexArrayPtr = std::shared_ptr<BrushIndexArray>;
+        using BrushIndexRanges = std::vector<std::pair<size_t, size_t>>;
+        using BrushIndexRangesPtr = std::shared_ptr<const BrushIndexRanges>;
 
         class EdgeRenderer {
         public:
@@ -111,8 +115,9 @@ namespace TrenchBroom {
             private:
                 BrushVertexArrayPtr m_vertexArray;
                 BrushIndexArrayPtr m_indexArray;
+                BrushIndexRangesPtr m_visibleRanges;
             public:
-                Render(const Params& params, BrushVertexArrayPtr vertexArray, BrushIndexArrayPtr indexArray);
+                Render(const Params& params, BrushVertexArrayPtr vertexArray, BrushIndexArrayPtr indexArray, BrushIndexRangesPtr visibleRanges);
             private:
                 void prepareVerticesAndIndices(Vbo& vertexVbo, Vbo& indexVbo) override;
                 void doRender(RenderContext& renderContext) override;
@@ -121,9 +126,15 @@ namespace TrenchBroom {
         private:
             BrushVertexArrayPtr m_vertexArray;
             BrushIndexArrayPtr m_indexArray;
+            BrushIndexRangesPtr m_visibleRanges;
         public:
             IndexedEdgeRenderer();
             IndexedEdgeRenderer(BrushVertexArrayPtr vertexArray, BrushIndexArrayPtr indexArray);
+            /**
+             * Creates a copy of the given renderer that only renders the given index ranges, e.g. the edges of the
+             * brushes within the view frustum. If null, all indices are rendered.
+             */
+            IndexedEdgeRenderer(const IndexedEdgeRenderer& other, BrushIndexRangesPtr visibleRanges);
 
             IndexedEdgeRenderer(const IndexedEdgeRenderer& other);
             IndexedEdgeRenderer& operator=(IndexedEdgeRenderer other);
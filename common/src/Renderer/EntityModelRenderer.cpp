@@ -22,10 +22,12 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "CollectionUtils.h"
+#include "HalfSpaceUtils.h"
 #include "Assets/EntityModel.h"
 #include "Assets/EntityModelManager.h"
 #include "Model/EditorContext.h"
 #include "Model/Entity.h"
+#include "Renderer/Camera.h"
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/Shaders.h"
@@ -33,7 +35,9 @@
 #include "Renderer/TexturedIndexRangeRenderer.h"
 #include "Renderer/Transformation.h"
 
+#include <vecmath/bbox.h>
 #include <vecmath/mat.h>
+#include <vecmath/plane.h>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -123,11 +127,18 @@ namespace TrenchBroom {
             glAssert(glEnable(GL_TEXTURE_2D));
             glAssert(glActiveTexture(GL_TEXTURE0));
 
+            vm::plane3f frustumPlanes[4];
+            renderContext.camera().frustumPlanes(frustumPlanes[0], frustumPlanes[1], frustumPlanes[2], frustumPlanes[3]);
+
             for (const auto& entry : m_entities) {
                 auto* entity = entry.first;
                 if (!m_showHiddenEntities && !m_editorContext.visible(entity)) {
                     continue;
                 }
+                const auto& bounds = entity->physicalBounds();
+                if (HalfSpaceUtils::boxOutside(frustumPlanes, bounds.min, bounds.max)) {
+                    continue;
+                }
 
                 auto* renderer = entry.second;
 
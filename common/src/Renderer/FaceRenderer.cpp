@@ -77,12 +77,18 @@ namespace TrenchBroom {
         IndexedRenderable(other),
         m_vertexArray(other.m_vertexArray),
         m_indexArrayMap(other.m_indexArrayMap),
+        m_visibleRanges(other.m_visibleRanges),
         m_faceColor(other.m_faceColor),
         m_grayscale(other.m_grayscale),
         m_tint(other.m_tint),
         m_tintColor(other.m_tintColor),
         m_alpha(other.m_alpha) {}
 
+        FaceRenderer::FaceRenderer(const FaceRenderer& other, TextureToBrushIndexRangesMapPtr visibleRanges) :
+        FaceRenderer(other) {
+            m_visibleRanges = std::move(visibleRanges);
+        }
+
         FaceRenderer& FaceRenderer::operator=(FaceRenderer other) {
             using std::swap;
             swap(*this, other);
@@ -93,6 +99,7 @@ namespace TrenchBroom {
             using std::swap;
             swap(left.m_vertexArray, right.m_vertexArray);
             swap(left.m_indexArrayMap, right.m_indexArrayMap);
+            swap(left.m_visibleRanges, right.m_visibleRanges);
             swap(left.m_faceColor, right.m_faceColor);
             swap(left.m_grayscale, right.m_grayscale);
             swap(left.m_tint, right.m_tint);
@@ -167,9 +174,18 @@ namespace TrenchBroom {
                     if (!brushIndexHolderPtr->hasValidIndices()) {
                         continue;
                     }
-                    func.before(texture);
-                    brushIndexHolderPtr->render(GL_TRIANGLES);
-                    func.after(texture);
+                    if (m_visibleRanges == nullptr) {
+                        func.before(texture);
+                        brushIndexHolderPtr->render(GL_TRIANGLES);
+                        func.after(texture);
+                    } else {
+                        const auto it = m_visibleRanges->find(texture);
+                        if (it != std::end(*m_visibleRanges) && !it->second.empty()) {
+                            func.before(texture);
+                            brushIndexHolderPtr->render(GL_TRIANGLES, it->second);
+                            func.after(texture);
+                        }
+                    }
                 }
                 if (m_alpha < 1.0f) {
                     glAssert(glDepthMask(GL_TRUE));
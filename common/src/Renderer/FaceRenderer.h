@@ -26,6 +26,8 @@
 
 #include <memory>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -39,6 +41,9 @@ namespace TrenchBroom {
         using BrushVertexArrayPtr = std::shared_ptr<BrushVertexArray>;
         using TextureToBrushIndicesMap = std::unordered_map<const Assets::Texture*, std::shared_ptr<BrushIndexArray>>;
         using TextureToBrushIndicesMapPtr = std::shared_ptr<const TextureToBrushIndicesMap>;
+        using BrushIndexRanges = std::vector<std::pair<size_t, size_t>>;
+        using TextureToBrushIndexRangesMap = std::unordered_map<const Assets::Texture*, BrushIndexRanges>;
+        using TextureToBrushIndexRangesMapPtr = std::shared_ptr<const TextureToBrushIndexRangesMap>;
 
         class FaceRenderer : public IndexedRenderable {
         private:
@@ -46,6 +51,7 @@ namespace TrenchBroom {
 
             BrushVertexArrayPtr m_vertexArray;
             TextureToBrushIndicesMapPtr m_indexArrayMap;
+            TextureToBrushIndexRangesMapPtr m_visibleRanges;
             Color m_faceColor;
             bool m_grayscale;
             bool m_tint;
@@ -54,6 +60,11 @@ namespace TrenchBroom {
         public:
             FaceRenderer();
             FaceRenderer(BrushVertexArrayPtr vertexArray, TextureToBrushIndicesMapPtr indexArrayMap, const Color& faceColor);
+            /**
+             * Creates a copy of the given renderer that only renders the given index ranges per texture, e.g. the faces
+             * of the brushes within the view frustum. If null, all indices are rendered.
+             */
+            FaceRenderer(const FaceRenderer& other, TextureToBrushIndexRangesMapPtr visibleRanges);
 
             FaceRenderer(const FaceRenderer& other);
             FaceRenderer& operator=(FaceRenderer other);
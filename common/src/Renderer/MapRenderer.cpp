@@ -123,7 +123,9 @@ namespace TrenchBroom {
         m_defaultRenderer(createDefaultRenderer(m_document)),
         m_selectionRenderer(createSelectionRenderer(m_document)),
         m_lockedRenderer(createLockRenderer(m_document)),
-        m_entityLinkRenderer(std::make_unique<EntityLinkRenderer>(m_document)) {
+        m_entityLinkRenderer(std::make_unique<EntityLinkRenderer>(m_document)),
+        m_deferRendererUpdates(false),
+        m_pendingRendererUpdates(0) {
             bindObservers();
             setupRenderers();
         }
@@ -159,6 +161,7 @@ namespace TrenchBroom {
             m_selectionRenderer->clear();
             m_lockedRenderer->clear();
             m_entityLinkRenderer->invalidate();
+            m_pendingRendererUpdates = 0;
         }
 
         void MapRenderer::overrideSelectionColors(const Color& color, const float mix) {
@@ -177,6 +180,7 @@ namespace TrenchBroom {
         }
 
         void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
+            updatePendingRenderers();
             commitPendingChanges();
             setupGL(renderBatch);
             renderDefaultOpaque(renderContext, renderBatch);
@@ -369,6 +373,22 @@ namespace TrenchBroom {
         };
 
         void MapRenderer::updateRenderers(const Renderer renderers) {
+            if (m_deferRendererUpdates) {
+                m_pendingRendererUpdates |= renderers;
+            } else {
+                doUpdateRenderers(renderers);
+            }
+        }
+
+        void MapRenderer::updatePendingRenderers() {
+            if (m_pendingRendererUpdates != 0) {
+                doUpdateRenderers(static_cast<Renderer>(m_pendingRendererUpdates));
+            }
+        }
+
+        void MapRenderer::doUpdateRenderers(const Renderer renderers) {
+            m_pendingRendererUpdates = 0;
+
             View::MapDocumentSPtr document = lock(m_document);
             Model::World* world = document->world();
 
@@ -430,6 +450,8 @@ namespace TrenchBroom {
             document->documentWasClearedNotifier.addObserver(this, &MapRenderer::documentWasCleared);
             document->documentWasNewedNotifier.addObserver(this, &MapRenderer::documentWasNewedOrLoaded);
             document->documentWasLoadedNotifier.addObserver(this, &MapRenderer::documentWasNewedOrLoaded);
+            document->transactionWillBeginNotifier.addObserver(this, &MapRenderer::transactionWillBegin);
+            document->transactionDidEndNotifier.addObserver(this, &MapRenderer::transactionDidEnd);
             document->nodesWereAddedNotifier.addObserver(this, &MapRenderer::nodesWereAdded);
             document->nodesWereRemovedNotifier.addObserver(this, &MapRenderer::nodesWereRemoved);
             document->nodesDidChangeNotifier.addObserver(this, &MapRenderer::nodesDidChange);
@@ -455,6 +477,8 @@ namespace TrenchBroom {
                 document->documentWasClearedNotifier.removeObserver(this, &MapRenderer::documentWasCleared);
                 document->documentWasNewedNotifier.removeObserver(this, &MapRenderer::documentWasNewedOrLoaded);
                 document->documentWasLoadedNotifier.removeObserver(this, &MapRenderer::documentWasNewedOrLoaded);
+                document->transactionWillBeginNotifier.removeObserver(this, &MapRenderer::transactionWillBegin);
+                document->transactionDidEndNotifier.removeObserver(this, &MapRenderer::transactionDidEnd);
                 document->nodesWereAddedNotifier.removeObserver(this, &MapRenderer::nodesWereAdded);
                 document->nodesWereRemovedNotifier.removeObserver(this, &MapRenderer::nodesWereRemoved);
                 document->nodesDidChangeNotifier.removeObserver(this, &MapRenderer::nodesDidChange);
@@ -484,12 +508,22 @@ namespace TrenchBroom {
             updateRenderers(Renderer_All);
         }
 
+        void MapRenderer::transactionWillBegin() {
+            m_deferRendererUpdates = true;
+        }
+
+        void MapRenderer::transactionDidEnd() {
+            m_deferRendererUpdates = false;
+            updatePendingRenderers();
+        }
+
         void MapRenderer::nodesWereAdded(const Model::NodeList& nodes) {
             updateRenderers(Renderer_Default);
         }
 
         void MapRenderer::nodesWereRemoved(const Model::NodeList& nodes) {
-            updateRenderers(Renderer_Default);
+            // the removed nodes might be deleted soon, so the renderers must not hold on to them
+            doUpdateRenderers(static_cast<Renderer>(m_pendingRendererUpdates | Renderer_Default));
         }
 
         void MapRenderer::nodesDidChange(const Model::NodeList& nodes) {
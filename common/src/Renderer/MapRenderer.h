@@ -58,6 +58,9 @@ namespace TrenchBroom {
             std::unique_ptr<ObjectRenderer> m_selectionRenderer;
             std::unique_ptr<ObjectRenderer> m_lockedRenderer;
             std::unique_ptr<EntityLinkRenderer> m_entityLinkRenderer;
+
+            bool m_deferRendererUpdates;
+            int m_pendingRendererUpdates;
         public:
             explicit MapRenderer(View::MapDocumentWPtr document);
             ~MapRenderer();
@@ -106,8 +109,13 @@ namespace TrenchBroom {
              * but doesn't otherwise invalidate them.
              * (in particular, brushes are not updated unless they move between renderers.)
              * If brushes are modified, you need to call invalidateRenderers() or invalidateObjectsInRenderers()
+             *
+             * While a transaction is running, the given renderers are only marked for updating, and they are
+             * updated once before rendering or when the transaction ends.
              */
             void updateRenderers(Renderer renderers);
+            void updatePendingRenderers();
+            void doUpdateRenderers(Renderer renderers);
             void invalidateRenderers(Renderer renderers);
             void invalidateBrushesInRenderers(Renderer renderers, const Model::BrushList& brushes);
             void invalidateEntityLinkRenderer();
@@ -119,6 +127,9 @@ namespace TrenchBroom {
             void documentWasCleared(View::MapDocument* document);
             void documentWasNewedOrLoaded(View::MapDocument* document);
 
+            void transactionWillBegin();
+            void transactionDidEnd();
+
             void nodesWereAdded(const Model::NodeList& nodes);
             void nodesWereRemoved(const Model::NodeList& nodes);
             void nodesDidChange(const Model::NodeList& nodes);
@@ -21,6 +21,7 @@
 
 #include "CollectionUtils.h"
 #include "Macros.h"
+#include "Model/EstimateMemorySizeVisitor.h"
 #include "Model/Node.h"
 #include "View/MapDocumentCommandFacade.h"
 
@@ -52,7 +53,8 @@ namespace TrenchBroom {
 
         AddRemoveNodesCommand::AddRemoveNodesCommand(const Action action, const Model::ParentChildrenMap& nodes) :
         DocumentCommand(Type, makeName(action)),
-        m_action(action) {
+        m_action(action),
+        m_nodesToAddSize(0) {
             switch (m_action) {
                 case Action_Add:
                     m_nodesToAdd = nodes;
@@ -86,6 +88,7 @@ namespace TrenchBroom {
 
             using std::swap;
             std::swap(m_nodesToAdd, m_nodesToRemove);
+            m_nodesToAddSize = Model::estimateMemorySize(m_nodesToAdd);
 
             return true;
         }
@@ -102,6 +105,7 @@ namespace TrenchBroom {
 
             using std::swap;
             std::swap(m_nodesToAdd, m_nodesToRemove);
+            m_nodesToAddSize = Model::estimateMemorySize(m_nodesToAdd);
 
             return true;
         }
@@ -113,5 +117,10 @@ namespace TrenchBroom {
         bool AddRemoveNodesCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t AddRemoveNodesCommand::doGetMemorySize() const {
+            // the nodes to add are owned by this command
+            return m_nodesToAddSize;
+        }
     }
 }
@@ -38,6 +38,7 @@ namespace TrenchBroom {
             Action m_action;
             Model::ParentChildrenMap m_nodesToAdd;
             Model::ParentChildrenMap m_nodesToRemove;
+            size_t m_nodesToAddSize;
         public:
             static Ptr add(Model::Node* parent, const Model::NodeList& children);
             static Ptr add(const Model::ParentChildrenMap& nodes);
@@ -53,6 +54,7 @@ namespace TrenchBroom {
             bool doIsRepeatable(MapDocumentCommandFacade* document) const override;
 
             bool doCollateWith(UndoableCommand::Ptr command) override;
+            size_t doGetMemorySize() const override;
         };
     }
 }
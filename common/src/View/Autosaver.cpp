@@ -22,10 +22,14 @@
 #include "Exceptions.h"
 #include "StringUtils.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/IOUtils.h"
+#include "View/CachingLogger.h"
 #include "View/MapDocument.h"
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdio>
 
 namespace TrenchBroom {
     namespace View {
@@ -70,10 +74,16 @@ namespace TrenchBroom {
         Autosaver::~Autosaver() {
             unbindObservers();
             NullLogger logger;
+            waitForPendingSave(logger);
             triggerAutosave(logger);
+            waitForPendingSave(logger);
         }
 
         void Autosaver::triggerAutosave(Logger& logger) {
+            if (!finishPendingSave(logger)) {
+                return;
+            }
+
             const auto currentTime = std::time(nullptr);
 
             auto document = lock(m_document);
@@ -101,10 +111,47 @@ namespace TrenchBroom {
             autosave(logger, document);
         }
 
+        void Autosaver::waitForPendingSave(Logger& logger) {
+            if (m_pendingSave.valid()) {
+                m_pendingSave.wait();
+                finishPendingSave(logger);
+            }
+        }
+
+        bool Autosaver::finishPendingSave(Logger& logger) {
+            if (!m_pendingSave.valid()) {
+                return true;
+            }
+            if (m_pendingSave.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return false;
+            }
+
+            auto messages = m_pendingSave.get();
+            messages->setParentLogger(&logger);
+            return true;
+        }
+
         void Autosaver::autosave(Logger& logger, MapDocumentSPtr document) {
-            const auto& mapPath = document->path();
+            const auto mapPath = document->path();
             assert(IO::Disk::fileExists(IO::Disk::fixPath(mapPath)));
 
+            // Taking the snapshot is the only part that needs access to the nodes. It shares the cached text of
+            // unchanged nodes, so only modified nodes are serialized here. Writing the snapshot and thinning out the
+            // old backups is done by a worker thread.
+            IO::MapTextSnapshot snapshot;
+            document->serializeDocument(snapshot);
+
+            m_lastSaveTime = std::time(nullptr);
+            m_lastModificationCount = document->modificationCount();
+
+            m_pendingSave = std::async(std::launch::async, [this, mapPath, snapshot = std::move(snapshot)]() {
+                auto messages = std::make_unique<CachingLogger>();
+                writeBackup(*messages, mapPath, snapshot);
+                return messages;
+            });
+        }
+
+        void Autosaver::writeBackup(Logger& logger, const IO::Path& mapPath, const IO::MapTextSnapshot& snapshot) const {
             const auto mapFilename = mapPath.lastComponent();
             const auto mapBasename = mapFilename.deleteExtension();
 
@@ -120,9 +167,8 @@ namespace TrenchBroom {
 
                 const auto backupFilePath = fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
 
-                m_lastSaveTime = std::time(nullptr);
-                m_lastModificationCount = document->modificationCount();
-                document->saveDocumentTo(backupFilePath);
+                IO::OpenFile file(backupFilePath, true);
+                snapshot.writeTo(file.file);
 
                 logger.info() << "Created autosave backup at " << backupFilePath;
             } catch (const FileSystemException& e) {
@@ -20,10 +20,14 @@
 #ifndef TrenchBroom_Autosaver
 #define TrenchBroom_Autosaver
 
+#include "StringType.h"
+#include "IO/MapTextSnapshot.h"
 #include "IO/Path.h"
 #include "View/ViewTypes.h"
 
 #include <ctime>
+#include <future>
+#include <memory>
 
 namespace TrenchBroom {
     class Logger;
@@ -33,6 +37,7 @@ namespace TrenchBroom {
     }
 
     namespace View {
+        class CachingLogger;
         class Command;
 
         class Autosaver {
@@ -77,13 +82,35 @@ namespace TrenchBroom {
              * The modification count that was last recorded.
              */
             size_t m_lastModificationCount;
+
+            /**
+             * The backup that is currently being written on a worker thread, if any. Its result holds the messages that
+             * were logged while writing it, which are passed on to the actual logger once the backup is done.
+             */
+            std::future<std::unique_ptr<CachingLogger>> m_pendingSave;
         public:
             explicit Autosaver(View::MapDocumentWPtr document, std::time_t saveInterval = 10 * 60, std::time_t idleInterval = 3, size_t maxBackups = 50);
             ~Autosaver();
 
+            /**
+             * Creates a new backup if the autosave conditions are met. The document is serialized on the calling
+             * thread, but the backup is written to disk on a worker thread, so this function does not wait for any
+             * file system operations. No new backup is created while the previous one is still being written.
+             */
             void triggerAutosave(Logger& logger);
+
+            /**
+             * Blocks until the backup that is currently being written, if any, is done, and logs its messages.
+             */
+            void waitForPendingSave(Logger& logger);
         private:
+            /**
+             * Logs the messages of the backup that was written in the background, if it is done. Returns false if the
+             * backup is still being written.
+             */
+            bool finishPendingSave(Logger& logger);
             void autosave(Logger& logger, View::MapDocumentSPtr document);
+            void writeBackup(Logger& logger, const IO::Path& mapPath, const IO::MapTextSnapshot& snapshot) const;
             IO::WritableDiskFileSystem createBackupFileSystem(Logger& logger, const IO::Path& mapPath) const;
             IO::Path::List collectBackups(const IO::WritableDiskFileSystem& fs, const IO::Path& mapBasename) const;
             void thinBackups(Logger& logger, IO::WritableDiskFileSystem& fs, IO::Path::List& backups) const;
@@ -63,7 +63,8 @@ namespace TrenchBroom {
 
         ChangeEntityAttributesCommand::ChangeEntityAttributesCommand(const Action action) :
         DocumentCommand(Type, makeName(action)),
-        m_action(action) {}
+        m_action(action),
+        m_snapshotsSize(0) {}
 
         String ChangeEntityAttributesCommand::makeName(const Action action) {
             switch (action) {
@@ -89,12 +90,14 @@ namespace TrenchBroom {
                     m_snapshots = document->performRenameAttribute(m_oldName, m_newName);
                     break;
             };
+            m_snapshotsSize = Model::EntityAttributeSnapshot::memorySize(m_snapshots);
             return true;
         }
 
         bool ChangeEntityAttributesCommand::doPerformUndo(MapDocumentCommandFacade* document) {
             document->restoreAttributes(m_snapshots);
             m_snapshots.clear();
+            m_snapshotsSize = 0;
             return true;
         }
 
@@ -112,5 +115,9 @@ namespace TrenchBroom {
             m_newValue = other->m_newValue;
             return true;
         }
+
+        size_t ChangeEntityAttributesCommand::doGetMemorySize() const {
+            return m_snapshotsSize;
+        }
     }
 }
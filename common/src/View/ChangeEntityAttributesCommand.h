@@ -45,6 +45,7 @@ namespace TrenchBroom {
             Model::AttributeValue m_newValue;
 
             Model::EntityAttributeSnapshot::Map m_snapshots;
+            size_t m_snapshotsSize;
         public:
             static Ptr set(const Model::AttributeName& name, const Model::AttributeValue& value);
             static Ptr remove(const Model::AttributeName& name);
@@ -63,6 +64,7 @@ namespace TrenchBroom {
             bool doIsRepeatable(MapDocumentCommandFacade* document) const override;
 
             bool doCollateWith(UndoableCommand::Ptr command) override;
+            size_t doGetMemorySize() const override;
         };
     }
 }
@@ -25,6 +25,8 @@
 
 #include <QDateTime>
 
+#include <iterator>
+
 namespace TrenchBroom {
     namespace View {
         const Command::CommandType CommandGroup::Type = Command::freeType();
@@ -96,6 +98,27 @@ namespace TrenchBroom {
             return false;
         }
 
+        void CommandGroup::doPrepareCompaction() {
+            // only the last command has left the document in its current state
+            if (!m_commands.empty()) {
+                m_commands.back()->prepareCompaction();
+            }
+        }
+
+        void CommandGroup::doCompact() {
+            if (!m_commands.empty()) {
+                m_commands.back()->compact();
+            }
+        }
+
+        size_t CommandGroup::doGetMemorySize() const {
+            size_t result = 0;
+            for (const auto& command : m_commands) {
+                result += command->memorySize();
+            }
+            return result;
+        }
+
         const int64_t CommandProcessor::CollationInterval = 1000;
 
         struct CommandProcessor::SubmitAndStoreResult {
@@ -111,7 +134,8 @@ namespace TrenchBroom {
         m_document(document),
         m_clearRepeatableCommandStack(false),
         m_lastCommandTimestamp(0),
-        m_groupLevel(0) {
+        m_groupLevel(0),
+        m_memoryBudget(0) {
             ensure(m_document != nullptr, "document is null");
         }
 
@@ -170,6 +194,7 @@ namespace TrenchBroom {
             } else {
                 m_lastCommandStack.clear();
                 m_nextCommandStack.clear();
+                m_lastPerformedCommand = nullptr;
                 return true;
             }
         }
@@ -211,6 +236,8 @@ namespace TrenchBroom {
                     if (pushLastCommand(command, false) && m_groupLevel == 0) {
                         pushRepeatableCommand(command);
                     }
+                    setLastPerformedCommand(command);
+                    enforceMemoryBudget();
                     return true;
                 } else {
                     return false;
@@ -254,6 +281,12 @@ namespace TrenchBroom {
             m_lastCommandStack.clear();
             m_nextCommandStack.clear();
             m_lastCommandTimestamp = 0;
+            m_lastPerformedCommand = nullptr;
+        }
+
+        void CommandProcessor::setMemoryBudget(const size_t memoryBudget) {
+            m_memoryBudget = memoryBudget;
+            enforceMemoryBudget();
         }
 
         CommandProcessor::SubmitAndStoreResult CommandProcessor::submitAndStoreCommand(UndoableCommand::Ptr command, const bool collate) {
@@ -267,10 +300,58 @@ namespace TrenchBroom {
             if (!m_nextCommandStack.empty()) {
                 m_nextCommandStack.clear();
             }
+
+            // if the command was collated, the command it was collated with has left the document in its current state
+            const auto& commands = m_groupLevel == 0 ? m_lastCommandStack : m_groupedCommands;
+            setLastPerformedCommand(!commands.empty() ? commands.back() : nullptr);
+            enforceMemoryBudget();
             return result;
         }
 
+        void CommandProcessor::prepareLastPerformedCommandCompaction() {
+            // the document is still in the state that the last performed command left it in
+            if (m_lastPerformedCommand != nullptr) {
+                m_lastPerformedCommand->prepareCompaction();
+            }
+        }
+
+        void CommandProcessor::setLastPerformedCommand(UndoableCommand::Ptr command) {
+            // if another command was stored separately, the previous command cannot be collated with anymore and can
+            // be compacted using the information gathered before the other command was performed
+            if (m_lastPerformedCommand != nullptr && m_lastPerformedCommand != command) {
+                m_lastPerformedCommand->compact();
+            }
+            m_lastPerformedCommand = command;
+        }
+
+        void CommandProcessor::enforceMemoryBudget() {
+            if (m_memoryBudget == 0) {
+                return;
+            }
+
+            size_t memorySize = 0;
+            for (const auto& command : m_lastCommandStack) {
+                memorySize += command->memorySize();
+            }
+            for (const auto& command : m_nextCommandStack) {
+                memorySize += command->memorySize();
+            }
+
+            // keep the most recent command so that it can always be undone
+            size_t count = 0;
+            while (memorySize > m_memoryBudget && count + 1 < m_lastCommandStack.size()) {
+                memorySize -= m_lastCommandStack[count]->memorySize();
+                ++count;
+            }
+
+            if (count > 0) {
+                m_lastCommandStack.erase(std::begin(m_lastCommandStack), std::next(std::begin(m_lastCommandStack), static_cast<std::ptrdiff_t>(count)));
+            }
+        }
+
         bool CommandProcessor::doCommand(Command::Ptr command) {
+            prepareLastPerformedCommandCompaction();
+
             commandDoNotifier(command);
             if (command->performDo(m_document)) {
                 commandDoneNotifier(command);
@@ -285,6 +366,8 @@ namespace TrenchBroom {
         }
 
         bool CommandProcessor::undoCommand(UndoableCommand::Ptr command) {
+            m_lastPerformedCommand = nullptr;
+
             commandUndoNotifier(command);
             if (command->performUndo(m_document)) {
                 commandUndoneNotifier(command);
@@ -337,6 +420,7 @@ namespace TrenchBroom {
                 m_groupedCommands.clear();
                 pushLastCommand(group, false);
                 pushRepeatableCommand(group);
+                enforceMemoryBudget();
                 transactionDoneNotifier(m_groupName);
             }
             m_groupName = "";
@@ -58,6 +58,9 @@ namespace TrenchBroom {
             UndoableCommand::Ptr doRepeat(MapDocumentCommandFacade* document) const override;
 
             bool doCollateWith(UndoableCommand::Ptr command) override;
+            void doPrepareCompaction() override;
+            void doCompact() override;
+            size_t doGetMemorySize() const override;
         };
 
         class CommandProcessor {
@@ -77,6 +80,18 @@ namespace TrenchBroom {
             CommandStack m_groupedCommands;
             size_t m_groupLevel;
 
+            /**
+             * The most recently performed command if the document is still in the state that it left it in. This
+             * command is prepared for compaction before another command is performed, and it is compacted once the
+             * other command has been stored separately instead of being collated with it.
+             */
+            UndoableCommand::Ptr m_lastPerformedCommand;
+
+            /**
+             * The maximum number of bytes that the undo and redo stacks should occupy, or 0 if they are unlimited.
+             */
+            size_t m_memoryBudget;
+
             struct SubmitAndStoreResult;
         public:
             explicit CommandProcessor(MapDocumentCommandFacade* document);
@@ -117,8 +132,18 @@ namespace TrenchBroom {
             void clearRepeatableCommands();
 
             void clear();
+
+            /**
+             * Sets the maximum number of bytes that the undo and redo stacks should occupy. If they exceed the budget,
+             * the oldest commands are discarded, but the most recent command can always be undone. A budget of 0
+             * means that the stacks are unlimited.
+             */
+            void setMemoryBudget(size_t memoryBudget);
         private:
             SubmitAndStoreResult submitAndStoreCommand(UndoableCommand::Ptr command, bool collate);
+            void prepareLastPerformedCommandCompaction();
+            void setLastPerformedCommand(UndoableCommand::Ptr command);
+            void enforceMemoryBudget();
             bool doCommand(Command::Ptr command);
             bool undoCommand(UndoableCommand::Ptr command);
             bool storeCommand(UndoableCommand::Ptr command, bool collate);
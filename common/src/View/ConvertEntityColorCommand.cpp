@@ -32,10 +32,12 @@ namespace TrenchBroom {
         ConvertEntityColorCommand::ConvertEntityColorCommand(const Model::AttributeName& attributeName, Assets::ColorRange::Type colorRange) :
         DocumentCommand(Type, "Convert Color"),
         m_attributeName(attributeName),
-        m_colorRange(colorRange) {}
+        m_colorRange(colorRange),
+        m_snapshotsSize(0) {}
 
         bool ConvertEntityColorCommand::doPerformDo(MapDocumentCommandFacade* document) {
             m_snapshots = document->performConvertColorRange(m_attributeName, m_colorRange);
+            m_snapshotsSize = Model::EntityAttributeSnapshot::memorySize(m_snapshots);
             return true;
         }
 
@@ -51,5 +53,9 @@ namespace TrenchBroom {
         bool ConvertEntityColorCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t ConvertEntityColorCommand::doGetMemorySize() const {
+            return m_snapshotsSize;
+        }
     }
 }
@@ -41,6 +41,7 @@ namespace TrenchBroom {
             Assets::ColorRange::Type m_colorRange;
 
             Model::EntityAttributeSnapshot::Map m_snapshots;
+            size_t m_snapshotsSize;
         public:
             static Ptr convert(const Model::AttributeName& attributeName, Assets::ColorRange::Type colorRange);
         private:
@@ -52,6 +53,7 @@ namespace TrenchBroom {
             bool doIsRepeatable(MapDocumentCommandFacade* document) const override;
 
             bool doCollateWith(UndoableCommand::Ptr command) override;
+            size_t doGetMemorySize() const override;
         };
     }
 }
@@ -20,6 +20,7 @@
 #include "DuplicateNodesCommand.h"
 
 #include "CollectionUtils.h"
+#include "Model/EstimateMemorySizeVisitor.h"
 #include "Model/Node.h"
 #include "Model/NodeVisitor.h"
 #include "View/MapDocumentCommandFacade.h"
@@ -34,6 +35,7 @@ namespace TrenchBroom {
 
         DuplicateNodesCommand::DuplicateNodesCommand() :
         DocumentCommand(Type, "Duplicate Objects"),
+        m_addedNodesSize(0),
         m_firstExecution(true) {}
 
         DuplicateNodesCommand::~DuplicateNodesCommand() {
@@ -80,6 +82,7 @@ namespace TrenchBroom {
             document->performAddNodes(m_addedNodes);
             document->performDeselectAll();
             document->performSelect(m_nodesToSelect);
+            m_addedNodesSize = 0;
             return true;
         }
 
@@ -87,6 +90,9 @@ namespace TrenchBroom {
             document->performDeselectAll();
             document->performRemoveNodes(m_addedNodes);
             document->performSelect(m_previouslySelectedNodes);
+
+            // the added nodes are owned by this command until it is performed again
+            m_addedNodesSize = Model::estimateMemorySize(m_addedNodes);
             return true;
         }
 
@@ -116,5 +122,9 @@ namespace TrenchBroom {
         bool DuplicateNodesCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t DuplicateNodesCommand::doGetMemorySize() const {
+            return m_addedNodesSize;
+        }
     }
 }
@@ -33,6 +33,7 @@ namespace TrenchBroom {
             Model::NodeList m_previouslySelectedNodes;
             Model::NodeList m_nodesToSelect;
             Model::ParentChildrenMap m_addedNodes;
+            size_t m_addedNodesSize;
             bool m_firstExecution;
         public:
             static Ptr duplicate();
@@ -51,6 +52,7 @@ namespace TrenchBroom {
             UndoableCommand::Ptr doRepeat(MapDocumentCommandFacade* document) const override;
 
             bool doCollateWith(UndoableCommand::Ptr command) override;
+            size_t doGetMemorySize() const override;
         };
     }
 }
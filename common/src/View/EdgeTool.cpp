@@ -20,6 +20,7 @@
 #include "EdgeTool.h"
 
 #include "TrenchBroom.h"
+#include "StringUtils.h"
 
 namespace TrenchBroom {
     namespace View {
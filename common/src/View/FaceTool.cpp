@@ -20,6 +20,7 @@
 #include "FaceTool.h"
 
 #include "TrenchBroom.h"
+#include "StringUtils.h"
 
 namespace TrenchBroom {
     namespace View {
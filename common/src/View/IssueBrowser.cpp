@@ -40,7 +40,9 @@ namespace TrenchBroom {
         m_document(document),
         m_view(new IssueBrowserView(m_document)),
         m_showHiddenIssuesCheckBox(nullptr),
-        m_filterEditor(nullptr) {
+        m_filterEditor(nullptr),
+        m_deferReload(false),
+        m_reloadPending(false) {
             auto* sizer = new QVBoxLayout();
             sizer->setContentsMargins(0, 0, 0, 0);
             sizer->addWidget(m_view);
@@ -77,6 +79,8 @@ namespace TrenchBroom {
             document->documentWasSavedNotifier.addObserver(this, &IssueBrowser::documentWasSaved);
             document->documentWasNewedNotifier.addObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
             document->documentWasLoadedNotifier.addObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
+            document->transactionWillBeginNotifier.addObserver(this, &IssueBrowser::transactionWillBegin);
+            document->transactionDidEndNotifier.addObserver(this, &IssueBrowser::transactionDidEnd);
             document->nodesWereAddedNotifier.addObserver(this, &IssueBrowser::nodesWereAdded);
             document->nodesWereRemovedNotifier.addObserver(this, &IssueBrowser::nodesWereRemoved);
             document->nodesDidChangeNotifier.addObserver(this, &IssueBrowser::nodesDidChange);
@@ -89,6 +93,8 @@ namespace TrenchBroom {
                 document->documentWasSavedNotifier.removeObserver(this, &IssueBrowser::documentWasSaved);
                 document->documentWasNewedNotifier.removeObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
                 document->documentWasLoadedNotifier.removeObserver(this, &IssueBrowser::documentWasNewedOrLoaded);
+                document->transactionWillBeginNotifier.removeObserver(this, &IssueBrowser::transactionWillBegin);
+                document->transactionDidEndNotifier.removeObserver(this, &IssueBrowser::transactionDidEnd);
                 document->nodesWereAddedNotifier.removeObserver(this, &IssueBrowser::nodesWereAdded);
                 document->nodesWereRemovedNotifier.removeObserver(this, &IssueBrowser::nodesWereRemoved);
                 document->nodesDidChangeNotifier.removeObserver(this, &IssueBrowser::nodesDidChange);
@@ -105,20 +111,44 @@ namespace TrenchBroom {
             m_view->update();
         }
 
+        void IssueBrowser::transactionWillBegin() {
+            m_deferReload = true;
+        }
+
+        void IssueBrowser::transactionDidEnd() {
+            m_deferReload = false;
+            if (m_reloadPending) {
+                reload();
+            }
+        }
+
+        void IssueBrowser::reload() {
+            if (m_deferReload) {
+                if (!m_reloadPending) {
+                    // the issues of the changed nodes are deleted, so they must not be shown until the view is reloaded
+                    m_view->clearIssues();
+                    m_reloadPending = true;
+                }
+            } else {
+                m_reloadPending = false;
+                m_view->reload();
+            }
+        }
+
         void IssueBrowser::nodesWereAdded(const Model::NodeList& nodes) {
-            m_view->reload();
+            reload();
         }
 
         void IssueBrowser::nodesWereRemoved(const Model::NodeList& nodes) {
-            m_view->reload();
+            reload();
         }
 
         void IssueBrowser::nodesDidChange(const Model::NodeList& nodes) {
-            m_view->reload();
+            reload();
         }
 
         void IssueBrowser::brushFacesDidChange(const Model::BrushFaceList& faces) {
-            m_view->reload();
+            reload();
         }
 
         void IssueBrowser::issueIgnoreChanged(Model::Issue* issue) {
@@ -50,6 +50,12 @@ namespace TrenchBroom {
             IssueBrowserView* m_view;
             QCheckBox* m_showHiddenIssuesCheckBox;
             FlagsPopupEditor* m_filterEditor;
+
+            /**
+             * While a transaction is running, the view is only reloaded once when the transaction ends.
+             */
+            bool m_deferReload;
+            bool m_reloadPending;
         public:
             explicit IssueBrowser(MapDocumentWPtr document, QWidget* parent = nullptr);
             ~IssueBrowser() override;
@@ -60,6 +66,9 @@ namespace TrenchBroom {
             void unbindObservers();
             void documentWasNewedOrLoaded(MapDocument* document);
             void documentWasSaved(MapDocument* document);
+            void transactionWillBegin();
+            void transactionDidEnd();
+            void reload();
             void nodesWereAdded(const Model::NodeList& nodes);
             void nodesWereRemoved(const Model::NodeList& nodes);
             void nodesDidChange(const Model::NodeList& nodes);
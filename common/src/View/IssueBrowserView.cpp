@@ -19,8 +19,11 @@
 
 #include "IssueBrowserView.h"
 
-#include "Model/CollectMatchingIssuesVisitor.h"
+#include "CollectionUtils.h"
+#include "ParallelUtils.h"
+#include "Model/CollectNodesVisitor.h"
 #include "Model/Issue.h"
+#include "Model/IssueGenerator.h"
 #include "Model/IssueQuickFix.h"
 #include "Model/World.h"
 #include "View/MapDocument.h"
@@ -32,6 +35,11 @@
 #include <QHeaderView>
 #include <QItemSelectionModel>
 
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
 namespace TrenchBroom {
     namespace View {
         IssueBrowserView::IssueBrowserView(MapDocumentWPtr document, QWidget* parent) :
@@ -39,7 +47,9 @@ namespace TrenchBroom {
         m_document(document),
         m_hiddenGenerators(0),
         m_showHiddenIssues(false),
-        m_valid(false) {
+        m_valid(false),
+        m_validationChunkSize(DefaultValidationChunkSize),
+        m_nextPendingNode(0) {
             createGui();
             bindEvents();
         }
@@ -81,10 +91,33 @@ namespace TrenchBroom {
             invalidate();
         }
 
+        void IssueBrowserView::clearIssues() {
+            // a pending validation stops once it finds that the issues are no longer valid
+            m_valid = false;
+
+            m_pendingNodes.clear();
+            m_nextPendingNode = 0;
+            m_pendingIssues.clear();
+            m_tableModel->setIssues(Model::IssueList());
+        }
+
         void IssueBrowserView::deselectAll() {
             m_tableView->clearSelection();
         }
 
+        void IssueBrowserView::setValidationChunkSize(const size_t validationChunkSize) {
+            ensure(validationChunkSize > 0, "validation chunk size must be positive");
+            m_validationChunkSize = validationChunkSize;
+        }
+
+        bool IssueBrowserView::validating() const {
+            return !m_pendingNodes.empty();
+        }
+
+        const Model::IssueList& IssueBrowserView::issues() const {
+            return m_tableModel->issues();
+        }
+
         class IssueBrowserView::IssueVisible {
             int m_hiddenTypes;
             bool m_showHiddenIssues;
@@ -123,18 +156,99 @@ namespace TrenchBroom {
             document->select(nodes);
         }
 
+        /**
+         * Starts validating the issues of all nodes of the world. The nodes are validated in chunks on worker threads,
+         * and the issues of each chunk are added to the table as soon as the chunk is done. If the issues are
+         * invalidated before all chunks are done, the remaining chunks are discarded.
+         */
         void IssueBrowserView::updateIssues() {
+            m_pendingNodes.clear();
+            m_nextPendingNode = 0;
+            m_pendingIssues.clear();
+
             MapDocumentSPtr document = lock(m_document);
             Model::World* world = document->world();
             if (world != nullptr) {
+                // the world is validated up front because some generators keep state when validating worldspawn
                 const Model::IssueGeneratorList& issueGenerators = world->registeredIssueGenerators();
-                Model::CollectMatchingIssuesVisitor<IssueVisible> visitor(issueGenerators, IssueVisible(m_hiddenGenerators, m_showHiddenIssues));
+                world->validateIssues(issueGenerators);
+
+                Model::CollectNodesVisitor visitor;
                 world->acceptAndRecurse(visitor);
+                m_pendingNodes = visitor.nodes();
 
-                Model::IssueList issues = visitor.issues();
-                VectorUtils::sort(issues, IssueCmp());
-                m_tableModel->setIssues(std::move(issues));
+                if (validateNextNodes()) {
+                    finishValidation();
+                } else {
+                    Model::IssueList issues = m_pendingIssues;
+                    VectorUtils::sort(issues, IssueCmp());
+                    m_tableModel->setIssues(std::move(issues));
+                    QMetaObject::invokeMethod(this, "continueValidation", Qt::QueuedConnection);
+                }
+            }
+        }
+
+        /**
+         * Validates the issues of the next chunk of pending nodes and collects the visible issues. Returns true if
+         * there are no more pending nodes.
+         *
+         * The thread safe generators are run on worker threads, and the remaining generators are run on this thread
+         * afterwards.
+         */
+        bool IssueBrowserView::validateNextNodes() {
+            MapDocumentSPtr document = lock(m_document);
+            const Model::IssueGeneratorList& issueGenerators = document->world()->registeredIssueGenerators();
+
+            Model::IssueGeneratorList concurrentGenerators, serialGenerators;
+            for (Model::IssueGenerator* generator : issueGenerators) {
+                if (generator->isThreadSafe()) {
+                    concurrentGenerators.push_back(generator);
+                } else {
+                    serialGenerators.push_back(generator);
+                }
             }
+
+            const size_t begin = m_nextPendingNode;
+            const size_t end = std::min(begin + m_validationChunkSize, m_pendingNodes.size());
+
+            std::vector<Model::IssueList> generatedIssues(end - begin);
+            ParallelUtils::parallelFor(end - begin, [&](const size_t i) {
+                Model::Node* node = m_pendingNodes[begin + i];
+                if (!node->issuesValid()) {
+                    node->generateIssues(concurrentGenerators, generatedIssues[i]);
+                }
+            }, 64);
+
+            for (size_t i = begin; i < end; ++i) {
+                Model::Node* node = m_pendingNodes[i];
+                if (!node->issuesValid()) {
+                    Model::IssueList& issues = generatedIssues[i - begin];
+                    node->generateIssues(serialGenerators, issues);
+                    node->setIssues(std::move(issues));
+                }
+            }
+
+            const IssueVisible visible(m_hiddenGenerators, m_showHiddenIssues);
+            for (size_t i = begin; i < end; ++i) {
+                for (Model::Issue* issue : m_pendingNodes[i]->issues(issueGenerators)) {
+                    if (visible(issue)) {
+                        m_pendingIssues.push_back(issue);
+                    }
+                }
+            }
+
+            m_nextPendingNode = end;
+            return m_nextPendingNode == m_pendingNodes.size();
+        }
+
+        void IssueBrowserView::finishValidation() {
+            Model::IssueList issues = std::move(m_pendingIssues);
+            VectorUtils::sort(issues, IssueCmp());
+            m_tableModel->setIssues(std::move(issues));
+
+            m_pendingNodes.clear();
+            m_nextPendingNode = 0;
+            m_pendingIssues.clear();
         }
 
         void IssueBrowserView::applyQuickFix(const Model::IssueQuickFix* quickFix) {
@@ -262,6 +376,23 @@ namespace TrenchBroom {
             }
         }
 
+        void IssueBrowserView::continueValidation() {
+            // a pending validation is stale if the issues were invalidated in the meantime
+            if (!m_valid || m_pendingNodes.empty()) {
+                return;
+            }
+
+            const size_t first = m_pendingIssues.size();
+            if (validateNextNodes()) {
+                finishValidation();
+            } else {
+                Model::IssueList issues(std::next(std::begin(m_pendingIssues), static_cast<std::ptrdiff_t>(first)), std::end(m_pendingIssues));
+                VectorUtils::sort(issues, IssueCmp());
+                m_tableModel->addIssues(issues);
+                QMetaObject::invokeMethod(this, "continueValidation", Qt::QueuedConnection);
+            }
+        }
+
         // IssueBrowserModel
 
         IssueBrowserModel::IssueBrowserModel(QObject* parent)
@@ -274,7 +405,19 @@ namespace TrenchBroom {
             endResetModel();
         }
 
-        const Model::IssueList& IssueBrowserModel::issues() {
+        void IssueBrowserModel::addIssues(const Model::IssueList& issues) {
+            if (issues.empty()) {
+                return;
+            }
+
+            const auto first = static_cast<int>(m_issues.size());
+            const auto last = first + static_cast<int>(issues.size()) - 1;
+            beginInsertRows(QModelIndex(), first, last);
+            VectorUtils::append(m_issues, issues);
+            endInsertRows();
+        }
+
+        const Model::IssueList& IssueBrowserModel::issues() const {
             return m_issues;
         }
 
@@ -46,6 +46,16 @@ namespace TrenchBroom {
 
             bool m_valid;
 
+            /**
+             * The number of nodes whose issues are validated before control is returned to the event loop.
+             */
+            static const size_t DefaultValidationChunkSize = 4096;
+            size_t m_validationChunkSize;
+
+            Model::NodeList m_pendingNodes;
+            size_t m_nextPendingNode;
+            Model::IssueList m_pendingIssues;
+
             QTableView* m_tableView;
             IssueBrowserModel* m_tableModel;
         public:
@@ -59,12 +69,27 @@ namespace TrenchBroom {
             void setHiddenGenerators(int hiddenGenerators);
             void setShowHiddenIssues(bool show);
             void reload();
+            /**
+             * Removes all issues from this view and stops a running validation without validating the issues again.
+             * Invalidating the issues of a node deletes them, so this must be called when nodes change and the view is
+             * not reloaded right away.
+             */
+            void clearIssues();
             void deselectAll();
+
+            void setValidationChunkSize(size_t validationChunkSize);
+            /**
+             * Indicates whether some chunks of nodes remain to be validated after control returns to the event loop.
+             */
+            bool validating() const;
+            const Model::IssueList& issues() const;
         private:
             class IssueVisible;
             class IssueCmp;
 
             void updateIssues();
+            bool validateNextNodes();
+            void finishValidation();
 
             Model::IssueList collectIssues(const QList<QModelIndex>& indices) const;
             Model::IssueQuickFixList collectQuickFixes(const QList<QModelIndex>& indices) const;
@@ -85,11 +110,13 @@ namespace TrenchBroom {
             void invalidate();
         public slots:
             void validate();
+            void continueValidation();
         };
 
         /**
          * Trivial QAbstractTableModel subclass, when the issues list changes,
          * it just refreshes the entire list with beginResetModel()/endResetModel().
+         * Issues that are streamed in while the issues are being validated are appended.
          */
         class IssueBrowserModel : public QAbstractTableModel {
             Q_OBJECT
@@ -99,7 +126,8 @@ namespace TrenchBroom {
             explicit IssueBrowserModel(QObject* parent);
 
             void setIssues(Model::IssueList issues);
-            const Model::IssueList& issues();
+            void addIssues(const Model::IssueList& issues);
+            const Model::IssueList& issues() const;
         public: // QAbstractTableModel overrides
             int rowCount(const QModelIndex& parent) const override;
             int columnCount(const QModelIndex& parent) const override;
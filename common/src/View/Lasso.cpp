@@ -29,7 +29,6 @@
 #include <vecmath/plane.h>
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
-#include <vecmath/intersection.h>
 
 namespace TrenchBroom {
     namespace View {
@@ -40,34 +39,54 @@ namespace TrenchBroom {
             m_camera.right(), m_camera.up(), -m_camera.direction(),
             m_camera.defaultPoint(static_cast<float>(m_distance)))),
         m_start(point),
-        m_cur(m_start) {}
+        m_cur(m_start),
+        m_planes(computePlanes()) {}
+
+        Lasso Lasso::aroundPickRay(const Renderer::Camera& camera, const vm::ray3& pickRay, const FloatType handleRadius) {
+            // the lasso rectangle is placed at an arbitrary distance in front of the camera
+            static const FloatType Distance = 64.0;
+
+            const auto cameraPosition = vm::vec3(camera.position());
+            const auto cameraDirection = vm::vec3(camera.direction());
+            const auto cosAngle = dot(pickRay.direction, cameraDirection);
+            const auto center = vm::point_at_distance(pickRay, (Distance - dot(pickRay.origin - cameraPosition, cameraDirection)) / cosAngle);
+
+            // A handle is hit if its distance to the pick ray does not exceed twice the handle radius, scaled by the
+            // perspective. Measured in a plane perpendicular to the camera direction, that distance can be larger by
+            // a factor of 1 / cosAngle, and the rectangle is a bit larger still to allow for rounding errors.
+            const auto scaling = static_cast<FloatType>(camera.perspectiveScalingFactor(vm::vec3f(center)));
+            const auto halfSize = FloatType(1.1) * FloatType(2.0) * handleRadius * scaling / cosAngle;
+            const auto offset = halfSize * (vm::vec3(camera.right()) + vm::vec3(camera.up()));
+
+            Lasso lasso(camera, Distance, center - offset);
+            lasso.update(center + offset);
+            return lasso;
+        }
 
         void Lasso::update(const vm::vec3& point) {
             m_cur = point;
+            m_planes = computePlanes();
         }
 
-        bool Lasso::selects(const vm::vec3& point, const vm::plane3& plane, const vm::bbox2& box) const {
-            const auto projected = project(point, plane);
-            return !vm::is_nan(projected) && box.contains(vm::vec2(projected));
+        const std::vector<vm::plane3>& Lasso::planes() const {
+            return m_planes;
         }
 
-        bool Lasso::selects(const vm::segment3& edge, const vm::plane3& plane, const vm::bbox2& box) const {
-            return selects(edge.center(), plane, box);
+        bool Lasso::selects(const vm::vec3& point, const std::vector<vm::plane3>& planes) const {
+            for (const auto& plane : planes) {
+                if (plane.point_distance(point) > 0.0) {
+                    return false;
+                }
+            }
+            return true;
         }
 
-        bool Lasso::selects(const vm::polygon3& polygon, const vm::plane3& plane, const vm::bbox2& box) const {
-            return selects(polygon.center(), plane, box);
+        bool Lasso::selects(const vm::segment3& edge, const std::vector<vm::plane3>& planes) const {
+            return selects(edge.center(), planes);
         }
 
-        vm::vec3 Lasso::project(const vm::vec3& point, const vm::plane3& plane) const {
-            const auto ray = vm::ray3(m_camera.pickRay(vm::vec3f(point)));
-            const auto hitDistance = vm::intersect_ray_plane(ray, plane);;
-            if (vm::is_nan(hitDistance)) {
-                return vm::vec3::nan();
-            }
-
-            const auto hitPoint = vm::point_at_distance(ray, hitDistance);
-            return m_transform * hitPoint;
+        bool Lasso::selects(const vm::polygon3& polygon, const std::vector<vm::plane3>& planes) const {
+            return selects(polygon.center(), planes);
         }
 
         void Lasso::render(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch) const {
@@ -90,8 +109,45 @@ namespace TrenchBroom {
             renderService.renderFilledPolygon(polygon);
         }
 
-        vm::plane3 Lasso::plane() const {
-            return vm::plane3(vm::vec3(m_camera.defaultPoint(static_cast<float>(m_distance))), vm::vec3(m_camera.direction()));
+        std::vector<vm::plane3> Lasso::computePlanes() const {
+            const auto box = this->box();
+            if (box.min.x() >= box.max.x() || box.min.y() >= box.max.y()) {
+                return std::vector<vm::plane3>();
+            }
+
+            const auto [invertible, inverseTransform] = invert(m_transform);
+            assert(invertible); unused(invertible);
+
+            // the corners of the rectangle in order
+            const vm::vec3 corners[] = {
+                inverseTransform * vm::vec3(box.min.x(), box.min.y(), 0.0),
+                inverseTransform * vm::vec3(box.max.x(), box.min.y(), 0.0),
+                inverseTransform * vm::vec3(box.max.x(), box.max.y(), 0.0),
+                inverseTransform * vm::vec3(box.min.x(), box.max.y(), 0.0)
+            };
+            const auto center = inverseTransform * vm::vec3(box.center().x(), box.center().y(), 0.0);
+
+            // each side plane contains an edge of the rectangle and the pick rays through the edge's end points
+            std::vector<vm::plane3> result;
+            result.reserve(5);
+            for (size_t i = 0; i < 4; ++i) {
+                const auto& start = corners[i];
+                const auto& end = corners[(i + 1) % 4];
+                const auto direction = vm::vec3(m_camera.pickRay(vm::vec3f(start)).direction);
+
+                auto normal = vm::normalize(vm::cross(end - start, direction));
+                if (dot(normal, center - start) > 0.0) {
+                    normal = -normal;
+                }
+                result.push_back(vm::plane3(start, normal));
+            }
+
+            // pick rays start at the camera position in a perspective view, so points behind the camera are not selected
+            if (m_camera.perspectiveProjection()) {
+                result.push_back(vm::plane3(vm::vec3(m_camera.position()), -vm::vec3(m_camera.direction())));
+            }
+
+            return result;
         }
 
         vm::bbox2 Lasso::box() const {
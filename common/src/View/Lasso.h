@@ -25,6 +25,8 @@
 #include <vecmath/plane.h>
 #include <vecmath/bbox.h>
 
+#include <vector>
+
 namespace TrenchBroom {
     namespace Renderer {
         class Camera;
@@ -40,17 +42,38 @@ namespace TrenchBroom {
             const vm::mat4x4 m_transform;
             const vm::vec3 m_start;
             vm::vec3 m_cur;
+            std::vector<vm::plane3> m_planes;
         public:
             Lasso(const Renderer::Camera& camera, FloatType distance, const vm::vec3& point);
 
+            /**
+             * Creates a lasso around the given pick ray that selects every point that is hit by the pick ray when it
+             * is picked as a point handle with the given radius, see Renderer::Camera::pickPointHandle. The lasso may
+             * select some points that are not hit.
+             */
+            static Lasso aroundPickRay(const Renderer::Camera& camera, const vm::ray3& pickRay, FloatType handleRadius);
+
             void update(const vm::vec3& point);
 
+            /**
+             * Returns the planes that bound the volume selected by this lasso, with their normals pointing outward. The
+             * list is empty if this lasso selects nothing.
+             */
+            const std::vector<vm::plane3>& planes() const;
+
+            /**
+             * Appends every handle in the given range that is selected by this lasso to the given output iterator.
+             * The volume that is selected by this lasso is computed whenever the lasso is updated, and each handle is
+             * only tested against its bounding planes.
+             */
             template <typename I, typename O>
             void selected(I cur, I end, O out) const {
-                const vm::plane3 plane = this->plane();
-                const vm::bbox2 box = this->box();
+                if (m_planes.empty()) {
+                    return;
+                }
+
                 while (cur != end) {
-                    if (selects(*cur, plane, box))
+                    if (selects(*cur, m_planes))
                         out = *cur;
                     ++cur;
                 }
@@ -58,17 +81,20 @@ namespace TrenchBroom {
 
             template <typename H>
             bool selects(const H& h) const {
-                return selects(h, plane(), box());
+                return !m_planes.empty() && selects(h, m_planes);
             }
         private:
-            bool selects(const vm::vec3& point, const vm::plane3& plane, const vm::bbox2& box) const;
-            bool selects(const vm::segment3& edge, const vm::plane3& plane, const vm::bbox2& box) const;
-            bool selects(const vm::polygon3& polygon, const vm::plane3& plane, const vm::bbox2& box) const;
-            vm::vec3 project(const vm::vec3& point, const vm::plane3& plane) const;
+            bool selects(const vm::vec3& point, const std::vector<vm::plane3>& planes) const;
+            bool selects(const vm::segment3& edge, const std::vector<vm::plane3>& planes) const;
+            bool selects(const vm::polygon3& polygon, const std::vector<vm::plane3>& planes) const;
         public:
             void render(Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch) const;
         private:
-            vm::plane3 plane() const;
+            /**
+             * Returns the planes that bound the volume of all points whose pick rays hit the lasso rectangle, with their
+             * normals pointing outward. Returns an empty list if the rectangle has no area.
+             */
+            std::vector<vm::plane3> computePlanes() const;
             vm::bbox2 box() const;
         };
     }
@@ -27,6 +27,7 @@
 #include "Assets/Texture.h"
 #include "Assets/TextureManager.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/MapTextSnapshot.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SystemPaths.h"
 #include "Model/AttributeNameWithDoubleQuotationMarksIssueGenerator.h"
@@ -142,6 +143,7 @@ namespace TrenchBroom {
         m_path(DefaultDocumentName),
         m_lastSaveModificationCount(0),
         m_modificationCount(0),
+        m_transactionLevel(0),
         m_currentLayer(nullptr),
         m_currentTextureName(Model::BrushFace::NoTextureName),
         m_lastSelectionBounds(0.0, 32.0),
@@ -310,6 +312,12 @@ namespace TrenchBroom {
             m_game->writeMap(*m_world, path);
         }
 
+        void MapDocument::serializeDocument(IO::MapTextSnapshot& snapshot) {
+            ensure(m_game.get() != nullptr, "game is null");
+            ensure(m_world != nullptr, "world is null");
+            m_game->serializeMap(*m_world, snapshot);
+        }
+
         void MapDocument::exportDocumentAs(const Model::ExportFormat format, const IO::Path& path) {
             m_game->exportMap(*m_world, format, path);
         }
@@ -563,11 +571,44 @@ namespace TrenchBroom {
             select(visitor.nodes());
         }
 
+        /**
+         * Finds the entities and brushes whose bounds intersect the bounds of any of the given brushes. Only these can
+         * touch or be contained in any of the given brushes.
+         */
+        static Model::NodeSet findCandidates(const Model::World& world, const Model::BrushList& brushes) {
+            Model::NodeList candidates;
+            for (const auto* brush : brushes) {
+                world.findNodesIntersecting(brush->logicalBounds(), candidates);
+            }
+            return Model::NodeSet(std::begin(candidates), std::end(candidates));
+        }
+
+        /**
+         * Like Node::acceptAndRecurse, but skips the childless nodes that are not among the given candidates. Nodes
+         * with children are always visited because groups are not part of the world's node tree.
+         */
+        template <typename V>
+        static void acceptAndRecurseCandidates(Model::Node* node, const Model::NodeSet& candidates, V& visitor) {
+            node->accept(visitor);
+            if (visitor.recursionStopped() || visitor.cancelled()) {
+                return;
+            }
+
+            for (auto* child : node->children()) {
+                if (visitor.cancelled()) {
+                    break;
+                }
+                if (child->hasChildren() || candidates.count(child) > 0) {
+                    acceptAndRecurseCandidates(child, candidates, visitor);
+                }
+            }
+        }
+
         void MapDocument::selectTouching(const bool del) {
             const Model::BrushList& brushes = m_selectedNodes.brushes();
 
             Model::CollectTouchingNodesVisitor<Model::BrushList::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
+            acceptAndRecurseCandidates(m_world.get(), findCandidates(*m_world, brushes), visitor);
 
             const Model::NodeList nodes = visitor.nodes();
 
@@ -583,7 +624,7 @@ namespace TrenchBroom {
             const Model::BrushList& brushes = m_selectedNodes.brushes();
 
             Model::CollectContainedNodesVisitor<Model::BrushList::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
+            acceptAndRecurseCandidates(m_world.get(), findCandidates(*m_world, brushes), visitor);
 
             const Model::NodeList nodes = visitor.nodes();
 
@@ -1170,8 +1211,10 @@ namespace TrenchBroom {
                 toRemove.push_back(subtrahend);
             }
 
-            for (auto* minuend : minuends) {
-                const Model::BrushList result = minuend->subtract(*m_world, m_worldBounds, currentTextureName(), subtrahends);
+            const auto results = Model::Brush::subtract(*m_world, m_worldBounds, currentTextureName(), minuends, subtrahends);
+            for (size_t i = 0; i < minuends.size(); ++i) {
+                auto* minuend = minuends[i];
+                const Model::BrushList& result = results[i];
 
                 if (!result.empty()) {
                     VectorUtils::append(toAdd[minuend->parent()], result);
@@ -1506,6 +1549,9 @@ namespace TrenchBroom {
 
         void MapDocument::beginTransaction(const String& name) {
             debug("Starting transaction '" + name + "'");
+            if (m_transactionLevel++ == 0) {
+                outermostTransactionWillBegin();
+            }
             doBeginTransaction(name);
         }
 
@@ -1517,12 +1563,34 @@ namespace TrenchBroom {
         void MapDocument::commitTransaction() {
             debug("Committing transaction");
             doEndTransaction();
+            assert(m_transactionLevel > 0);
+            if (--m_transactionLevel == 0) {
+                outermostTransactionDidEnd();
+            }
         }
 
         void MapDocument::cancelTransaction() {
             debug("Cancelling transaction");
             doRollbackTransaction();
             doEndTransaction();
+            assert(m_transactionLevel > 0);
+            if (--m_transactionLevel == 0) {
+                outermostTransactionDidEnd();
+            }
+        }
+
+        void MapDocument::outermostTransactionWillBegin() {
+            if (m_world != nullptr) {
+                m_world->deferNodeTreeUpdates();
+            }
+            transactionWillBeginNotifier();
+        }
+
+        void MapDocument::outermostTransactionDidEnd() {
+            if (m_world != nullptr) {
+                m_world->resumeNodeTreeUpdates();
+            }
+            transactionDidEndNotifier();
         }
 
         bool MapDocument::submit(Command::Ptr command) {
@@ -1542,6 +1610,12 @@ namespace TrenchBroom {
                 m_world->pick(pickRay, pickResult);
         }
 
+        void MapDocument::pick(const std::vector<vm::ray3>& pickRays, std::vector<Model::PickResult>& pickResults) const {
+            if (m_world != nullptr) {
+                m_world->pickRays(pickRays, pickResults);
+            }
+        }
+
         Model::NodeList MapDocument::findNodesContaining(const vm::vec3& point) const {
             Model::NodeList result;
             if (m_world != nullptr) {
@@ -1550,6 +1624,14 @@ namespace TrenchBroom {
             return result;
         }
 
+        Model::NodeList MapDocument::findNodesIntersecting(const std::vector<vm::plane3>& planes) const {
+            Model::NodeList result;
+            if (m_world != nullptr) {
+                m_world->findNodesIntersecting(planes, result);
+            }
+            return result;
+        }
+
         void MapDocument::createWorld(const Model::MapFormat mapFormat, const vm::bbox3& worldBounds, Model::GameSPtr game) {
             m_worldBounds = worldBounds;
             m_game = game;
@@ -52,6 +52,10 @@ namespace TrenchBroom {
         class TextureManager;
     }
 
+    namespace IO {
+        class MapTextSnapshot;
+    }
+
     namespace Model {
         class BrushFaceAttributes;
         class ChangeBrushFaceAttributesRequest;
@@ -103,6 +107,7 @@ namespace TrenchBroom {
             IO::Path m_path;
             size_t m_lastSaveModificationCount;
             size_t m_modificationCount;
+            size_t m_transactionLevel;
 
             Model::NodeCollection m_partiallySelectedNodes;
             Model::NodeCollection m_selectedNodes;
@@ -125,6 +130,13 @@ namespace TrenchBroom {
             Notifier<const String&> transactionDoneNotifier;
             Notifier<const String&> transactionUndoneNotifier;
 
+            /**
+             * Notified when the outermost transaction begins and ends, respectively. Observers can use these to
+             * collect expensive updates while the transaction is running and to apply them once when it ends.
+             */
+            Notifier<> transactionWillBeginNotifier;
+            Notifier<> transactionDidEndNotifier;
+
             Notifier<MapDocument*> documentWillBeClearedNotifier;
             Notifier<MapDocument*> documentWasClearedNotifier;
             Notifier<MapDocument*> documentWasNewedNotifier;
@@ -211,6 +223,7 @@ namespace TrenchBroom {
             void saveDocument();
             void saveDocumentAs(const IO::Path& path);
             void saveDocumentTo(const IO::Path& path);
+            void serializeDocument(IO::MapTextSnapshot& snapshot);
             void exportDocumentAs(Model::ExportFormat format, const IO::Path& path);
         private:
             void doSaveDocument(const IO::Path& path);
@@ -395,6 +408,9 @@ namespace TrenchBroom {
             void commitTransaction();
             void cancelTransaction();
         private:
+            void outermostTransactionWillBegin();
+            void outermostTransactionDidEnd();
+
             bool submit(Command::Ptr command);
             bool submitAndStore(UndoableCommand::Ptr command);
         private: // subclassing interface for command processing
@@ -418,7 +434,19 @@ namespace TrenchBroom {
             void commitPendingAssets();
         public: // picking
             void pick(const vm::ray3& pickRay, Model::PickResult& pickResult) const;
+
+            /**
+             * Picks many rays at once, see Model::World::pickRays. The given pick results must contain one pick result
+             * per ray.
+             */
+            void pick(const std::vector<vm::ray3>& pickRays, std::vector<Model::PickResult>& pickResults) const;
             Model::NodeList findNodesContaining(const vm::vec3& point) const;
+
+            /**
+             * Returns the entities and brushes that might intersect the convex volume bounded by the given planes, see
+             * Model::World::findNodesIntersecting.
+             */
+            Model::NodeList findNodesIntersecting(const std::vector<vm::plane3>& planes) const;
         private: // world management
             void createWorld(Model::MapFormat mapFormat, const vm::bbox3& worldBounds, Model::GameSPtr game);
             void loadWorld(Model::MapFormat mapFormat, const vm::bbox3& worldBounds, Model::GameSPtr game, const IO::Path& path);
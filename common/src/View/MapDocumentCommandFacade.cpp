@@ -20,10 +20,13 @@
 #include "MapDocumentCommandFacade.h"
 
 #include "CollectionUtils.h"
+#include "ParallelUtils.h"
 #include "Preferences.h"
 #include "PreferenceManager.h"
+#include "StringUtils.h"
 #include "Assets/EntityDefinitionFileSpec.h"
 #include "Assets/TextureManager.h"
+#include "Model/AssortNodesVisitor.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
@@ -43,17 +46,29 @@
 #include "Model/NodeVisitor.h"
 #include "View/Selection.h"
 
+#include <atomic>
+
 namespace TrenchBroom {
     namespace View {
         MapDocumentSPtr MapDocumentCommandFacade::newMapDocument() {
             return MapDocumentSPtr(new MapDocumentCommandFacade());
         }
 
+        static size_t undoMemoryBudget() {
+            const auto megabytes = pref(Preferences::UndoMemoryBudget);
+            return megabytes > 0 ? static_cast<size_t>(megabytes) * 1024u * 1024u : 0u;
+        }
+
         MapDocumentCommandFacade::MapDocumentCommandFacade() :
         m_commandProcessor(this) {
+            m_commandProcessor.setMemoryBudget(undoMemoryBudget());
             bindObservers();
         }
 
+        MapDocumentCommandFacade::~MapDocumentCommandFacade() {
+            unbindObservers();
+        }
+
         void MapDocumentCommandFacade::performSelect(const Model::NodeList& nodes) {
             selectionWillChangeNotifier();
             updateLastSelectionBounds();
@@ -448,32 +463,21 @@ namespace TrenchBroom {
             groupWasClosedNotifier(previousGroup);
         }
 
-        class CanTransformVisitor : public Model::ConstNodeVisitor, public Model::NodeQuery<bool> {
-        private:
-            vm::mat4x4 m_transform;
-            vm::bbox3 m_worldBounds;
-        public:
-            CanTransformVisitor(const vm::mat4x4& transform, const vm::bbox3& worldBounds) :
-                m_transform(transform),
-                m_worldBounds(worldBounds) {}
-        private:
-            void doVisit(const Model::World* world) override { setResult(true); }
-            void doVisit(const Model::Layer* layer) override { setResult(true); }
-            void doVisit(const Model::Group* group) override { setResult(true); }
-            void doVisit(const Model::Entity* entity) override { setResult(true); }
-            void doVisit(const Model::Brush* brush) override { setResult(brush->canTransform(m_transform, m_worldBounds)); }
-            bool doCombineResults(bool oldResult, bool newResult) const override {
-                return newResult && oldResult;
-            }
-        };
-
         bool MapDocumentCommandFacade::performTransform(const vm::mat4x4 &transform, const bool lockTextures) {
           // Test whether all brushes can be transformed; abort if any fail.
-          CanTransformVisitor canTransform(transform, m_worldBounds);
-          for (const auto* node : m_selectedNodes.nodes()) {
-              node->acceptAndRecurse(canTransform);
+          Model::CollectBrushesVisitor collectBrushes;
+          for (auto* node : m_selectedNodes.nodes()) {
+              node->acceptAndRecurse(collectBrushes);
           }
-          if (canTransform.hasResult() && !canTransform.result()) {
+
+          const Model::BrushList& brushes = collectBrushes.brushes();
+          std::atomic<bool> canTransform(true);
+          ParallelUtils::parallelFor(brushes.size(), [&](const size_t i) {
+              if (canTransform && !brushes[i]->canTransform(transform, m_worldBounds)) {
+                  canTransform = false;
+              }
+          }, 16);
+          if (!canTransform) {
               return false;
           }
 
@@ -489,6 +493,7 @@ namespace TrenchBroom {
           Model::TransformObjectVisitor visitor(transform, lockTextures,
                                                 m_worldBounds);
           Model::Node::accept(std::begin(nodes), std::end(nodes), visitor);
+          visitor.transformBrushes();
 
           invalidateSelectionBounds();
           return true;
@@ -972,6 +977,14 @@ namespace TrenchBroom {
             m_commandProcessor.transactionUndoneNotifier.addObserver(transactionUndoneNotifier);
             documentWasNewedNotifier.addObserver(this, &MapDocumentCommandFacade::documentWasNewed);
             documentWasLoadedNotifier.addObserver(this, &MapDocumentCommandFacade::documentWasLoaded);
+
+            PreferenceManager& prefs = PreferenceManager::instance();
+            prefs.preferenceDidChangeNotifier.addObserver(this, &MapDocumentCommandFacade::preferenceDidChange);
+        }
+
+        void MapDocumentCommandFacade::unbindObservers() {
+            PreferenceManager& prefs = PreferenceManager::instance();
+            prefs.preferenceDidChangeNotifier.removeObserver(this, &MapDocumentCommandFacade::preferenceDidChange);
         }
 
         void MapDocumentCommandFacade::documentWasNewed(MapDocument* document) {
@@ -982,6 +995,12 @@ namespace TrenchBroom {
             m_commandProcessor.clear();
         }
 
+        void MapDocumentCommandFacade::preferenceDidChange(const IO::Path& path) {
+            if (path == Preferences::UndoMemoryBudget.path()) {
+                m_commandProcessor.setMemoryBudget(undoMemoryBudget());
+            }
+        }
+
         bool MapDocumentCommandFacade::doCanUndoLastCommand() const {
             return m_commandProcessor.hasLastCommand();
         }
@@ -45,6 +45,8 @@ namespace TrenchBroom {
             static MapDocumentSPtr newMapDocument();
         private:
             MapDocumentCommandFacade();
+        public:
+            ~MapDocumentCommandFacade() override;
         public: // selection modification
             void performSelect(const Model::NodeList& nodes);
             void performSelect(const Model::BrushFaceList& faces);
@@ -122,8 +124,10 @@ namespace TrenchBroom {
             void decModificationCount(size_t delta = 1);
         private: // notification
             void bindObservers();
+            void unbindObservers();
             void documentWasNewed(MapDocument* document);
             void documentWasLoaded(MapDocument* document);
+            void preferenceDidChange(const IO::Path& path);
         private: // implement MapDocument interface
             bool doCanUndoLastCommand() const override;
             bool doCanRedoNextCommand() const override;
@@ -22,6 +22,7 @@
 #include "TrenchBroomApp.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Assets/Texture.h"
 #include "Renderer/Vbo.h"
 #include "Renderer/Transformation.h"
 #include "Renderer/VertexArray.h"
@@ -207,10 +208,17 @@ namespace TrenchBroom {
         }
 
         void RenderView::render() {
+            const auto finishedDecodes = Assets::Texture::finishedDecodeCount();
+
             processInput();
             clearBackground();
             doRender();
             renderFocusIndicator();
+
+            // render again so that textures decoded in the background replace their placeholders
+            if (Assets::Texture::pendingDecodeCount() > 0 || Assets::Texture::finishedDecodeCount() != finishedDecodes) {
+                update();
+            }
         }
 
         void RenderView::processInput() {
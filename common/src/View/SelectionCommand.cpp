@@ -20,6 +20,7 @@
 #include "SelectionCommand.h"
 
 #include "Macros.h"
+#include "StringUtils.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/Entity.h"
@@ -166,5 +167,12 @@ namespace TrenchBroom {
         bool SelectionCommand::doCollateWith(UndoableCommand::Ptr command) {
             return false;
         }
+
+        size_t SelectionCommand::doGetMemorySize() const {
+            // face references are stored in list nodes with two additional pointers each
+            const auto faceRefCount = m_faceRefs.size() + m_previouslySelectedFaceRefs.size();
+            return ((m_nodes.capacity() + m_previouslySelectedNodes.capacity()) * sizeof(Model::Node*) +
+                    faceRefCount * (sizeof(Model::BrushFaceReference) + 2u * sizeof(void*)));
+        }
     }
 }
@@ -26,7 +26,8 @@ namespace TrenchBroom {
     namespace View {
         SnapshotCommand::SnapshotCommand(Command::CommandType type, const String &name) :
         DocumentCommand(type, name),
-        m_snapshot(nullptr) {}
+        m_snapshot(nullptr),
+        m_snapshotSize(0) {}
 
         SnapshotCommand::~SnapshotCommand() {
             if (m_snapshot != nullptr) {
@@ -48,9 +49,27 @@ namespace TrenchBroom {
             return restoreSnapshot(document);
         }
 
+        void SnapshotCommand::doPrepareCompaction() {
+            if (m_snapshot != nullptr) {
+                m_snapshot->prepareCompaction();
+            }
+        }
+
+        void SnapshotCommand::doCompact() {
+            if (m_snapshot != nullptr) {
+                m_snapshot->compact();
+                m_snapshotSize = m_snapshot->memorySize();
+            }
+        }
+
+        size_t SnapshotCommand::doGetMemorySize() const {
+            return m_snapshotSize;
+        }
+
         void SnapshotCommand::takeSnapshot(MapDocumentCommandFacade *document) {
             assert(m_snapshot == nullptr);
             m_snapshot = doTakeSnapshot(document);
+            m_snapshotSize = m_snapshot != nullptr ? m_snapshot->memorySize() : 0;
         }
 
         bool SnapshotCommand::restoreSnapshot(MapDocumentCommandFacade *document) {
@@ -64,6 +83,7 @@ namespace TrenchBroom {
             assert(m_snapshot != nullptr);
             delete m_snapshot;
             m_snapshot = nullptr;
+            m_snapshotSize = 0;
         }
 
         Model::Snapshot *SnapshotCommand::doTakeSnapshot(MapDocumentCommandFacade *document) const {
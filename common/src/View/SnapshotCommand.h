@@ -31,6 +31,7 @@ namespace TrenchBroom {
         class SnapshotCommand : public DocumentCommand {
         private:
             Model::Snapshot* m_snapshot;
+            size_t m_snapshotSize;
         protected:
             SnapshotCommand(CommandType type, const String& name);
             virtual ~SnapshotCommand() override;
@@ -38,6 +39,10 @@ namespace TrenchBroom {
             bool performDo(MapDocumentCommandFacade* document) override;
             bool doPerformUndo(MapDocumentCommandFacade* document) override;
         private:
+            void doPrepareCompaction() override;
+            void doCompact() override;
+            size_t doGetMemorySize() const override;
+
             void takeSnapshot(MapDocumentCommandFacade* document);
             bool restoreSnapshot(MapDocumentCommandFacade* document);
             void deleteSnapshot();
@@ -24,7 +24,9 @@
 namespace TrenchBroom {
     namespace View {
         UndoableCommand::UndoableCommand(const CommandType type, const String& name) :
-        Command(type, name) {}
+        Command(type, name),
+        m_compactionPrepared(false),
+        m_compacted(false) {}
 
         UndoableCommand::~UndoableCommand() {}
 
@@ -32,6 +34,8 @@ namespace TrenchBroom {
             m_state = CommandState_Undoing;
             if (doPerformUndo(document)) {
                 m_state = CommandState_Default;
+                m_compactionPrepared = false;
+                m_compacted = false;
                 return true;
             } else {
                 m_state = CommandState_Done;
@@ -55,13 +59,44 @@ namespace TrenchBroom {
             assert(command.get() != this);
             if (command->type() != m_type)
                 return false;
-            return doCollateWith(command);
+            // the undo information of a compacted command depends on the state that the command left the document in
+            if (m_compacted)
+                return false;
+            if (!doCollateWith(command))
+                return false;
+            // the collated command has changed the state that the undo information was compared against
+            m_compactionPrepared = false;
+            return true;
+        }
+
+        void UndoableCommand::prepareCompaction() {
+            doPrepareCompaction();
+            m_compactionPrepared = true;
+        }
+
+        void UndoableCommand::compact() {
+            if (m_compactionPrepared) {
+                doCompact();
+                m_compactionPrepared = false;
+                m_compacted = true;
+            }
+        }
+
+        size_t UndoableCommand::memorySize() const {
+            return doGetMemorySize();
         }
 
         bool UndoableCommand::doIsRepeatDelimiter() const {
             return false;
         }
 
+        void UndoableCommand::doPrepareCompaction() {}
+        void UndoableCommand::doCompact() {}
+
+        size_t UndoableCommand::doGetMemorySize() const {
+            return 0;
+        }
+
         UndoableCommand::Ptr UndoableCommand::doRepeat(MapDocumentCommandFacade* document) const {
             throw CommandProcessorException("Command is not repeatable");
         }
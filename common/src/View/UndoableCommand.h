@@ -29,6 +29,9 @@ namespace TrenchBroom {
         class UndoableCommand : public Command {
         public:
             using Ptr = std::shared_ptr<UndoableCommand>;
+        private:
+            bool m_compactionPrepared;
+            bool m_compacted;
         public:
             UndoableCommand(CommandType type, const String& name);
             virtual ~UndoableCommand();
@@ -40,6 +43,26 @@ namespace TrenchBroom {
             UndoableCommand::Ptr repeat(MapDocumentCommandFacade* document) const;
 
             virtual bool collateWith(UndoableCommand::Ptr command);
+
+            /**
+             * Determines which parts of the undo information of this command can be discarded by compact(). This
+             * must only be called while the document is in the state in which this command has left it, i.e.,
+             * before another command is performed.
+             */
+            void prepareCompaction();
+
+            /**
+             * Reduces the memory that this command needs to undo itself, using the information gathered by the last
+             * call to prepareCompaction(). Does nothing if this command was not prepared or if it was undone or
+             * collated with another command since then. Once compacted, a command will not collate with other
+             * commands anymore.
+             */
+            void compact();
+
+            /**
+             * Returns an estimate of the number of bytes that this command needs to undo itself.
+             */
+            size_t memorySize() const;
         private:
             virtual bool doPerformUndo(MapDocumentCommandFacade* document) = 0;
 
@@ -48,6 +71,9 @@ namespace TrenchBroom {
             virtual UndoableCommand::Ptr doRepeat(MapDocumentCommandFacade* document) const;
 
             virtual bool doCollateWith(UndoableCommand::Ptr command) = 0;
+            virtual void doPrepareCompaction();
+            virtual void doCompact();
+            virtual size_t doGetMemorySize() const;
         public: // this method is just a service for DocumentCommand and should never be called from anywhere else
             virtual size_t documentModificationCount() const;
         private:
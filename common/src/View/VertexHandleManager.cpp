@@ -38,13 +38,14 @@ namespace TrenchBroom {
 
         void VertexHandleManager::pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
             for (const auto& entry : m_handles) {
-                const auto& position = entry.first;
-                const auto distance = camera.pickPointHandle(pickRay, position, pref(Preferences::HandleRadius));
-                if (!vm::is_nan(distance)) {
-                    const auto hitPoint = vm::point_at_distance(pickRay, distance);
-                    const auto error = vm::squared_distance(pickRay, position).distance;
-                    pickResult.addHit(Model::Hit::hit(HandleHit, distance, hitPoint, position, error));
-                }
+                pickHandle(entry.first, pickRay, camera, pickResult);
+            }
+        }
+
+        void VertexHandleManager::pick(const HandleList& handles, const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
+            for (const auto& position : handles) {
+                assert(contains(position));
+                pickHandle(position, pickRay, camera, pickResult);
             }
         }
 
@@ -64,6 +65,21 @@ namespace TrenchBroom {
             return HandleHit;
         }
 
+        void VertexHandleManager::appendHandles(const Model::Brush* brush, HandleList& result) const {
+            for (const Model::BrushVertex* vertex : brush->vertices()) {
+                result.push_back(vertex->position());
+            }
+        }
+
+        void VertexHandleManager::pickHandle(const vm::vec3& position, const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const {
+            const auto distance = camera.pickPointHandle(pickRay, position, pref(Preferences::HandleRadius));
+            if (!vm::is_nan(distance)) {
+                const auto hitPoint = vm::point_at_distance(pickRay, distance);
+                const auto error = vm::squared_distance(pickRay, position).distance;
+                pickResult.addHit(Model::Hit::hit(HandleHit, distance, hitPoint, position, error));
+            }
+        }
+
         bool VertexHandleManager::isIncident(const Handle& handle, const Model::Brush* brush) const {
             return brush->hasVertex(handle);
         }
@@ -114,6 +130,12 @@ namespace TrenchBroom {
             return HandleHit;
         }
 
+        void EdgeHandleManager::appendHandles(const Model::Brush* brush, HandleList& result) const {
+            for (const Model::BrushEdge* edge : brush->edges()) {
+                result.push_back(vm::segment3(edge->firstVertex()->position(), edge->secondVertex()->position()));
+            }
+        }
+
         bool EdgeHandleManager::isIncident(const Handle& handle, const Model::Brush* brush) const {
             return brush->hasEdge(handle);
         }
@@ -171,6 +193,12 @@ namespace TrenchBroom {
             return HandleHit;
         }
 
+        void FaceHandleManager::appendHandles(const Model::Brush* brush, HandleList& result) const {
+            for (const Model::BrushFace* face : brush->faces()) {
+                result.push_back(face->polygon());
+            }
+        }
+
         bool FaceHandleManager::isIncident(const Handle& handle, const Model::Brush* brush) const {
             return brush->hasFace(handle);
         }
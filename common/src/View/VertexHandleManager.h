@@ -441,6 +441,37 @@ namespace TrenchBroom {
                     --m_selectedHandleCount;
                 }
             }
+        public:
+            /**
+             * Returns the handles of the given range of brushes which are contained in this manager, without
+             * duplicates.
+             *
+             * @tparam I the type of the range iterators
+             * @param cur the beginning of the range of brushes
+             * @param end the end of the range of brushes
+             * @return a sorted list of the handles of the given brushes
+             */
+            template <typename I>
+            HandleList findHandles(I cur, I end) const {
+                HandleList result;
+                while (cur != end) {
+                    appendHandles(*cur++, result);
+                }
+
+                VectorUtils::sortAndRemoveDuplicates(result);
+                result.erase(std::remove_if(std::begin(result), std::end(result), [this](const Handle& handle) {
+                    return !contains(handle);
+                }), std::end(result));
+                return result;
+            }
+        protected:
+            /**
+             * Appends the handles of the given brush to the given list.
+             *
+             * @param brush the brush
+             * @param result the list to append to
+             */
+            virtual void appendHandles(const Model::Brush* brush, HandleList& result) const = 0;
         public:
             /**
              * Applies the given picking test to all handles in this manager and adds all hits to the given picking
@@ -540,12 +571,26 @@ namespace TrenchBroom {
              * @param pickResult the picking result to add the hits to
              */
             void pick(const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
+
+            /**
+             * Picks the given vertex handles, which must be contained in this manager, and adds the hits to the given
+             * picking result. This is much faster than picking all handles if the handles that might be hit are known,
+             * e.g. because only the handles of some brushes can be hit.
+             *
+             * @param handles the handles to pick
+             * @param pickRay the picking ray
+             * @param camera the camera
+             * @param pickResult the picking result to add the hits to
+             */
+            void pick(const HandleList& handles, const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
         public:
             void addHandles(const Model::Brush* brush) override;
             void removeHandles(const Model::Brush* brush) override;
 
             Model::Hit::HitType hitType() const override;
         private:
+            void appendHandles(const Model::Brush* brush, HandleList& result) const override;
+            void pickHandle(const vm::vec3& position, const vm::ray3& pickRay, const Renderer::Camera& camera, Model::PickResult& pickResult) const;
             bool isIncident(const Handle& handle, const Model::Brush* brush) const override;
         };
 
@@ -591,6 +636,7 @@ namespace TrenchBroom {
 
             Model::Hit::HitType hitType() const override;
         private:
+            void appendHandles(const Model::Brush* brush, HandleList& result) const override;
             bool isIncident(const Handle& handle, const Model::Brush* brush) const override;
         };
 
@@ -637,6 +683,7 @@ namespace TrenchBroom {
 
             Model::Hit::HitType hitType() const override;
         private:
+            void appendHandles(const Model::Brush* brush, HandleList& result) const override;
             bool isIncident(const Handle& handle, const Model::Brush* brush) const override;
         };
     }
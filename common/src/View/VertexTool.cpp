@@ -22,9 +22,11 @@
 #include "Macros.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "StringUtils.h"
 #include "Model/Brush.h"
 #include "Renderer/RenderBatch.h"
 #include "View/Grid.h"
+#include "View/Lasso.h"
 #include "View/MapDocument.h"
 #include "View/VertexCommand.h"
 
@@ -54,7 +56,16 @@ namespace TrenchBroom {
             MapDocumentSPtr document = lock(m_document);
             const Grid& grid = document->grid();
 
-            m_vertexHandles.pick(pickRay, camera, pickResult);
+            // only the vertices of the brushes which intersect a small volume around the pick ray can be hit
+            const Lasso lasso = Lasso::aroundPickRay(camera, pickRay, pref(Preferences::HandleRadius));
+            if (lasso.planes().empty()) {
+                m_vertexHandles.pick(pickRay, camera, pickResult);
+            } else {
+                const Model::BrushList brushes = findSelectedBrushesIntersecting(lasso.planes());
+                const VertexHandleManager::HandleList handles = m_vertexHandles.findHandles(std::begin(brushes), std::end(brushes));
+                m_vertexHandles.pick(handles, pickRay, camera, pickResult);
+            }
+
             m_edgeHandles.pickGridHandle(pickRay, camera, grid, pickResult);
             m_faceHandles.pickGridHandle(pickRay, camera, grid, pickResult);
         }
@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include <vecmath/vec.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include "AABBTree.h"
 
@@ -27,9 +28,12 @@ using AABB = AABBTree<double, 3, size_t>;
 using BOX = AABB::Box;
 using RAY = vm::ray<AABB::FloatType, AABB::Components>;
 using VEC = vm::vec<AABB::FloatType, AABB::Components>;
+using PLANE = vm::plane<AABB::FloatType, AABB::Components>;
 
 void assertTree(const std::string& exp, const AABB& actual);
 void assertIntersectors(const AABB& tree, const RAY& ray, std::initializer_list<AABB::DataType> items);
+void assertIntersectors(const AABB& tree, const std::vector<PLANE>& planes, std::initializer_list<AABB::DataType> items);
+void assertIntersectors(const AABB& tree, const BOX& box, std::initializer_list<AABB::DataType> items);
 void assertTreeContains(const AABB& tree, const BOX& box, AABB::DataType data);
 void assertTreeDoesNotContain(const AABB& tree, const BOX& box, AABB::DataType data);
 
@@ -483,6 +487,282 @@ TEST(AABBTreeTest, findIntersectorsFromInsideRootBBox) {
     assertIntersectors(tree, RAY(VEC(0.0,  0.0,  0.0), VEC::pos_x()), { 2u });
 }
 
+TEST(AABBTreeTest, findIntersectorsAfterUpdate) {
+    AABB tree;
+    tree.insert(BOX(VEC(-2.0, -1.0, -1.0), VEC(-1.0, +1.0, +1.0)), 1u);
+    tree.insert(BOX(VEC(+1.0, -1.0, -1.0), VEC(+2.0, +1.0, +1.0)), 2u);
+
+    assertIntersectors(tree, RAY(VEC(0.0, 0.0, 0.0), VEC::pos_x()), { 2u });
+
+    tree.update(BOX(VEC(+3.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 1u);
+    assertIntersectors(tree, RAY(VEC(0.0, 0.0, 0.0), VEC::pos_x()), { 1u, 2u });
+    assertIntersectors(tree, RAY(VEC(0.0, 0.0, 0.0), VEC::neg_x()), {});
+
+    tree.remove(2u);
+    assertIntersectors(tree, RAY(VEC(0.0, 0.0, 0.0), VEC::pos_x()), { 1u });
+
+    tree.clear();
+    assertIntersectors(tree, RAY(VEC(0.0, 0.0, 0.0), VEC::pos_x()), {});
+}
+
+TEST(AABBTreeTest, clearAndBuild) {
+    std::vector<BOX> boxes;
+    std::vector<size_t> data;
+    for (size_t i = 0; i < 64; ++i) {
+        const auto x = static_cast<double>(i % 4) * 3.0;
+        const auto y = static_cast<double>((i / 4) % 4) * 3.0;
+        const auto z = static_cast<double>(i / 16) * 3.0;
+        boxes.push_back(BOX(VEC(x, y, z), VEC(x + 1.0, y + 1.0, z + 1.0)));
+        data.push_back(i);
+    }
+
+    AABB tree;
+    tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(1.0, 1.0, 1.0)), 100u);
+    tree.clearAndBuild(data, [&](const size_t i) { return boxes[i]; });
+
+    ASSERT_FALSE(tree.contains(100u));
+    ASSERT_EQ(BOX(VEC(0.0, 0.0, 0.0), VEC(10.0, 10.0, 10.0)), tree.bounds());
+    ASSERT_EQ(7u, tree.height());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        assertTreeContains(tree, boxes[i], i);
+    }
+
+    assertIntersectors(tree, RAY(VEC(-1.0, 0.5, 0.5), VEC::pos_x()), { 0u, 1u, 2u, 3u });
+    assertIntersectors(tree, RAY(VEC(9.5, 9.5, 11.0), VEC::neg_z()), { 15u, 31u, 47u, 63u });
+
+    ASSERT_TRUE(tree.remove(0u));
+    assertTreeDoesNotContain(tree, boxes[0], 0u);
+    assertTreeContains(tree, boxes[1], 1u);
+}
+
+TEST(AABBTreeTest, clearAndBuildWithIdenticalBounds) {
+    const BOX bounds(VEC(0.0, 0.0, 0.0), VEC(1.0, 1.0, 1.0));
+    const std::vector<size_t> data({ 1u, 2u, 3u, 4u, 5u });
+
+    AABB tree;
+    tree.clearAndBuild(data, [&](const size_t) { return bounds; });
+
+    ASSERT_EQ(4u, tree.height());
+    assertIntersectors(tree, RAY(VEC(-1.0, 0.5, 0.5), VEC::pos_x()), { 1u, 2u, 3u, 4u, 5u });
+}
+
+TEST(AABBTreeTest, clearAndBuildWithDuplicateData) {
+    const BOX bounds(VEC(0.0, 0.0, 0.0), VEC(1.0, 1.0, 1.0));
+    const std::vector<size_t> data({ 1u, 2u, 1u });
+
+    AABB tree;
+    ASSERT_THROW(tree.clearAndBuild(data, [&](const size_t) { return bounds; }), NodeTreeException);
+    ASSERT_TRUE(tree.empty());
+    ASSERT_FALSE(tree.contains(1u));
+}
+
+TEST(AABBTreeTest, clearAndBuildLargeTree) {
+    // large enough for subtrees to be built on the worker pool
+    std::vector<BOX> boxes;
+    std::vector<size_t> data;
+    for (size_t i = 0; i < 20000; ++i) {
+        const auto x = static_cast<double>(i % 100) * 2.0;
+        const auto y = static_cast<double>((i / 100) % 100) * 2.0;
+        const auto z = static_cast<double>(i / 10000) * 2.0;
+        boxes.push_back(BOX(VEC(x, y, z), VEC(x + 1.0, y + 1.0, z + 1.0)));
+        data.push_back(i);
+    }
+
+    AABB tree;
+    tree.clearAndBuild(data, [&](const size_t i) { return boxes[i]; });
+
+    ASSERT_EQ(BOX(VEC(0.0, 0.0, 0.0), VEC(199.0, 199.0, 3.0)), tree.bounds());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        ASSERT_EQ(AABB::List({ i }), tree.findContainers(boxes[i].center()));
+    }
+}
+
+TEST(AABBTreeTest, findIntersectorsOfRays) {
+    std::vector<BOX> boxes;
+    std::vector<size_t> data;
+    for (size_t i = 0; i < 64; ++i) {
+        const auto x = static_cast<double>(i % 4) * 3.0;
+        const auto y = static_cast<double>((i / 4) % 4) * 3.0;
+        const auto z = static_cast<double>(i / 16) * 3.0;
+        boxes.push_back(BOX(VEC(x, y, z), VEC(x + 1.0, y + 1.0, z + 1.0)));
+        data.push_back(i);
+    }
+
+    AABB tree;
+    tree.clearAndBuild(data, [&](const size_t i) { return boxes[i]; });
+
+    const std::vector<RAY> rays({
+        RAY(VEC(-1.0, 0.5, 0.5), VEC::pos_x()),
+        RAY(VEC(9.5, 9.5, 11.0), VEC::neg_z()),
+        RAY(VEC(-1.0, 0.5, 0.5), VEC::neg_x()),
+        RAY(VEC(0.5, 0.5, 0.5), VEC::pos_y()),
+        RAY(VEC(-1.0, -1.0, -1.0), vm::normalize(VEC(1.0, 1.0, 1.0)))
+    });
+
+    std::vector<std::vector<AABB::DataType>> actual(rays.size());
+    tree.findIntersectors(rays, [&](const size_t rayIndex, const AABB::DataType item) {
+        actual[rayIndex].push_back(item);
+    });
+
+    // every ray must find the same items in the same order as when it is tested on its own
+    for (size_t i = 0; i < rays.size(); ++i) {
+        std::vector<AABB::DataType> expected;
+        tree.findIntersectors(rays[i], std::back_inserter(expected));
+        ASSERT_EQ(expected, actual[i]);
+    }
+
+    ASSERT_EQ(4u, actual[0].size());
+    ASSERT_EQ(4u, actual[1].size());
+    ASSERT_TRUE(actual[2].empty());
+    ASSERT_EQ((std::set<AABB::DataType>{ 0u, 4u, 8u, 12u }), std::set<AABB::DataType>(std::begin(actual[3]), std::end(actual[3])));
+    ASSERT_EQ(4u, actual[4].size());
+}
+
+TEST(AABBTreeTest, findIntersectorsOfConvexVolume) {
+    AABB tree;
+    assertIntersectors(tree, std::vector<PLANE>{ PLANE(VEC::zero(), VEC::pos_x()) }, {});
+
+    tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
+    tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), 2u);
+    tree.insert(BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 3u);
+
+    assertIntersectors(tree, std::vector<PLANE>{}, { 1u, 2u, 3u });
+    assertIntersectors(tree, std::vector<PLANE>{ PLANE(VEC(-5.0, 0.0, 0.0), VEC::pos_x()) }, {});
+    assertIntersectors(tree, std::vector<PLANE>{ PLANE(VEC::zero(), VEC::pos_x()) }, { 1u, 2u });
+    assertIntersectors(tree, std::vector<PLANE>{ PLANE(VEC::zero(), VEC::neg_x()) }, { 2u, 3u });
+    assertIntersectors(tree, std::vector<PLANE>{
+        PLANE(VEC(+1.5, 0.0, 0.0), VEC::pos_x()),
+        PLANE(VEC(-1.5, 0.0, 0.0), VEC::neg_x())
+    }, { 2u });
+    assertIntersectors(tree, std::vector<PLANE>{
+        PLANE(VEC(0.0, +2.0, 0.0), VEC::pos_y()),
+        PLANE(VEC(0.0, +1.5, 0.0), VEC::neg_y())
+    }, {});
+}
+
+TEST(AABBTreeTest, findIntersectorsOfBox) {
+    AABB tree;
+    assertIntersectors(tree, BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), {});
+
+    tree.insert(BOX(VEC(-4.0, -1.0, -1.0), VEC(-2.0, +1.0, +1.0)), 1u);
+    tree.insert(BOX(VEC(-1.0, -1.0, -1.0), VEC(+1.0, +1.0, +1.0)), 2u);
+    tree.insert(BOX(VEC(+2.0, -1.0, -1.0), VEC(+4.0, +1.0, +1.0)), 3u);
+
+    assertIntersectors(tree, BOX(VEC(-5.0, -5.0, -5.0), VEC(+5.0, +5.0, +5.0)), { 1u, 2u, 3u });
+    assertIntersectors(tree, BOX(VEC(-1.5, -0.5, -0.5), VEC(+1.5, +0.5, +0.5)), { 2u });
+    assertIntersectors(tree, BOX(VEC(-3.0, -0.5, -0.5), VEC(+3.0, +0.5, +0.5)), { 1u, 2u, 3u });
+    assertIntersectors(tree, BOX(VEC(-1.5, +2.0, -0.5), VEC(+1.5, +3.0, +0.5)), {});
+
+    // touching boxes intersect
+    assertIntersectors(tree, BOX(VEC(+1.0, -0.5, -0.5), VEC(+2.0, +0.5, +0.5)), { 2u, 3u });
+}
+
+TEST(AABBTreeTest, findIntersectorsWhileModifyingAndWhenQuiescent) {
+    std::vector<BOX> boxes;
+    AABB tree;
+    for (size_t i = 0; i < 64; ++i) {
+        const auto x = static_cast<double>(i % 8) * 3.0;
+        const auto y = static_cast<double>(i / 8) * 3.0;
+        boxes.push_back(BOX(VEC(x, y, -1.0), VEC(x + 1.0, y + 1.0, +1.0)));
+        tree.insert(boxes.back(), i);
+    }
+
+    const auto assertIntersectorsOfRows = [&]() {
+        for (size_t row = 0; row < 8; ++row) {
+            const auto ray = RAY(VEC(-1.0, static_cast<double>(row) * 3.0 + 0.5, 0.0), VEC::pos_x());
+
+            std::set<size_t> expected;
+            for (size_t i = 0; i < boxes.size(); ++i) {
+                if (boxes[i].min.y() <= ray.origin.y() && ray.origin.y() <= boxes[i].max.y()) {
+                    expected.insert(i);
+                }
+            }
+
+            std::set<size_t> actual;
+            tree.findIntersectors(ray, std::inserter(actual, std::end(actual)));
+            ASSERT_EQ(expected, actual);
+        }
+    };
+
+    // queries that are interleaved with modifications traverse the tree itself
+    for (size_t i = 0; i < boxes.size(); i += 2) {
+        boxes[i] = BOX(boxes[i].min + VEC(0.0, 1.5, 0.0), boxes[i].max + VEC(0.0, 1.5, 0.0));
+        tree.update(boxes[i], i);
+        assertIntersectorsOfRows();
+    }
+
+    // once the tree is no longer modified, queries switch to its flattened copy
+    for (size_t i = 0; i < 16; ++i) {
+        assertIntersectorsOfRows();
+    }
+}
+
+TEST(AABBTreeTest, findIntersectorsOfDistantAndGrazingRays) {
+    // boxes whose coordinates cannot be represented exactly as floats
+    std::vector<BOX> boxes;
+    std::vector<size_t> data;
+    for (size_t i = 0; i < 64; ++i) {
+        const auto x = 0.1 + static_cast<double>(i % 4) * 2.3;
+        const auto y = -0.7 + static_cast<double>((i / 4) % 4) * 2.3;
+        const auto z = 3.3 + static_cast<double>(i / 16) * 2.3;
+        boxes.push_back(BOX(VEC(x, y, z), VEC(x + 1.1, y + 1.1, z + 1.1)));
+        data.push_back(i);
+    }
+
+    AABB tree;
+    tree.clearAndBuild(data, [&](const size_t i) { return boxes[i]; });
+
+    // rays from distant origins that graze the corners, edges and faces of the boxes
+    std::vector<RAY> rays;
+    const std::vector<VEC> origins({
+        VEC(-1.23456789e7, 0.3, 0.7),
+        VEC(1.0000003e7, -3.3333333e6, 1.2345678e5),
+        VEC(1.1, -7.7777777e6, 8.8888888e6)
+    });
+    for (const auto& box : boxes) {
+        for (const auto& origin : origins) {
+            rays.push_back(RAY(origin, vm::normalize(box.min - origin)));
+            rays.push_back(RAY(origin, vm::normalize(box.max - origin)));
+            rays.push_back(RAY(origin, vm::normalize(VEC(box.max.x(), box.min.y(), box.center().z()) - origin)));
+        }
+        rays.push_back(RAY(VEC(-1.0e7, box.max.y(), box.center().z()), VEC::pos_x()));
+        rays.push_back(RAY(VEC(box.min.x(), box.min.y(), -1.0e7), VEC::pos_z()));
+    }
+
+    // every ray must find exactly the items whose bounds it intersects in double precision
+    const auto expectedIntersectors = [&](const RAY& ray) {
+        std::set<AABB::DataType> result;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, boxes[i]))) {
+                result.insert(i);
+            }
+        }
+        return result;
+    };
+
+    // the first queries traverse the tree itself, and the later queries use its flattened copy
+    for (size_t pass = 0; pass < 2; ++pass) {
+        size_t hits = 0;
+        for (const auto& ray : rays) {
+            const auto expected = expectedIntersectors(ray);
+            hits += expected.size();
+
+            std::set<AABB::DataType> actual;
+            tree.findIntersectors(ray, std::inserter(actual, std::end(actual)));
+            ASSERT_EQ(expected, actual);
+        }
+        ASSERT_GT(hits, 0u);
+    }
+
+    std::vector<std::set<AABB::DataType>> actual(rays.size());
+    tree.findIntersectors(rays, [&](const size_t rayIndex, const AABB::DataType item) {
+        actual[rayIndex].insert(item);
+    });
+    for (size_t i = 0; i < rays.size(); ++i) {
+        ASSERT_EQ(expectedIntersectors(rays[i]), actual[i]);
+    }
+}
+
 void assertTree(const std::string& exp, const AABB& actual) {
     std::stringstream str;
     actual.print(str);
@@ -498,6 +778,24 @@ void assertIntersectors(const AABB& tree, const RAY& ray, std::initializer_list<
     ASSERT_EQ(expected, actual);
 }
 
+void assertIntersectors(const AABB& tree, const std::vector<PLANE>& planes, std::initializer_list<AABB::DataType> items) {
+    const std::set<AABB::DataType> expected(items);
+    std::set<AABB::DataType> actual;
+
+    tree.findIntersectorsOfConvexVolume(planes, std::inserter(actual, std::end(actual)));
+
+    ASSERT_EQ(expected, actual);
+}
+
+void assertIntersectors(const AABB& tree, const BOX& box, std::initializer_list<AABB::DataType> items) {
+    const std::set<AABB::DataType> expected(items);
+    std::set<AABB::DataType> actual;
+
+    tree.findIntersectors(box, std::inserter(actual, std::end(actual)));
+
+    ASSERT_EQ(expected, actual);
+}
+
 void assertTreeContains(const AABB& tree, const BOX& box, AABB::DataType data) {
     ASSERT_TRUE(tree.contains(data));
 
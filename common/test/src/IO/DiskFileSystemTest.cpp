@@ -22,6 +22,7 @@
 #include "Exceptions.h"
 #include "Macros.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/File.h"
 #include "IO/FileMatcher.h"
 #include "IO/Path.h"
 #include "IO/PathQt.h"
@@ -123,6 +124,30 @@ namespace TrenchBroom {
             ASSERT_TRUE(Disk::openFile(env.dir() + Path("anotherDir/subDirTest/test2.map")) != nullptr);
         }
 
+        TEST(DiskTest, readOpenedFile) {
+            FSTestEnvironment env;
+
+            const auto file = Disk::openFile(env.dir() + Path("test.txt"));
+            ASSERT_TRUE(dynamic_cast<const CFile*>(file.get()) != nullptr);
+            ASSERT_EQ(12u, file->size());
+
+            const auto reader = file->reader().buffer();
+            ASSERT_EQ(String("some content"), String(std::begin(reader), std::end(reader)));
+        }
+
+        TEST(DiskTest, mapFile) {
+            FSTestEnvironment env;
+
+            ASSERT_THROW(Disk::mapFile(env.dir() + Path("does_not_exist.txt")), FileNotFoundException);
+
+            const auto file = Disk::mapFile(env.dir() + Path("test.txt"));
+            ASSERT_TRUE(dynamic_cast<const MappedFile*>(file.get()) != nullptr);
+            ASSERT_EQ(12u, file->size());
+
+            const auto reader = file->reader().buffer();
+            ASSERT_EQ(String("some content"), String(std::begin(reader), std::end(reader)));
+        }
+
         TEST(DiskTest, resolvePath) {
             FSTestEnvironment env;
 
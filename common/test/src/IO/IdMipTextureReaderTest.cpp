@@ -24,11 +24,15 @@
 #include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/FileMatcher.h"
 #include "IO/IdMipTextureReader.h"
 #include "IO/Path.h"
+#include "IO/TextureCollectionLoader.h"
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
+#include <memory>
+
 namespace TrenchBroom {
     namespace IO {
         static void assertTexture(const String& name, const size_t width, const size_t height, const FileSystem& fs, const TextureReader& loader) {
@@ -74,5 +78,61 @@ namespace TrenchBroom {
             assertTexture("blowjob_machine",   128, 128, wadFS, textureLoader);
             assertTexture("lasthopeofhuman",   128, 128, wadFS, textureLoader);
         }
+
+        TEST(IdMipTextureReaderTest, testReadTextureInfo) {
+            DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const Assets::Palette palette = Assets::Palette::loadFile(fs, Path("fixture/test/palette.lmp"));
+
+            TextureReader::TextureNameStrategy nameStrategy;
+            IdMipTextureReader textureLoader(nameStrategy, palette);
+
+            const Path wadPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad");
+            NullLogger logger;
+            WadFileSystem wadFS(wadPath, logger);
+
+            for (const auto& texturePath : wadFS.findItems(Path(""), FileExtensionMatcher(StringList { "D" }))) {
+                std::unique_ptr<const Assets::Texture> expected(textureLoader.readTexture(wadFS.openFile(texturePath)));
+                std::unique_ptr<const Assets::Texture> actual(textureLoader.readTextureInfo(wadFS.openFile(texturePath)));
+                ASSERT_EQ(expected->name(), actual->name());
+                ASSERT_EQ(expected->width(), actual->width());
+                ASSERT_EQ(expected->height(), actual->height());
+                ASSERT_EQ(expected->format(), actual->format());
+                ASSERT_EQ(expected->type(), actual->type());
+
+                // the image data is not read
+                ASSERT_TRUE(actual->buffersIfUnprepared().empty());
+            }
+        }
+
+        TEST(IdMipTextureReaderTest, testLoadWadCollection) {
+            DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const Assets::Palette palette = Assets::Palette::loadFile(fs, Path("fixture/test/palette.lmp"));
+
+            TextureReader::TextureNameStrategy nameStrategy;
+            auto textureLoader = std::make_shared<IdMipTextureReader>(nameStrategy, palette);
+            ASSERT_TRUE(textureLoader->canReadConcurrently());
+
+            NullLogger logger;
+            FileTextureCollectionLoader collectionLoader(logger, Path::List { IO::Disk::getCurrentWorkingDir() });
+            const auto collection = collectionLoader.loadTextureCollection(Path("fixture/test/IO/Wad/cr8_czg.wad"), StringList { "D" }, textureLoader);
+
+            // the textures are decoded concurrently, but must be added in the order of the files
+            const Path wadPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad");
+            WadFileSystem wadFS(wadPath, logger);
+            const auto texturePaths = wadFS.findItems(Path(""), FileExtensionMatcher(StringList { "D" }));
+
+            ASSERT_EQ(texturePaths.size(), collection->textureCount());
+            for (size_t i = 0; i < texturePaths.size(); ++i) {
+                std::unique_ptr<const Assets::Texture> expected(textureLoader->readTexture(wadFS.openFile(texturePaths[i])));
+                const auto* actual = collection->textureByIndex(i);
+                ASSERT_EQ(expected->name(), actual->name());
+                ASSERT_EQ(expected->width(), actual->width());
+                ASSERT_EQ(expected->height(), actual->height());
+
+                // the pixel data is only decoded again when the texture is used
+                ASSERT_TRUE(actual->buffersIfUnprepared().empty());
+                ASSERT_FALSE(actual->isUploaded());
+            }
+        }
     }
 }
@@ -20,16 +20,23 @@
 #include <gtest/gtest.h>
 
 #include "StringUtils.h"
+#include "IO/MapTextSnapshot.h"
 #include "IO/NodeWriter.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushFaceAttributes.h"
+#include "Model/Entity.h"
 #include "Model/Group.h"
 #include "Model/Layer.h"
 #include "Model/MapFormat.h"
 #include "Model/World.h"
 
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+
+#include <cstdio>
+
 namespace TrenchBroom {
     namespace IO {
         TEST(NodeWriterTest, writeEmptyMap) {
@@ -444,6 +451,150 @@ R"(( -32 -32 -32 ) ( -32 -31 -32 ) ( -32 -32 -31 ) none 0 0 0 1 1
             delete brush;
         }
 
+        TEST(NodeWriterTest, writeFacesToFile) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::World map(Model::MapFormat::Standard, worldBounds);
+            Model::BrushBuilder builder(&map, worldBounds);
+            Model::Brush* brush = builder.createCube(64.5, "none");
+
+            Model::BrushFace* face = brush->faces().front();
+            face->setXOffset(0.5f);
+            face->setRotation(22.5f);
+            face->setXScale(0.3f);
+
+            FILE* file = std::tmpfile();
+            ASSERT_TRUE(file != nullptr);
+            {
+                NodeWriter writer(map, file);
+                writer.writeBrushFaces(brush->faces());
+            }
+
+            String actual(static_cast<size_t>(std::ftell(file)), '\0');
+            std::rewind(file);
+            ASSERT_EQ(actual.size(), std::fread(&actual[0], 1, actual.size(), file));
+            std::fclose(file);
+
+            const String expected =
+R"(( -32.25 -32.25 -32.25 ) ( -32.25 -31.25 -32.25 ) ( -32.25 -32.25 -31.25 ) none 0.5 0 22.5 0.3 1
+( -32.25 -32.25 -32.25 ) ( -32.25 -32.25 -31.25 ) ( -31.25 -32.25 -32.25 ) none 0 0 0 1 1
+( -32.25 -32.25 -32.25 ) ( -31.25 -32.25 -32.25 ) ( -32.25 -31.25 -32.25 ) none 0 0 0 1 1
+( 32.25 32.25 32.25 ) ( 32.25 33.25 32.25 ) ( 33.25 32.25 32.25 ) none 0 0 0 1 1
+( 32.25 32.25 32.25 ) ( 33.25 32.25 32.25 ) ( 32.25 32.25 33.25 ) none 0 0 0 1 1
+( 32.25 32.25 32.25 ) ( 32.25 32.25 33.25 ) ( 32.25 33.25 32.25 ) none 0 0 0 1 1
+)";
+            ASSERT_EQ(expected, actual);
+
+            delete brush;
+        }
+
+        TEST(NodeWriterTest, writeMapToString) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::World map(Model::MapFormat::Standard, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            Model::BrushBuilder builder(&map, worldBounds);
+            map.defaultLayer()->addChild(builder.createCube(64.5, "none"));
+
+            FILE* file = std::tmpfile();
+            ASSERT_TRUE(file != nullptr);
+            {
+                NodeWriter writer(map, file);
+                writer.writeMap();
+            }
+
+            String expected(static_cast<size_t>(std::ftell(file)), '\0');
+            std::rewind(file);
+            ASSERT_EQ(expected.size(), std::fread(&expected[0], 1, expected.size(), file));
+            std::fclose(file);
+
+            MapTextSnapshot snapshot;
+            snapshot.append("// Game: Test\n");
+            {
+                NodeWriter writer(map, snapshot);
+                writer.writeMap();
+            }
+            ASSERT_EQ("// Game: Test\n" + expected, snapshot.str());
+
+            // the second snapshot reuses the text cached by the first one
+            MapTextSnapshot cachedSnapshot;
+            {
+                NodeWriter writer(map, cachedSnapshot);
+                writer.writeMap();
+            }
+            ASSERT_EQ(expected, cachedSnapshot.str());
+            ASSERT_EQ(expected.size(), cachedSnapshot.size());
+        }
+
+        static void createMapWithBrushesAndEntity(Model::World& map, const vm::bbox3& worldBounds) {
+            map.addOrUpdateAttribute("classname", "worldspawn");
+
+            Model::BrushBuilder builder(&map, worldBounds);
+            map.defaultLayer()->addChild(builder.createCube(64.0, "none"));
+
+            Model::Brush* brush = builder.createCube(64.0, "none");
+            brush->transform(vm::translation_matrix(vm::vec3(128.0, 0.0, 0.0)), false, worldBounds);
+            map.defaultLayer()->addChild(brush);
+
+            Model::Entity* entity = new Model::Entity();
+            entity->addOrUpdateAttribute("classname", "func_door");
+            entity->addOrUpdateAttribute("message", "hello");
+            entity->addChild(builder.createCube(32.0, "none"));
+            map.defaultLayer()->addChild(entity);
+        }
+
+        static void changeBrushAndEntity(Model::World& map) {
+            const Model::NodeList& children = map.defaultLayer()->children();
+            auto* brush = static_cast<Model::Brush*>(children[1]);
+            brush->faces().front()->setXOffset(16.0f);
+
+            auto* entity = static_cast<Model::Entity*>(children[2]);
+            entity->addOrUpdateAttribute("message", "goodbye");
+        }
+
+        TEST(NodeWriterTest, writeMapAgainAfterChanges) {
+            const vm::bbox3 worldBounds(8192.0);
+
+            Model::World map(Model::MapFormat::Standard, worldBounds);
+            createMapWithBrushesAndEntity(map, worldBounds);
+
+            MapTextSnapshot first;
+            NodeWriter(map, first).writeMap();
+
+            MapTextSnapshot second;
+            NodeWriter(map, second).writeMap();
+            ASSERT_EQ(first.str(), second.str());
+
+            changeBrushAndEntity(map);
+
+            MapTextSnapshot actual;
+            NodeWriter(map, actual).writeMap();
+
+            // a map with the same changes that was never written before
+            Model::World expectedMap(Model::MapFormat::Standard, worldBounds);
+            createMapWithBrushesAndEntity(expectedMap, worldBounds);
+            changeBrushAndEntity(expectedMap);
+
+            MapTextSnapshot expected;
+            NodeWriter(expectedMap, expected).writeMap();
+
+            ASSERT_NE(first.str(), actual.str());
+            ASSERT_EQ(expected.str(), actual.str());
+
+            const Model::NodeList& children = map.defaultLayer()->children();
+            const Model::NodeList& expectedChildren = expectedMap.defaultLayer()->children();
+            for (size_t i = 0; i < children.size(); ++i) {
+                ASSERT_EQ(expectedChildren[i]->lineNumber(), children[i]->lineNumber());
+            }
+
+            const auto* brush = static_cast<Model::Brush*>(children[0]);
+            const auto* expectedBrush = static_cast<Model::Brush*>(expectedChildren[0]);
+            for (size_t i = 0; i < brush->faceCount(); ++i) {
+                ASSERT_EQ(expectedBrush->faces()[i]->lineNumber(), brush->faces()[i]->lineNumber());
+            }
+        }
+
         TEST(NodeWriterTest, writePropertiesWithQuotationMarks) {
             const vm::bbox3 worldBounds(8192.0);
 
@@ -34,10 +34,15 @@ namespace TrenchBroom {
             return it->second;
         }
 
+        const StringList& TestParserStatus::messages() const {
+            return m_messages;
+        }
+
         void TestParserStatus::doProgress(const double) {}
 
         void TestParserStatus::doLog(const Logger::LogLevel level, const String& str) {
             MapUtils::findOrInsert(m_statusCounts, level, 0u)->second++;
+            m_messages.push_back(str);
         }
     }
 }
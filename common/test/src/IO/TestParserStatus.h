@@ -21,6 +21,7 @@
 #define TrenchBroom_TestParserStatus
 
 #include "Logger.h"
+#include "StringList.h"
 #include "StringType.h"
 #include "IO/ParserStatus.h"
 
@@ -33,10 +34,12 @@ namespace TrenchBroom {
             static NullLogger _logger;
             using StatusCounts = std::map<Logger::LogLevel, size_t>;
             StatusCounts m_statusCounts;
+            StringList m_messages;
         public:
             TestParserStatus();
         public:
             size_t countStatus(Logger::LogLevel level) const;
+            const StringList& messages() const;
         private:
             void doProgress(double progress) override;
             void doLog(Logger::LogLevel level, const String& str) override;
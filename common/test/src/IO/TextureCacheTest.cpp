@@ -0,0 +1,169 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Logger.h"
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/FileMatcher.h"
+#include "IO/IdMipTextureReader.h"
+#include "IO/Path.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TextureCache.h"
+#include "IO/TextureCollectionLoader.h"
+#include "IO/WadFileSystem.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST(TextureCacheTest, writeAndReadTextures) {
+            TestEnvironment env("texture_cache_test");
+            NullLogger logger;
+
+            DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const Assets::Palette palette = Assets::Palette::loadFile(fs, Path("fixture/test/palette.lmp"));
+
+            TextureReader::TextureNameStrategy nameStrategy;
+            IdMipTextureReader textureReader(nameStrategy, palette);
+
+            const Path wadPath = Disk::getCurrentWorkingDir() + Path("fixture/test/IO/Wad/cr8_czg.wad");
+            WadFileSystem wadFS(wadPath, logger);
+            const auto texturePaths = wadFS.findItems(Path(""), FileExtensionMatcher(StringList { "D" }));
+
+            std::vector<std::unique_ptr<Assets::Texture>> textures;
+            std::vector<std::pair<TextureCache::Key, const Assets::Texture*>> entries;
+            for (const auto& texturePath : texturePaths) {
+                const auto file = wadFS.openFile(texturePath);
+                textures.emplace_back(textureReader.readTexture(file));
+                entries.emplace_back(TextureCache::key(*file, 1), textures.back().get());
+            }
+
+            const auto cachePath = env.dir() + Path("cache/textures.tbtc");
+            TextureCache(cachePath, logger).write(entries);
+            ASSERT_TRUE(env.fileExists(Path("cache/textures.tbtc")));
+
+            const TextureCache cache(cachePath, logger);
+            ASSERT_EQ(entries.size(), cache.size());
+            ASSERT_EQ(nullptr, cache.readTexture(TextureCache::key(*wadFS.openFile(texturePaths.front()), 2)));
+
+            for (const auto& [key, expected] : entries) {
+                std::unique_ptr<const Assets::Texture> actual(cache.readTexture(key));
+                ASSERT_NE(nullptr, actual);
+                ASSERT_EQ(expected->name(), actual->name());
+                ASSERT_EQ(expected->width(), actual->width());
+                ASSERT_EQ(expected->height(), actual->height());
+                ASSERT_EQ(expected->averageColor(), actual->averageColor());
+                ASSERT_EQ(expected->type(), actual->type());
+
+                // the pixel data is only read from the cache file when the texture is uploaded
+                ASSERT_TRUE(actual->buffersIfUnprepared().empty());
+            }
+        }
+
+        TEST(TextureCacheTest, writePlaceholderTextures) {
+            TestEnvironment env("texture_cache_test");
+            NullLogger logger;
+
+            // a texture that could not be decoded has no pixel data, but it must be cached nonetheless
+            const Assets::Texture placeholder("placeholder", 16, 16);
+            const auto cachePath = env.dir() + Path("textures.tbtc");
+            TextureCache(cachePath, logger).write({ { 1u, &placeholder } });
+
+            const TextureCache cache(cachePath, logger);
+            ASSERT_EQ(1u, cache.size());
+            ASSERT_TRUE(cache.contains(1u));
+
+            std::unique_ptr<const Assets::Texture> actual(cache.readTexture(1u));
+            ASSERT_NE(nullptr, actual);
+            ASSERT_EQ(placeholder.name(), actual->name());
+            ASSERT_EQ(placeholder.width(), actual->width());
+            ASSERT_EQ(placeholder.height(), actual->height());
+        }
+
+        TEST(TextureCacheTest, pruneLeastRecentlyUsedFiles) {
+            TestEnvironment env("texture_cache_test");
+            NullLogger logger;
+
+            const Assets::Texture texture("texture", 16, 16, Color(), Assets::TextureBuffer(16 * 16 * 3), GL_RGB, Assets::TextureType::Opaque);
+            for (const auto* name : { "a.tbtc", "b.tbtc", "c.tbtc" }) {
+                TextureCache(env.dir() + Path(name), logger).write({ { 1u, &texture } });
+            }
+
+            // using a cache file makes it the most recently used one
+            TextureCache(env.dir() + Path("a.tbtc"), logger);
+
+            const auto fileSize = Disk::openFile(env.dir() + Path("a.tbtc"))->size();
+            TextureCache::prune(env.dir(), 2u * fileSize, logger);
+
+            ASSERT_TRUE(env.fileExists(Path("a.tbtc")));
+            ASSERT_FALSE(env.fileExists(Path("b.tbtc")));
+            ASSERT_TRUE(env.fileExists(Path("c.tbtc")));
+
+            // the most recently used file is kept even if it exceeds the size limit on its own
+            TextureCache::prune(env.dir(), 0u, logger);
+            ASSERT_TRUE(env.fileExists(Path("a.tbtc")));
+            ASSERT_FALSE(env.fileExists(Path("c.tbtc")));
+        }
+
+        TEST(TextureCacheTest, ignoreInvalidCacheFile) {
+            TestEnvironment env("texture_cache_test");
+            env.createFile(Path("textures.tbtc"), "TBTC garbage");
+
+            NullLogger logger;
+            const TextureCache cache(env.dir() + Path("textures.tbtc"), logger);
+            ASSERT_EQ(0u, cache.size());
+        }
+
+        TEST(TextureCacheTest, loadCachedTextureCollection) {
+            TestEnvironment env("texture_cache_test");
+            NullLogger logger;
+
+            DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const Assets::Palette palette = Assets::Palette::loadFile(fs, Path("fixture/test/palette.lmp"));
+
+            TextureReader::TextureNameStrategy nameStrategy;
+            auto textureReader = std::make_shared<IdMipTextureReader>(nameStrategy, palette);
+
+            FileTextureCollectionLoader collectionLoader(logger, Path::List { IO::Disk::getCurrentWorkingDir() });
+            collectionLoader.enableCache(env.dir(), 1, 1024u * 1024u * 1024u);
+
+            const auto collectionPath = Path("fixture/test/IO/Wad/cr8_czg.wad");
+            const auto decoded = collectionLoader.loadTextureCollection(collectionPath, StringList { "D" }, textureReader);
+            const auto cached = collectionLoader.loadTextureCollection(collectionPath, StringList { "D" }, textureReader);
+
+            ASSERT_EQ(decoded->textureCount(), cached->textureCount());
+            for (size_t i = 0; i < decoded->textureCount(); ++i) {
+                const auto* expected = decoded->textureByIndex(i);
+                const auto* actual = cached->textureByIndex(i);
+                ASSERT_EQ(expected->name(), actual->name());
+                ASSERT_EQ(expected->width(), actual->width());
+                ASSERT_EQ(expected->height(), actual->height());
+                ASSERT_FALSE(actual->isUploaded());
+            }
+        }
+    }
+}
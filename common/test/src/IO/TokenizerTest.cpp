@@ -22,6 +22,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 namespace TrenchBroom {
     namespace IO {
         namespace SimpleToken {
@@ -238,5 +240,41 @@ namespace TrenchBroom {
             ASSERT_EQ(SimpleToken::CBrace, (token = tokenizer.nextToken()).type());
             ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
         }
+
+        TEST(TokenizerTest, simpleLanguageBlockWithLongIntegerAttribute) {
+            const String testString("{\n"
+                                    "    attribute = 1234567890123456;\n"
+                                    "}");
+
+            SimpleTokenizer tokenizer(testString);
+            SimpleTokenizer::Token token;
+            ASSERT_EQ(SimpleToken::OBrace, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::String, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::Equals, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::Integer, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(1234567890123456.0, token.toFloat<double>());
+            ASSERT_EQ(SimpleToken::Semicolon, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(2u, token.line());
+            ASSERT_EQ(33u, token.column());
+            ASSERT_EQ(SimpleToken::CBrace, (token = tokenizer.nextToken()).type());
+            ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
+        }
+
+        TEST(TokenizerTest, tokenToFloatIsExact) {
+            const auto toFloat = [](const String& str) {
+                const auto token = SimpleTokenizer::Token(SimpleToken::Decimal, str.data(), str.data() + str.size(), 0, 1, 1);
+                return token.toFloat<double>();
+            };
+
+            ASSERT_EQ(0.1, toFloat("0.1"));
+            ASSERT_EQ(-0.5, toFloat("-.5"));
+            ASSERT_EQ(1320.25, toFloat("1320.25"));
+            ASSERT_EQ(1e-5, toFloat("1e-5"));
+            ASSERT_EQ(0.30000000000000004, toFloat("0.30000000000000004"));
+            ASSERT_EQ(505.37931034482756, toFloat("505.37931034482756"));
+            ASSERT_EQ(9007199254740993.0, toFloat("9007199254740993"));
+            ASSERT_EQ(1e23, toFloat("1e23"));
+            ASSERT_TRUE(std::signbit(toFloat("-0")));
+        }
     }
 }
@@ -19,6 +19,8 @@
 
 #include <gtest/gtest.h>
 
+#include "StringStream.h"
+#include "StringUtils.h"
 #include "IO/TestParserStatus.h"
 #include "IO/WorldReader.h"
 #include "Model/Brush.h"
@@ -929,6 +931,93 @@ common/caulk
             ASSERT_STREQ("vm::line1\\nvm::line2", world->attribute("message").c_str());
         }
 
+        TEST(WorldReaderTest, parseManyBrushes) {
+            // large maps are parsed in chunks, which must yield the same result as parsing them in one go
+            static const size_t WorldBrushCount = 2000;
+            static const size_t EntityBrushCount = 100;
+
+            const auto brush = [](const size_t i) {
+                StringStream str;
+                const auto x = static_cast<int>(i) * 64;
+                str << "{\n"
+                    << "( " << x << " -0 -16 ) ( " << x << " -0 -0 ) ( " << x + 64 << " -0 -16 ) tex" << i << " 0 0 0 1 1\n"
+                    << "( " << x << " -0 -16 ) ( " << x << " 64 -16 ) ( " << x << " -0 -0 ) tex" << i << " 0 0 0 1 1\n"
+                    << "( " << x << " -0 -16 ) ( " << x + 64 << " -0 -16 ) ( " << x << " 64 -16 ) tex" << i << " 0 0 0 1 1\n"
+                    << "( " << x + 64 << " 64 -0 ) ( " << x << " 64 -0 ) ( " << x + 64 << " 64 -16 ) tex" << i << " 0 0 0 1 1\n"
+                    << "( " << x + 64 << " 64 -0 ) ( " << x + 64 << " 64 -16 ) ( " << x + 64 << " -0 -0 ) tex" << i << " 0 0 0 1 1\n"
+                    << "( " << x + 64 << " 64 -0 ) ( " << x + 64 << " -0 -0 ) ( " << x << " 64 -0 ) tex" << i << " 0 0 0 1 1\n"
+                    << "}\n";
+                return str.str();
+            };
+
+            StringStream data;
+            data << "{\n\"classname\" \"worldspawn\"\n";
+            for (size_t i = 0; i < WorldBrushCount; ++i) {
+                data << brush(i);
+            }
+            data << "}\n{\n\"classname\" \"func_group\"\n";
+            for (size_t i = 0; i < EntityBrushCount; ++i) {
+                data << brush(i);
+            }
+            data << "}\n";
+
+            const vm::bbox3 worldBounds(256.0 * 1024.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data.str());
+
+            auto world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            ASSERT_EQ(1u, world->childCount());
+
+            const auto& worldBrushes = world->defaultLayer()->children();
+            ASSERT_EQ(WorldBrushCount + 1u, worldBrushes.size());
+            for (size_t i = 0; i < WorldBrushCount; ++i) {
+                auto* brush = static_cast<Model::Brush*>(worldBrushes[i]);
+                ASSERT_EQ(3u + 8u * i, brush->lineNumber());
+                ASSERT_EQ(6u, brush->faceCount());
+                ASSERT_EQ("tex" + std::to_string(i), brush->faces().front()->textureName());
+                ASSERT_EQ(4u + 8u * i, brush->faces().front()->lineNumber());
+            }
+
+            auto* entity = static_cast<Model::Entity*>(worldBrushes.back());
+            ASSERT_EQ(EntityBrushCount, entity->childCount());
+            ASSERT_EQ(3u + 8u * WorldBrushCount + 3u, entity->children().front()->lineNumber());
+        }
+
+        TEST(WorldReaderTest, parseInvalidBrushesReportsErrorsInFileOrder) {
+            // the first brush is incomplete, and the second brush has a face with colinear points
+            const String data(R"(
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0 -0 ) ( 64 -0 -16 ) tex1 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0 -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex3 0 0 0 1 1
+}
+{
+( -0 -0 -16 ) ( -0 -0 -0 ) ( 64 -0 -16 ) tex1 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0 -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex3 0 0 0 1 1
+( 0 0 0 ) ( 1 0 0 ) ( 2 0 0 ) tex4 0 0 0 1 1
+( 64 64 -0 ) ( -0 64 -0 ) ( 64 64 -16 ) tex4 0 0 0 1 1
+( 64 64 -0 ) ( 64 64 -16 ) ( 64 -0 -0 ) tex5 0 0 0 1 1
+( 64 64 -0 ) ( 64 -0 -0 ) ( -0 64 -0 ) tex6 0 0 0 1 1
+}
+})");
+            const vm::bbox3 worldBounds(8192.0);
+
+            IO::TestParserStatus status;
+            WorldReader reader(data);
+
+            auto world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            ASSERT_EQ(1u, world->defaultLayer()->childCount());
+
+            const auto& messages = status.messages();
+            ASSERT_EQ(2u, messages.size());
+            ASSERT_TRUE(StringUtils::containsCaseSensitive(messages[0], "Skipping brush"));
+            ASSERT_TRUE(StringUtils::containsCaseSensitive(messages[1], "Skipping face"));
+        }
+
         /*
         TEST(WorldReaderTest, parseIssueIgnoreFlags) {
             const String data("{"
@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "InternedString.h"
+#include "ParallelUtils.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    TEST(InternedStringTest, emptyString) {
+        const InternedString defaultConstructed;
+        const InternedString empty("");
+
+        ASSERT_TRUE(defaultConstructed.empty());
+        ASSERT_TRUE(empty.empty());
+        ASSERT_EQ(defaultConstructed, empty);
+        ASSERT_EQ(String(""), empty.str());
+
+        InternedString found("something");
+        ASSERT_TRUE(InternedString::find("", found));
+        ASSERT_TRUE(found.empty());
+    }
+
+    TEST(InternedStringTest, equalStringsShareEntry) {
+        const InternedString str1("interned_test_key");
+        const InternedString str2(String("interned_test_") + "key");
+        const InternedString str3("interned_test_other");
+
+        ASSERT_EQ(str1, str2);
+        ASSERT_EQ(&str1.str(), &str2.str());
+        ASSERT_EQ(str1.hash(), str2.hash());
+        ASSERT_NE(str1, str3);
+        ASSERT_EQ(String("interned_test_key"), str1.str());
+    }
+
+    TEST(InternedStringTest, find) {
+        InternedString result;
+        ASSERT_FALSE(InternedString::find("interned_test_find", result));
+        ASSERT_TRUE(result.empty());
+
+        const InternedString str("interned_test_find");
+        ASSERT_TRUE(InternedString::find("interned_test_find", result));
+        ASSERT_EQ(str, result);
+    }
+
+    TEST(InternedStringTest, releaseLastHandle) {
+        const size_t poolSize = InternedString::poolSize();
+        {
+            InternedString str1("interned_test_release");
+            ASSERT_EQ(poolSize + 1u, InternedString::poolSize());
+
+            const InternedString str2 = str1;
+            str1 = InternedString();
+            ASSERT_EQ(poolSize + 1u, InternedString::poolSize());
+
+            InternedString str3 = std::move(str1);
+            ASSERT_TRUE(str3.empty());
+        }
+        ASSERT_EQ(poolSize, InternedString::poolSize());
+
+        InternedString result;
+        ASSERT_FALSE(InternedString::find("interned_test_release", result));
+    }
+
+    TEST(InternedStringTest, concurrentAcquireAndRelease) {
+        const size_t poolSize = InternedString::poolSize();
+
+        ParallelUtils::parallelFor(10000, [](const size_t i) {
+            const InternedString str("interned_test_" + std::to_string(i % 16));
+            const InternedString copy = str;
+            InternedString found;
+            ASSERT_TRUE(InternedString::find(str.str(), found));
+            ASSERT_EQ(str, found);
+        }, 64);
+
+        ASSERT_EQ(poolSize, InternedString::poolSize());
+    }
+}
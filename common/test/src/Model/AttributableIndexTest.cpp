@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include "CollectionUtils.h"
+#include "Exceptions.h"
 #include "Model/AttributableNode.h"
 #include "Model/AttributableNodeIndex.h"
 #include "Model/Entity.h"
@@ -160,6 +161,106 @@ namespace TrenchBroom {
             delete entity1;
         }
 
+        TEST(EntityAttributeIndexTest, findNumberedEntityAttributeIgnoresOtherSuffixes) {
+            AttributableNodeIndex index;
+
+            Entity* entity1 = new Entity();
+            entity1->addOrUpdateAttribute("target", "somevalue");
+
+            Entity* entity2 = new Entity();
+            entity2->addOrUpdateAttribute("target2", "somevalue");
+
+            Entity* entity3 = new Entity();
+            entity3->addOrUpdateAttribute("targetname", "somevalue");
+
+            index.addAttributableNode(entity1);
+            index.addAttributableNode(entity2);
+            index.addAttributableNode(entity3);
+
+            const AttributableNodeList attributables = findNumberedExact(index, "target", "somevalue");
+            ASSERT_EQ(2u, attributables.size());
+            ASSERT_TRUE(VectorUtils::contains(attributables, entity1));
+            ASSERT_TRUE(VectorUtils::contains(attributables, entity2));
+
+            delete entity1;
+            delete entity2;
+            delete entity3;
+        }
+
+        TEST(EntityAttributeIndexTest, addRemoveManyAttributableNodes) {
+            AttributableNodeIndex index;
+
+            AttributableNodeList entities;
+            for (size_t i = 0; i < 100; ++i) {
+                Entity* entity = new Entity();
+                entity->addOrUpdateAttribute("classname", "light");
+                index.addAttributableNode(entity);
+                entities.push_back(entity);
+            }
+
+            ASSERT_EQ(100u, findExactExact(index, "classname", "light").size());
+
+            for (size_t i = 0; i < entities.size(); i += 2) {
+                index.removeAttributableNode(entities[i]);
+            }
+
+            const AttributableNodeList attributables = findExactExact(index, "classname", "light");
+            ASSERT_EQ(50u, attributables.size());
+            ASSERT_FALSE(VectorUtils::contains(attributables, entities[0]));
+            ASSERT_TRUE(VectorUtils::contains(attributables, entities[1]));
+
+            for (size_t i = 1; i < entities.size(); i += 2) {
+                index.removeAttributableNode(entities[i]);
+            }
+
+            ASSERT_TRUE(findExactExact(index, "classname", "light").empty());
+            ASSERT_TRUE(index.allNames().empty());
+
+            VectorUtils::clearAndDelete(entities);
+        }
+
+        TEST(EntityAttributeIndexTest, removeAttributeOfOtherNode) {
+            AttributableNodeIndex index;
+
+            Entity* entity1 = new Entity();
+            entity1->addOrUpdateAttribute("test", "somevalue");
+
+            Entity* entity2 = new Entity();
+            entity2->addOrUpdateAttribute("test", "somevalue");
+
+            index.addAttributableNode(entity1);
+
+            ASSERT_THROW(index.removeAttribute(entity2, "test", "somevalue"), Exception);
+
+            const AttributableNodeList attributables = findExactExact(index, "test", "somevalue");
+            ASSERT_EQ(1u, attributables.size());
+            ASSERT_EQ(entity1, attributables.front());
+
+            delete entity1;
+            delete entity2;
+        }
+
+        TEST(EntityAttributeIndexTest, removeAndAddAttributableNodeAgain) {
+            AttributableNodeIndex index;
+
+            Entity* entity1 = new Entity();
+            entity1->addOrUpdateAttribute("test", "somevalue");
+
+            index.addAttributableNode(entity1);
+            index.removeAttributableNode(entity1);
+            ASSERT_TRUE(findExactExact(index, "test", "somevalue").empty());
+            ASSERT_TRUE(index.allNames().empty());
+
+            index.addAttributableNode(entity1);
+            ASSERT_EQ(AttributableNodeList{entity1}, findExactExact(index, "test", "somevalue"));
+            ASSERT_EQ(StringList{"test"}, index.allNames());
+
+            index.removeAttributableNode(entity1);
+            ASSERT_TRUE(findExactExact(index, "test", "somevalue").empty());
+            ASSERT_TRUE(index.allNames().empty());
+
+            delete entity1;
+        }
 
         TEST(EntityAttributeIndexTest, addRemoveFloatProperty) {
             AttributableNodeIndex index;
@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include "TrenchBroom.h"
+#include "CollectionUtils.h"
 #include "Exceptions.h"
 #include "TestUtils.h"
 #include "Assets/Texture.h"
@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include "CollectionUtils.h"
 #include "TestUtils.h"
 
 #include "Assets/Texture.h"
@@ -36,11 +37,14 @@
 #include "Model/World.h"
 
 #include <vecmath/vec.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
 #include <vecmath/segment.h>
 #include <vecmath/polygon.h>
 #include <vecmath/ray.h>
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iterator>
 #include <memory>
@@ -591,6 +595,32 @@ namespace TrenchBroom {
             PickResult hits2;
             brush.pick(vm::ray3(vm::vec3(8.0, -8.0, 8.0), vm::vec3::neg_y()), hits2);
             ASSERT_TRUE(hits2.empty());
+
+            // passes the brush on the left
+            PickResult hits3;
+            brush.pick(vm::ray3(vm::vec3(-8.0, -8.0, 8.0), vm::vec3::pos_y()), hits3);
+            ASSERT_TRUE(hits3.empty());
+
+            // starts inside of the brush
+            PickResult hits4;
+            brush.pick(vm::ray3(vm::vec3(8.0, 8.0, 8.0), vm::vec3::pos_y()), hits4);
+            ASSERT_TRUE(hits4.empty());
+
+            // enters through the top face at an angle
+            PickResult hits5;
+            brush.pick(vm::ray3(vm::vec3(0.0, 8.0, 24.0), vm::normalize(vm::vec3(1.0, 0.0, -1.0))), hits5);
+            ASSERT_EQ(1u, hits5.size());
+            ASSERT_EQ(top, hits5.all().front().target<BrushFace*>());
+            ASSERT_DOUBLE_EQ(8.0 * std::sqrt(2.0), hits5.all().front().distance());
+
+            // the planes used for picking must follow the brush when it is moved
+            brush.transform(vm::translation_matrix(vm::vec3(0.0, 16.0, 0.0)), false, worldBounds);
+
+            PickResult hits6;
+            brush.pick(vm::ray3(vm::vec3(8.0, -8.0, 8.0), vm::vec3::pos_y()), hits6);
+            ASSERT_EQ(1u, hits6.size());
+            ASSERT_DOUBLE_EQ(24.0, hits6.all().front().distance());
+            ASSERT_EQ(front, hits6.all().front().target<BrushFace*>());
         }
 
         TEST(BrushTest, partialSelectionAfterAdd) {
@@ -3447,6 +3477,60 @@ namespace TrenchBroom {
             EXPECT_FALSE(brush1->canMoveVertices(worldBounds, allVertexPositions, vm::vec3(8192, 0, 0)));
         }
 
+        TEST(BrushTest, transformPastWorldBounds) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            Model::Brush* brush = builder.createCube(128.0, "texture");
+
+            EXPECT_TRUE(brush->canTransform(vm::translation_matrix(vm::vec3(16, 0, 0)), worldBounds));
+            EXPECT_FALSE(brush->canTransform(vm::translation_matrix(vm::vec3(8192, 0, 0)), worldBounds));
+
+            delete brush;
+        }
+
+        TEST(BrushTest, transformBrushes) {
+            const vm::bbox3 worldBounds(8192.0);
+            World world(MapFormat::Valve, worldBounds);
+            const BrushBuilder builder(&world, worldBounds);
+
+            const auto transformation = vm::translation_matrix(vm::vec3(16, 8, 0)) * vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(30.0));
+
+            BrushList expected;
+            BrushList actual;
+            for (size_t i = 0; i < 100; ++i) {
+                const auto min = vm::vec3(static_cast<FloatType>(i) * 64.0, 0.0, 0.0);
+                const vm::bbox3 bounds(min, min + vm::vec3(32.0, 32.0, 32.0));
+                expected.push_back(builder.createCuboid(bounds, "texture"));
+                actual.push_back(builder.createCuboid(bounds, "texture"));
+            }
+
+            for (auto* brush : expected) {
+                brush->transform(transformation, true, worldBounds);
+            }
+            Brush::transformBrushes(actual, transformation, true, worldBounds);
+
+            for (size_t i = 0; i < expected.size(); ++i) {
+                ASSERT_EQ(expected[i]->logicalBounds(), actual[i]->logicalBounds());
+                ASSERT_EQ(expected[i]->vertexPositions(), actual[i]->vertexPositions());
+
+                const auto& expectedFaces = expected[i]->faces();
+                const auto& actualFaces = actual[i]->faces();
+                ASSERT_EQ(expectedFaces.size(), actualFaces.size());
+                for (size_t j = 0; j < expectedFaces.size(); ++j) {
+                    EXPECT_EQ(expectedFaces[j]->boundary(), actualFaces[j]->boundary());
+                    EXPECT_EQ(expectedFaces[j]->textureXAxis(), actualFaces[j]->textureXAxis());
+                    EXPECT_EQ(expectedFaces[j]->textureYAxis(), actualFaces[j]->textureYAxis());
+                    EXPECT_EQ(expectedFaces[j]->offset(), actualFaces[j]->offset());
+                    EXPECT_EQ(expectedFaces[j]->rotation(), actualFaces[j]->rotation());
+                }
+            }
+
+            VectorUtils::deleteAll(expected);
+            VectorUtils::deleteAll(actual);
+        }
+
         // https://github.com/kduske/TrenchBroom/issues/1893
         TEST(BrushTest, intersectsIssue1893) {
             const String data("{\n"
@@ -21,6 +21,7 @@
 #include <gmock/gmock.h>
 
 #include <memory>
+#include <string>
 
 #include "Model/Entity.h"
 #include "Model/EntityAttributes.h"
@@ -97,6 +98,59 @@ namespace TrenchBroom {
             EXPECT_EQ(newBounds, m_entity->logicalBounds());
         }
 
+        TEST_F(EntityTest, addAndRemoveManyAttributes) {
+            // enough attributes to switch from linear search to the attribute index and back
+            for (size_t i = 0; i < 20; ++i) {
+                m_entity->addOrUpdateAttribute("key" + std::to_string(i), std::to_string(i));
+            }
+            for (size_t i = 0; i < 20; i += 2) {
+                m_entity->removeAttribute("key" + std::to_string(i));
+            }
+            m_entity->renameAttribute("key1", "renamed");
+
+            EXPECT_EQ(TestClassname, m_entity->attribute(AttributeNames::Classname));
+            EXPECT_FALSE(m_entity->hasAttribute("key1"));
+            EXPECT_EQ("1", m_entity->attribute("renamed"));
+            for (size_t i = 3; i < 20; i += 2) {
+                EXPECT_EQ(std::to_string(i), m_entity->attribute("key" + std::to_string(i)));
+                EXPECT_FALSE(m_entity->hasAttribute("key" + std::to_string(i - 1)));
+            }
+
+            for (size_t i = 3; i < 20; i += 2) {
+                m_entity->removeAttribute("key" + std::to_string(i));
+            }
+            EXPECT_EQ(2u, m_entity->attributes().size());
+            EXPECT_EQ(TestClassname, m_entity->attribute(AttributeNames::Classname));
+            EXPECT_EQ("1", m_entity->attribute("renamed"));
+        }
+
+        TEST_F(EntityTest, findAttributeByInternedKey) {
+            m_entity->addOrUpdateAttribute("targetname", "a");
+
+            EXPECT_EQ(TestClassname, m_entity->attribute(AttributeNames::ClassnameKey));
+            EXPECT_EQ(TestClassname, m_entity->classname());
+            EXPECT_TRUE(m_entity->hasAttribute(AttributeNames::TargetnameKey));
+            EXPECT_EQ("a", m_entity->attribute(AttributeNames::TargetnameKey));
+            EXPECT_FALSE(m_entity->hasAttribute(AttributeNames::TargetKey));
+            EXPECT_EQ("b", m_entity->attribute(AttributeNames::TargetKey, "b"));
+            EXPECT_EQ("a", findAttribute(m_entity->attributes(), AttributeNames::TargetnameKey));
+        }
+
+        TEST_F(EntityTest, removeNumberedAttribute) {
+            m_entity->addOrUpdateAttribute("target", "a");
+            m_entity->addOrUpdateAttribute("target1", "b");
+            m_entity->addOrUpdateAttribute("target2", "c");
+            m_entity->addOrUpdateAttribute("targetname", "d");
+
+            m_entity->removeNumberedAttribute("target");
+
+            EXPECT_FALSE(m_entity->hasAttribute("target"));
+            EXPECT_FALSE(m_entity->hasAttribute("target1"));
+            EXPECT_FALSE(m_entity->hasAttribute("target2"));
+            EXPECT_EQ("d", m_entity->attribute("targetname"));
+            EXPECT_EQ(TestClassname, m_entity->attribute(AttributeNames::Classname));
+        }
+
         TEST_F(EntityTest, requiresClassnameForRotation) {
             m_world->defaultLayer()->addChild(m_entity);
             m_entity->removeAttribute(AttributeNames::Classname);
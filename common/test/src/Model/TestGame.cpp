@@ -23,6 +23,7 @@
 #include "IO/BrushFaceReader.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/IOUtils.h"
+#include "IO/MapTextSnapshot.h"
 #include "IO/NodeReader.h"
 #include "IO/NodeWriter.h"
 #include "IO/TestParserStatus.h"
@@ -84,6 +85,17 @@ namespace TrenchBroom {
             writer.writeMap();
         }
 
+        void TestGame::doSerializeMap(World& world, IO::MapTextSnapshot& snapshot) const {
+            const auto mapFormatName = formatName(world.format());
+
+            String comment;
+            IO::writeGameComment(comment, gameName(), mapFormatName);
+            snapshot.append(std::move(comment));
+
+            IO::NodeWriter writer(world, snapshot);
+            writer.writeMap();
+        }
+
         void TestGame::doExportMap(World& world, Model::ExportFormat format, const IO::Path& path) const {}
 
         NodeList TestGame::doParseNodes(const String& str, World& world, const vm::bbox3& worldBounds, Logger& logger) const {
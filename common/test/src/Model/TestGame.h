@@ -56,6 +56,7 @@ namespace TrenchBroom {
             std::unique_ptr<World> doNewMap(MapFormat format, const vm::bbox3& worldBounds, Logger& logger) const override;
             std::unique_ptr<World> doLoadMap(MapFormat format, const vm::bbox3& worldBounds, const IO::Path& path, Logger& logger) const override;
             void doWriteMap(World& world, const IO::Path& path) const override;
+            void doSerializeMap(World& world, IO::MapTextSnapshot& snapshot) const override;
             void doExportMap(World& world, Model::ExportFormat format, const IO::Path& path) const override;
 
             NodeList doParseNodes(const String& str, World& world, const vm::bbox3& worldBounds, Logger& logger) const override;
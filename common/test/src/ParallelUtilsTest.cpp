@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "ParallelUtils.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST(ParallelUtilsTest, parallelForEmpty) {
+    size_t calls = 0;
+    ParallelUtils::parallelFor(0, [&](const size_t) { ++calls; });
+    ASSERT_EQ(0u, calls);
+}
+
+TEST(ParallelUtilsTest, parallelForVisitsEveryIndexOnce) {
+    const size_t count = 10000;
+    std::vector<std::atomic<size_t>> visits(count);
+    for (auto& visit : visits) {
+        visit = 0;
+    }
+
+    ParallelUtils::parallelFor(count, [&](const size_t i) { ++visits[i]; }, 7);
+
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(1u, visits[i].load());
+    }
+}
+
+TEST(ParallelUtilsTest, parallelForRethrows) {
+    ASSERT_THROW(ParallelUtils::parallelFor(1000, [](const size_t i) {
+        if (i == 500) {
+            throw std::runtime_error("test");
+        }
+    }), std::runtime_error);
+}
+
+TEST(ParallelUtilsTest, parallelForNested) {
+    const size_t count = 100;
+    std::vector<std::atomic<size_t>> visits(count * count);
+    for (auto& visit : visits) {
+        visit = 0;
+    }
+
+    ParallelUtils::parallelFor(count, [&](const size_t i) {
+        ParallelUtils::parallelFor(count, [&](const size_t j) { ++visits[i * count + j]; });
+    });
+
+    for (size_t i = 0; i < visits.size(); ++i) {
+        ASSERT_EQ(1u, visits[i].load());
+    }
+}
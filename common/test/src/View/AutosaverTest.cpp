@@ -58,6 +58,7 @@ namespace TrenchBroom {
             document->addNode(createBrush("some_texture"), document->currentLayer());
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForPendingSave(logger);
 
             ASSERT_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -72,6 +73,7 @@ namespace TrenchBroom {
 
             Autosaver autosaver(document, 0, 0);
             autosaver.triggerAutosave(logger);
+            autosaver.waitForPendingSave(logger);
 
             ASSERT_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -94,6 +96,7 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(2s);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForPendingSave(logger);
 
             ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_TRUE(env.directoryExists(IO::Path("autosave")));
@@ -112,6 +115,7 @@ namespace TrenchBroom {
             document->addNode(createBrush("some_texture"), document->currentLayer());
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForPendingSave(logger);
 
             ASSERT_FALSE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_FALSE(env.directoryExists(IO::Path("autosave")));
@@ -135,6 +139,7 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(2s);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForPendingSave(logger);
 
             ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_TRUE(env.directoryExists(IO::Path("autosave")));
@@ -157,6 +162,7 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(2s);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForPendingSave(logger);
 
             ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.1.map")));
             ASSERT_TRUE(env.directoryExists(IO::Path("autosave")));
@@ -166,12 +172,14 @@ namespace TrenchBroom {
             std::this_thread::sleep_for(2s);
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForPendingSave(logger);
             ASSERT_FALSE(env.fileExists(IO::Path("autosave/test.2.map")));
 
             // modify the map
             document->addNode(createBrush("some_texture"), document->currentLayer());
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForPendingSave(logger);
             ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.2.map")));
         }
 
@@ -194,6 +202,7 @@ namespace TrenchBroom {
             document->addNode(createBrush("some_texture"), document->currentLayer());
 
             autosaver.triggerAutosave(logger);
+            autosaver.waitForPendingSave(logger);
 
             ASSERT_TRUE(env.fileExists(IO::Path("autosave/test.2.map")));
         }
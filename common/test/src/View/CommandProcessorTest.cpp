@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "View/CommandProcessor.h"
+#include "View/MapDocumentCommandFacade.h"
+#include "View/MapDocumentTest.h"
+#include "View/UndoableCommand.h"
+
+#include <memory>
+
+namespace TrenchBroom {
+    namespace View {
+        class CommandProcessorTest : public MapDocumentTest {};
+
+        class TestCommand : public UndoableCommand {
+        public:
+            static const CommandType Type;
+            using Ptr = std::shared_ptr<TestCommand>;
+
+            size_t memory;
+            size_t prepareCount;
+            size_t compactCount;
+        public:
+            explicit TestCommand(const size_t i_memory) :
+            UndoableCommand(Type, "Test"),
+            memory(i_memory),
+            prepareCount(0),
+            compactCount(0) {}
+        private:
+            bool doPerformDo(MapDocumentCommandFacade* document) override { return true; }
+            bool doPerformUndo(MapDocumentCommandFacade* document) override { return true; }
+            bool doIsRepeatable(MapDocumentCommandFacade* document) const override { return false; }
+            bool doCollateWith(UndoableCommand::Ptr command) override { return false; }
+            void doPrepareCompaction() override { ++prepareCount; }
+            void doCompact() override { ++compactCount; }
+            size_t doGetMemorySize() const override { return memory; }
+        };
+
+        const Command::CommandType TestCommand::Type = Command::freeType();
+
+        TEST_F(CommandProcessorTest, compactPreviousCommandOfSameType) {
+            CommandProcessor processor(static_cast<MapDocumentCommandFacade*>(document.get()));
+
+            auto first = std::make_shared<TestCommand>(0);
+            auto second = std::make_shared<TestCommand>(0);
+
+            ASSERT_TRUE(processor.submitAndStoreCommand(first));
+            ASSERT_EQ(0u, first->prepareCount);
+            ASSERT_EQ(0u, first->compactCount);
+
+            // the second command has the same type but is stored separately, so the first one is compacted
+            ASSERT_TRUE(processor.submitAndStoreCommand(second));
+            ASSERT_EQ(1u, first->prepareCount);
+            ASSERT_EQ(1u, first->compactCount);
+            ASSERT_EQ(0u, second->compactCount);
+
+            // undoing a command discards the information gathered for its compaction
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_EQ(1u, first->compactCount);
+            ASSERT_EQ(0u, second->compactCount);
+        }
+
+        TEST_F(CommandProcessorTest, enforceMemoryBudget) {
+            CommandProcessor processor(static_cast<MapDocumentCommandFacade*>(document.get()));
+            processor.setMemoryBudget(100);
+
+            ASSERT_TRUE(processor.submitAndStoreCommand(std::make_shared<TestCommand>(40)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(std::make_shared<TestCommand>(40)));
+
+            // exceeds the budget, so the oldest command is discarded
+            ASSERT_TRUE(processor.submitAndStoreCommand(std::make_shared<TestCommand>(40)));
+
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_FALSE(processor.hasLastCommand());
+            ASSERT_TRUE(processor.hasNextCommand());
+        }
+
+        TEST_F(CommandProcessorTest, enforceMemoryBudgetKeepsMostRecentCommand) {
+            CommandProcessor processor(static_cast<MapDocumentCommandFacade*>(document.get()));
+            processor.setMemoryBudget(100);
+
+            ASSERT_TRUE(processor.submitAndStoreCommand(std::make_shared<TestCommand>(40)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(std::make_shared<TestCommand>(200)));
+
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_FALSE(processor.hasLastCommand());
+        }
+
+        TEST_F(CommandProcessorTest, reduceMemoryBudget) {
+            CommandProcessor processor(static_cast<MapDocumentCommandFacade*>(document.get()));
+
+            ASSERT_TRUE(processor.submitAndStoreCommand(std::make_shared<TestCommand>(40)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(std::make_shared<TestCommand>(40)));
+            ASSERT_TRUE(processor.submitAndStoreCommand(std::make_shared<TestCommand>(40)));
+
+            processor.setMemoryBudget(50);
+
+            ASSERT_TRUE(processor.undoLastCommand());
+            ASSERT_FALSE(processor.hasLastCommand());
+        }
+    }
+}
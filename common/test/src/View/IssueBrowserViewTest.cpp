@@ -0,0 +1,153 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Model/CollectNodesVisitor.h"
+#include "Model/Entity.h"
+#include "Model/EntityAttributes.h"
+#include "Model/Issue.h"
+#include "Model/IssueGenerator.h"
+#include "Model/LinkTargetIssueGenerator.h"
+#include "Model/World.h"
+#include "View/IssueBrowserView.h"
+#include "View/MapDocumentTest.h"
+#include "View/MapDocument.h"
+
+#include <QCoreApplication>
+
+#include <algorithm>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        class IssueBrowserViewTest : public MapDocumentTest {
+        protected:
+            using IssueKey = std::tuple<Model::IssueType, const Model::Node*, String>;
+            using IssueKeyList = std::vector<IssueKey>;
+
+            void SetUp() override {
+                MapDocumentTest::SetUp();
+
+                // every other entity targets another one, but only half of these targets exist, and every fourth
+                // entity has a targetname that no entity targets
+                for (size_t i = 0; i < 256; ++i) {
+                    auto* entity = new Model::Entity();
+                    entity->addOrUpdateAttribute(Model::AttributeNames::Classname, "point_entity");
+                    if (i % 2 == 0) {
+                        entity->addOrUpdateAttribute(Model::AttributeNames::Target, "t" + std::to_string(i));
+                    } else if (i % 4 == 1) {
+                        entity->addOrUpdateAttribute(Model::AttributeNames::Targetname, "t" + std::to_string(i - 1));
+                    } else {
+                        entity->addOrUpdateAttribute(Model::AttributeNames::Targetname, "unused" + std::to_string(i));
+                    }
+                    document->addNode(entity, document->currentParent());
+                }
+            }
+
+            static IssueKeyList issueKeys(const Model::IssueList& issues) {
+                IssueKeyList result;
+                for (const Model::Issue* issue : issues) {
+                    result.emplace_back(issue->type(), issue->node(), issue->description());
+                }
+                std::sort(std::begin(result), std::end(result));
+                return result;
+            }
+
+            Model::NodeList allNodes() const {
+                Model::CollectNodesVisitor visitor;
+                document->world()->acceptAndRecurse(visitor);
+                return visitor.nodes();
+            }
+
+            /**
+             * Validates the issues of every node one after another, then invalidates them again so that the issue
+             * browser has to generate them itself.
+             */
+            IssueKeyList validateSerially() const {
+                const Model::IssueGeneratorList& issueGenerators = document->world()->registeredIssueGenerators();
+
+                Model::IssueList issues;
+                for (Model::Node* node : allNodes()) {
+                    const Model::IssueList& nodeIssues = node->issues(issueGenerators);
+                    issues.insert(std::end(issues), std::begin(nodeIssues), std::end(nodeIssues));
+                }
+                const IssueKeyList result = issueKeys(issues);
+
+                for (Model::Node* node : allNodes()) {
+                    node->invalidateIssues();
+                }
+                return result;
+            }
+
+            Model::IssueType linkTargetIssueType() const {
+                for (const Model::IssueGenerator* generator : document->world()->registeredIssueGenerators()) {
+                    if (dynamic_cast<const Model::LinkTargetIssueGenerator*>(generator) != nullptr) {
+                        return generator->type();
+                    }
+                }
+                return 0;
+            }
+
+            static void finishValidation(IssueBrowserView& view) {
+                for (size_t i = 0; i < 1000 && view.validating(); ++i) {
+                    QCoreApplication::processEvents();
+                }
+                ASSERT_FALSE(view.validating());
+            }
+        };
+
+        TEST_F(IssueBrowserViewTest, validateInChunksMatchesSerialValidation) {
+            const IssueKeyList expected = validateSerially();
+
+            // the link target issues are generated on the main thread
+            const Model::IssueType linkTargetIssueType = this->linkTargetIssueType();
+            ASSERT_EQ(64, std::count_if(std::begin(expected), std::end(expected), [&](const IssueKey& key) {
+                return std::get<0>(key) == linkTargetIssueType;
+            }));
+
+            IssueBrowserView view(document);
+            view.setValidationChunkSize(16);
+            view.validate();
+
+            // the first chunk is validated right away, and the remaining chunks are validated by queued calls
+            ASSERT_TRUE(view.validating());
+            ASSERT_LT(view.issues().size(), expected.size());
+
+            finishValidation(view);
+            ASSERT_EQ(expected, issueKeys(view.issues()));
+        }
+
+        TEST_F(IssueBrowserViewTest, restartValidationWhenInvalidated) {
+            const IssueKeyList expected = validateSerially();
+
+            IssueBrowserView view(document);
+            view.setValidationChunkSize(16);
+            view.validate();
+            ASSERT_TRUE(view.validating());
+
+            // drops the remaining chunks and validates all nodes again
+            view.reload();
+            finishValidation(view);
+            ASSERT_EQ(expected, issueKeys(view.issues()));
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "TrenchBroom.h"
+#include "Renderer/PerspectiveCamera.h"
+#include "View/Lasso.h"
+
+#include <vecmath/vec.h>
+
+#include <iterator>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace View {
+        TEST(LassoTest, selectsHandlesInVolume) {
+            // the camera is at the origin and looks along the positive X axis
+            Renderer::PerspectiveCamera camera;
+
+            Lasso lasso(camera, 64.0, vm::vec3(64.0, -10.0, -10.0));
+            lasso.update(vm::vec3(64.0, 10.0, 10.0));
+
+            ASSERT_TRUE(lasso.selects(vm::vec3(128.0, 0.0, 0.0)));
+            ASSERT_TRUE(lasso.selects(vm::vec3(128.0, 15.0, -15.0)));
+            ASSERT_TRUE(lasso.selects(vm::vec3(32.0, 2.0, 2.0)));
+            ASSERT_FALSE(lasso.selects(vm::vec3(128.0, 30.0, 0.0)));
+            ASSERT_FALSE(lasso.selects(vm::vec3(128.0, 0.0, -30.0)));
+            ASSERT_FALSE(lasso.selects(vm::vec3(-128.0, 0.0, 0.0)));
+
+            const std::vector<vm::vec3> handles {
+                vm::vec3(128.0, 0.0, 0.0),
+                vm::vec3(128.0, 30.0, 0.0),
+                vm::vec3(256.0, 20.0, 20.0),
+                vm::vec3(-128.0, 0.0, 0.0)
+            };
+
+            std::vector<vm::vec3> selected;
+            lasso.selected(std::begin(handles), std::end(handles), std::back_inserter(selected));
+            ASSERT_EQ((std::vector<vm::vec3>{ handles[0], handles[2] }), selected);
+        }
+
+        TEST(LassoTest, emptyLassoSelectsNothing) {
+            Renderer::PerspectiveCamera camera;
+
+            Lasso lasso(camera, 64.0, vm::vec3(64.0, 0.0, 0.0));
+            ASSERT_FALSE(lasso.selects(vm::vec3(128.0, 0.0, 0.0)));
+
+            // the selected volume follows the updates of the lasso
+            lasso.update(vm::vec3(64.0, 10.0, 10.0));
+            ASSERT_TRUE(lasso.selects(vm::vec3(128.0, 5.0, 5.0)));
+            ASSERT_FALSE(lasso.selects(vm::vec3(128.0, -5.0, -5.0)));
+        }
+    }
+}
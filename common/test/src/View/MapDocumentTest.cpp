@@ -19,6 +19,8 @@
 
 #include "MapDocumentTest.h"
 
+#include "CollectionUtils.h"
+#include "Exceptions.h"
 #include "TestUtils.h"
 #include "Assets/EntityDefinition.h"
 #include "Assets/ModelDefinition.h"
@@ -40,8 +42,11 @@
 
 #include <vecmath/bbox.h>
 #include <vecmath/scalar.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 
+#include <vector>
+
 namespace TrenchBroom {
     namespace View {
         MapDocumentTest::MapDocumentTest() :
@@ -885,6 +890,151 @@ namespace TrenchBroom {
             ASSERT_DOUBLE_EQ(32.0, hits.front().distance());
         }
 
+        TEST_F(MapDocumentTest, pickDuringTransaction) {
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+            const auto box = vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64));
+
+            Model::PickResult pickResult;
+            {
+                Transaction transaction(document);
+
+                auto* brush1 = builder.createCuboid(box, "texture");
+                document->addNode(brush1, document->currentParent());
+
+                // this brush is added and removed again before the node tree is updated
+                auto* brush2 = builder.createCuboid(box.translate(vm::vec3(0, 0, 256)), "texture");
+                document->addNode(brush2, document->currentParent());
+                document->removeNode(brush2);
+
+                document->select(brush1);
+                document->translateObjects(vm::vec3(0, 0, 128));
+
+                // picking inside a transaction must see the pending changes
+                document->pick(vm::ray3(vm::vec3(-32, 32, 32), vm::vec3::pos_x()), pickResult);
+                ASSERT_TRUE(pickResult.query().all().empty());
+
+                pickResult.clear();
+                document->pick(vm::ray3(vm::vec3(-32, 32, 160), vm::vec3::pos_x()), pickResult);
+                ASSERT_EQ(1u, pickResult.query().all().size());
+                ASSERT_EQ(brush1->findFace(vm::vec3::neg_x()), pickResult.query().all().front().target<Model::BrushFace*>());
+
+                document->translateObjects(vm::vec3(0, 0, 128));
+            }
+
+            pickResult.clear();
+            document->pick(vm::ray3(vm::vec3(-32, 32, 160), vm::vec3::pos_x()), pickResult);
+            ASSERT_TRUE(pickResult.query().all().empty());
+
+            pickResult.clear();
+            document->pick(vm::ray3(vm::vec3(-32, 32, 288), vm::vec3::pos_x()), pickResult);
+            ASSERT_EQ(1u, pickResult.query().all().size());
+            ASSERT_DOUBLE_EQ(32.0, pickResult.query().all().front().distance());
+        }
+
+        TEST_F(MapDocumentTest, pickRaysMatchesPick) {
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+            for (size_t i = 0; i < 64; ++i) {
+                const auto x = static_cast<FloatType>(i % 4) * 96.0;
+                const auto y = static_cast<FloatType>((i / 4) % 4) * 96.0;
+                const auto z = static_cast<FloatType>(i / 16) * 96.0;
+                auto* brush = builder.createCuboid(vm::bbox3(vm::vec3(x, y, z), vm::vec3(x + 64.0, y + 64.0, z + 64.0)), "texture");
+                document->addNode(brush, document->currentParent());
+            }
+
+            std::vector<vm::ray3> rays;
+            for (size_t i = 0; i < 32; ++i) {
+                const auto offset = static_cast<FloatType>(i) * 12.0 + 6.0;
+                rays.push_back(vm::ray3(vm::vec3(-32.0, offset, offset), vm::vec3::pos_x()));
+                rays.push_back(vm::ray3(vm::vec3(offset, -32.0, 400.0), vm::normalize(vm::vec3(0.0, 1.0, -1.0))));
+            }
+            rays.push_back(vm::ray3(vm::vec3(-32.0, 32.0, 32.0), vm::vec3::neg_x()));
+
+            std::vector<Model::PickResult> pickResults(rays.size());
+            document->pick(rays, pickResults);
+
+            // every ray must yield the same hits as when it is picked on its own
+            for (size_t i = 0; i < rays.size(); ++i) {
+                Model::PickResult expected;
+                document->pick(rays[i], expected);
+
+                const auto expectedHits = expected.query().all();
+                const auto actualHits = pickResults[i].query().all();
+                ASSERT_EQ(expectedHits.size(), actualHits.size());
+                auto actualIt = std::begin(actualHits);
+                for (const auto& expectedHit : expectedHits) {
+                    const auto& actualHit = *actualIt++;
+                    ASSERT_EQ(expectedHit.target<Model::BrushFace*>(), actualHit.target<Model::BrushFace*>());
+                    ASSERT_DOUBLE_EQ(expectedHit.distance(), actualHit.distance());
+                }
+            }
+
+            ASSERT_EQ(4u, pickResults[0].query().all().size());
+            ASSERT_TRUE(pickResults.back().query().all().empty());
+        }
+
+        TEST_F(MapDocumentTest, findNodesIntersectingPlanes) {
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+            auto* brush1 = builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)), "texture");
+            auto* brush2 = builder.createCuboid(vm::bbox3(vm::vec3(128, 0, 0), vm::vec3(192, 64, 64)), "texture");
+            document->addNode(brush1, document->currentParent());
+            document->addNode(brush2, document->currentParent());
+
+            // the volume bounded by these planes contains the box from (-16, -16, -16) to (80, 80, 80)
+            const std::vector<vm::plane3> planes({
+                vm::plane3(vm::vec3(80, 0, 0), vm::vec3::pos_x()),
+                vm::plane3(vm::vec3(-16, 0, 0), vm::vec3::neg_x()),
+                vm::plane3(vm::vec3(0, 80, 0), vm::vec3::pos_y()),
+                vm::plane3(vm::vec3(0, -16, 0), vm::vec3::neg_y()),
+                vm::plane3(vm::vec3(0, 0, 80), vm::vec3::pos_z()),
+                vm::plane3(vm::vec3(0, 0, -16), vm::vec3::neg_z())
+            });
+
+            ASSERT_EQ(Model::NodeList({ brush1 }), document->findNodesIntersecting(planes));
+        }
+
+        TEST_F(MapDocumentTest, findNodesIntersectingDuringTransaction) {
+            // delete default brush
+            document->selectAllNodes();
+            document->deleteObjects();
+
+            const Model::BrushBuilder builder(document->world(), document->worldBounds());
+            auto* brush1 = builder.createCuboid(vm::bbox3(vm::vec3(0, 0, 0), vm::vec3(64, 64, 64)), "texture");
+            document->addNode(brush1, document->currentParent());
+
+            const auto oldBounds = vm::bbox3(vm::vec3(16, 16, 16), vm::vec3(48, 48, 48));
+            const auto newBounds = oldBounds.translate(vm::vec3(0, 0, 128));
+
+            Transaction transaction(document);
+            document->select(brush1);
+            document->translateObjects(vm::vec3(0, 0, 128));
+
+            // the queries see the pending changes without updating the node tree
+            Model::NodeList nodes;
+            document->world()->findNodesIntersecting(oldBounds, nodes);
+            ASSERT_TRUE(nodes.empty());
+
+            document->world()->findNodesIntersecting(newBounds, nodes);
+            ASSERT_EQ(Model::NodeList({ brush1 }), nodes);
+
+            const std::vector<vm::plane3> planes({
+                vm::plane3(newBounds.max, vm::vec3::pos_z()),
+                vm::plane3(newBounds.min, vm::vec3::neg_z())
+            });
+            ASSERT_EQ(Model::NodeList({ brush1 }), document->findNodesIntersecting(planes));
+        }
+
         TEST_F(MapDocumentTest, throwExceptionDuringCommand) {
             ASSERT_THROW(document->throwExceptionDuringCommand(), GeometryException);
         }
@@ -32,6 +32,11 @@
 #include "View/MapDocument.h"
 
 #include <cassert>
+#include <vector>
+
+#include <vecmath/bbox.h>
+#include <vecmath/polygon.h>
+#include <vecmath/vec.h>
 
 namespace TrenchBroom {
     namespace View {
@@ -59,5 +64,35 @@ namespace TrenchBroom {
             for (Model::BrushFace* face : brush->faces())
                 ASSERT_EQ(texture, face->texture());
         }
+
+        TEST_F(SnapshotTest, undoCompactedSnapshot) {
+            Model::Brush* brush = createBrush("texture");
+            document->addNode(brush, document->currentParent());
+            document->select(brush);
+
+            std::vector<std::vector<vm::vec3>> originalPoints;
+            for (const Model::BrushFace* face : brush->faces()) {
+                originalPoints.push_back({ face->points()[0], face->points()[1], face->points()[2] });
+            }
+            const auto originalBounds = brush->logicalBounds();
+
+            // only moves one face, so the resize command's snapshot can be compacted to a single face
+            const Model::BrushFace* topFace = brush->findFace(vm::vec3::pos_z());
+            ASSERT_NE(nullptr, topFace);
+            ASSERT_TRUE(document->resizeBrushes({ topFace->polygon() }, vm::vec3(0, 0, 16)));
+
+            // performing a command of a different type compacts the resize command
+            ASSERT_TRUE(document->translateObjects(vm::vec3(8, 0, 0)));
+
+            document->undoLastCommand();
+            document->undoLastCommand();
+
+            ASSERT_EQ(originalBounds, brush->logicalBounds());
+            ASSERT_EQ(originalPoints.size(), brush->faces().size());
+            for (size_t i = 0; i < originalPoints.size(); ++i) {
+                const auto& points = brush->faces()[i]->points();
+                ASSERT_EQ(originalPoints[i], (std::vector<vm::vec3>{ points[0], points[1], points[2] }));
+            }
+        }
     }
 }